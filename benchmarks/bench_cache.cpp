@@ -0,0 +1,95 @@
+#include <taskflow/scheduler.hpp>
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+// A 50k-node build-like DAG: 10k sources, each preprocessed, compiled,
+// dependency-scanned, tested and linted; objects go into 100 archives that
+// are linked at the end. BM_FullBuild runs it against an empty cache.
+// BM_Incremental changes one source between runs, so only that source's
+// cone (seven nodes) runs again.
+
+namespace {
+
+constexpr size_t kSources = 10'000;
+constexpr size_t kGroup = 100;
+
+// A little work per node so that skipping it is visible.
+std::string work(std::string s) {
+    uint64_t h = 1469598103934665603ull;
+    for (int r = 0; r < 20; ++r)
+        for (char c : s) h = (h ^ static_cast<uint8_t>(c)) * 1099511628211ull;
+    return std::to_string(h);
+}
+
+tf::TaskGraph build(const std::vector<uint64_t>& versions) {
+    tf::TaskGraph g;
+    auto concat = [](tf::CacheInputs in) {
+        std::string s;
+        for (auto& b : in) s += b.bytes();
+        return work(std::move(s));
+    };
+    std::vector<tf::TaskGraph::NodeId> archives;
+    for (size_t a = 0; a < kSources / kGroup; ++a)
+        archives.push_back(g.add_cached("ar" + std::to_string(a), {}, concat));
+    auto link = g.add_cached("link", {}, concat);
+    for (auto a : archives) g.precede(a, link);
+    for (size_t i = 0; i < kSources; ++i) {
+        const auto n = std::to_string(i);
+        auto key = tf::content_hash(n + ":" + std::to_string(versions[i]));
+        auto pre = g.add_cached("pre" + n, key, [n](tf::CacheInputs) { return work(n); });
+        auto obj = g.add_cached("obj" + n, {}, concat);
+        auto dep = g.add_cached("dep" + n, {}, concat);
+        g.precede(pre, obj);
+        g.precede(pre, dep);
+        g.precede(obj, archives[i / kGroup]);
+        g.precede(dep, archives[i / kGroup]);
+        auto test = g.add_cached("test" + n, {}, concat);
+        g.precede(obj, test);
+        g.add_cached("lint" + n, key, [n](tf::CacheInputs) { return work(n); });
+    }
+    return g;   // 5 * kSources + kSources / kGroup + 1 = 50,101 nodes
+}
+
+void run(tf::Scheduler& s, tf::TaskGraph&& g, tf::ResultCache& cache, benchmark::State& st) {
+    auto r = s.submit(std::move(g), cache);
+    for (auto h : r.handles) s.wait_for(h);
+    st.counters["executed"] = static_cast<double>(r.executed());
+}
+
+}  // namespace
+
+static void BM_FullBuild(benchmark::State& st) {
+    tf::Scheduler s(4);
+    s.start();
+    std::vector<uint64_t> versions(kSources);
+    for (auto _ : st) {
+        st.PauseTiming();
+        tf::ResultCache cache;
+        auto g = build(versions);
+        st.ResumeTiming();
+        run(s, std::move(g), cache, st);
+    }
+    s.stop();
+}
+BENCHMARK(BM_FullBuild)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_Incremental(benchmark::State& st) {
+    tf::Scheduler s(4);
+    s.start();
+    std::vector<uint64_t> versions(kSources);
+    tf::ResultCache cache;
+    run(s, build(versions), cache, st);
+    size_t edit = 0;
+    for (auto _ : st) {
+        st.PauseTiming();
+        ++versions[edit++ * 7919 % kSources];   // touch one source
+        auto g = build(versions);
+        st.ResumeTiming();
+        run(s, std::move(g), cache, st);
+    }
+    s.stop();
+}
+BENCHMARK(BM_Incremental)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,71 @@
+#include <taskflow/cron_parser.hpp>
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// A mix of everyday expressions, some firing often and some rarely.
+std::vector<tf::CronSchedule> make_schedules(size_t n) {
+    const char* kExprs[] = {"*/5 * * * *", "0 * * * *", "30 9 * * MON-FRI", "0 0 1 * *",
+                            "15 2,14 * * *", "0 0 * * SUN", "0 6 1,15 * *", "0 0 1 JAN *",
+                            "45 23 * * 5", "0 12 13 * FRI"};
+    std::vector<tf::CronSchedule> v;
+    std::mt19937 rng(42);
+    for (size_t i = 0; i < n; ++i) v.push_back(tf::parse_cron(kExprs[rng() % std::size(kExprs)]));
+    return v;
+}
+
+// The old approach: step minute by minute until the expression matches.
+std::chrono::system_clock::time_point naive_next(const tf::CronSchedule& s,
+                                                 std::chrono::system_clock::time_point from) {
+    std::time_t t = std::chrono::system_clock::to_time_t(from);
+    t = t - t % 60 + 60;
+    for (int i = 0; i < 366 * 24 * 60; ++i, t += 60) {
+        std::tm tm;
+        localtime_r(&t, &tm);
+        if (tf::cron_matches(s, tm)) return std::chrono::system_clock::from_time_t(t);
+    }
+    return std::chrono::system_clock::time_point::max();
+}
+
+}  // namespace
+
+static void BM_CronParse(benchmark::State& st) {
+    for (auto _ : st) benchmark::DoNotOptimize(tf::parse_cron("0,30 9-17/2 * JAN-MAR MON-FRI"));
+}
+BENCHMARK(BM_CronParse);
+
+static void BM_CronNextBulk(benchmark::State& st) {
+    auto v = make_schedules(static_cast<size_t>(st.range(0)));
+    std::vector<std::chrono::system_clock::time_point> out;
+    auto from = std::chrono::system_clock::now();
+    for (auto _ : st) {
+        tf::next_cron_times(v, from, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK(BM_CronNextBulk)->Arg(50000);
+
+static void BM_CronNextEach(benchmark::State& st) {
+    auto v = make_schedules(static_cast<size_t>(st.range(0)));
+    auto from = std::chrono::system_clock::now();
+    for (auto _ : st)
+        for (auto& s : v) benchmark::DoNotOptimize(tf::next_cron_time(s, from));
+    st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK(BM_CronNextEach)->Arg(50000);
+
+// Far fewer schedules: minute stepping costs up to a year of localtime calls each.
+static void BM_CronNextNaive(benchmark::State& st) {
+    auto v = make_schedules(static_cast<size_t>(st.range(0)));
+    auto from = std::chrono::system_clock::now();
+    for (auto _ : st)
+        for (auto& s : v) benchmark::DoNotOptimize(naive_next(s, from));
+    st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK(BM_CronNextNaive)->Arg(50)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -1,5 +1,11 @@
 #include <taskflow/scheduler.hpp>
 #include <benchmark/benchmark.h>
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -14,4 +20,148 @@ static void BM_Chain(benchmark::State& st) {
     }
     s.stop();
 }
-BENCHMARK(BM_Chain);
\ No newline at end of file
+BENCHMARK(BM_Chain);
+
+// Same 100-node chain, compiled once and re-run each iteration.
+static void BM_ChainCompiled(benchmark::State& st) {
+    tf::Scheduler s; s.start();
+    tf::TaskGraph g;
+    tf::TaskGraph::NodeId prev = g.add([]{});
+    for (int i = 1; i < 100; ++i) {
+        auto id = g.add([]{});
+        g.precede(prev, id);
+        prev = id;
+    }
+    tf::CompiledGraph cg(std::move(g));
+    for (auto _ : st) s.run(cg);
+    s.stop();
+}
+BENCHMARK(BM_ChainCompiled);
+// 100k-node layered graph: one schedule_once per node vs one batched submit.
+// Only insertion is timed; nothing runs because the start time never arrives.
+static constexpr int kGraphWidth = 1000;
+
+static void BM_InsertPerNode(benchmark::State& st) {
+    const int layers = static_cast<int>(st.range(0)) / kGraphWidth;
+    std::optional<tf::Scheduler> s;
+    for (auto _ : st) {
+        st.PauseTiming();
+        s.emplace();
+        st.ResumeTiming();
+        std::vector<tf::TaskHandle> prev, cur;
+        for (int l = 0; l < layers; ++l) {
+            cur.clear();
+            for (int w = 0; w < kGraphWidth; ++w) {
+                std::vector<tf::TaskHandle> deps;
+                if (!prev.empty()) deps = {prev[w], prev[(w + 1) % kGraphWidth]};
+                cur.push_back(s->schedule_once(tf::TimePoint::max(), []{}, deps));
+            }
+            prev.swap(cur);
+        }
+        st.PauseTiming();
+        s.reset();
+        st.ResumeTiming();
+    }
+    st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK(BM_InsertPerNode)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_InsertGraph(benchmark::State& st) {
+    const int layers = static_cast<int>(st.range(0)) / kGraphWidth;
+    std::optional<tf::Scheduler> s;
+    for (auto _ : st) {
+        st.PauseTiming();
+        s.emplace();
+        tf::TaskGraph g;
+        for (int l = 0; l < layers; ++l)
+            for (int w = 0; w < kGraphWidth; ++w) {
+                auto id = g.add([]{});
+                if (l > 0) {
+                    size_t base = static_cast<size_t>(l - 1) * kGraphWidth;
+                    g.precede(base + w, id);
+                    g.precede(base + (w + 1) % kGraphWidth, id);
+                }
+            }
+        st.ResumeTiming();
+        s->submit(std::move(g), tf::TimePoint::max());
+        st.PauseTiming();
+        s.reset();
+        st.ResumeTiming();
+    }
+    st.SetItemsProcessed(st.iterations() * st.range(0));
+}
+BENCHMARK(BM_InsertGraph)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+// Makespan of random DAGs with skewed task costs on 4 workers: FIFO dispatch
+// (arg 0) against critical-path ordering (arg 1). Tasks sleep, like build or
+// ETL steps waiting on I/O, so the result does not depend on the core count.
+// Costs are learned from a first run of each graph, left out of the timing.
+// The counters are the two lower bounds, critical path and total work /
+// workers, in ms.
+namespace {
+struct RandomDag {
+    std::vector<std::vector<size_t>> preds;
+    std::vector<int64_t> cost_us;
+};
+
+RandomDag random_dag(size_t n, uint32_t seed) {
+    std::mt19937 rng(seed);
+    RandomDag d;
+    d.preds.resize(n);
+    d.cost_us.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        // Mostly cheap tasks, a few expensive ones.
+        d.cost_us[i] = rng() % 8 == 0 ? 2000 + rng() % 4000 : 200 + rng() % 400;
+        // A quarter are roots; the rest follow one or two of the four before.
+        if (i == 0 || rng() % 4 == 0) continue;
+        size_t k = 1 + rng() % 2;
+        for (size_t j = 0; j < k; ++j) d.preds[i].push_back(i - 1 - rng() % std::min<size_t>(i, 4));
+    }
+    return d;
+}
+
+std::vector<tf::TaskHandle> submit_dag(tf::Scheduler& s, const RandomDag& d) {
+    tf::TaskGraph g;
+    for (size_t i = 0; i < d.cost_us.size(); ++i)
+        g.add("n" + std::to_string(i), [us = d.cost_us[i]] { std::this_thread::sleep_for(std::chrono::microseconds(us)); });
+    for (size_t i = 0; i < d.preds.size(); ++i)
+        for (size_t p : d.preds[i]) g.precede(p, i);
+    return s.submit(std::move(g));
+}
+}  // namespace
+
+static void BM_RandomDagMakespan(benchmark::State& st) {
+    const size_t workers = 4;
+    std::vector<RandomDag> dags;
+    for (uint32_t seed = 1; seed <= 8; ++seed) dags.push_back(random_dag(150, seed));
+    tf::Scheduler s(workers);
+    s.set_critical_path(st.range(0) != 0);
+    s.start();
+    for (auto& d : dags)
+        for (auto h : submit_dag(s, d)) s.wait_for(h);
+    size_t k = 0;
+    for (auto _ : st) {
+        for (auto h : submit_dag(s, dags[k++ % dags.size()])) s.wait_for(h);
+    }
+    s.stop();
+
+    double cp = 0, work = 0;
+    for (auto& d : dags) {
+        std::vector<int64_t> finish(d.cost_us.size());
+        int64_t longest = 0, sum = 0;
+        for (size_t i = 0; i < finish.size(); ++i) {
+            int64_t start = 0;
+            for (size_t p : d.preds[i]) start = std::max(start, finish[p]);
+            finish[i] = start + d.cost_us[i];
+            longest = std::max(longest, finish[i]);
+            sum += d.cost_us[i];
+        }
+        cp += static_cast<double>(longest);
+        work += static_cast<double>(sum) / workers;
+    }
+    st.counters["critical_path_ms"] = cp / dags.size() / 1e3;
+    st.counters["work_per_worker_ms"] = work / dags.size() / 1e3;
+}
+BENCHMARK(BM_RandomDagMakespan)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
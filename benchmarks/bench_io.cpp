@@ -0,0 +1,118 @@
+#include <taskflow/scheduler.hpp>
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <fcntl.h>
+#include <memory>
+#include <span>
+#include <unistd.h>
+#include <vector>
+
+// Copy a file through a byte-wise transform in 256 KiB chunks: blocking
+// pread/pwrite inside compute tasks, against IoExecutor requests with the
+// transform as a task between them. Arg 0 goes through the page cache,
+// arg 1 opens both files with O_DIRECT so every chunk reaches the device,
+// arg 2 syncs each chunk to disk after writing it.
+
+namespace {
+
+constexpr size_t kFileBytes = 32 << 20;
+constexpr size_t kChunk = 256 << 10;
+constexpr size_t kChunks = kFileBytes / kChunk;
+constexpr size_t kLoops = 16;
+const char* const kSrc = "/tmp/taskflow_bench_io.src";
+const char* const kDst = "/tmp/taskflow_bench_io.dst";
+
+struct Buffers {
+    Buffers() : base(static_cast<std::byte*>(std::aligned_alloc(4096, kFileBytes))) {}
+    std::span<std::byte> chunk(size_t i) { return {base.get() + i * kChunk, kChunk}; }
+    struct Free { void operator()(std::byte* p) const { std::free(p); } };
+    std::unique_ptr<std::byte, Free> base;
+};
+
+struct Files {
+    explicit Files(bool direct) {
+        static bool written = [] {
+            Buffers b;
+            for (size_t i = 0; i < kFileBytes; ++i) b.base.get()[i] = static_cast<std::byte>(i * 7);
+            int fd = ::open(kSrc, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            bool ok = ::pwrite(fd, b.base.get(), kFileBytes, 0) == static_cast<ssize_t>(kFileBytes);
+            ::fsync(fd);
+            ::close(fd);
+            return ok;
+        }();
+        (void)written;
+        int flags = direct ? O_DIRECT : 0;
+        src = ::open(kSrc, O_RDONLY | flags);
+        dst = ::open(kDst, O_WRONLY | O_CREAT | flags, 0644);
+    }
+    ~Files() {
+        ::close(src);
+        ::close(dst);
+    }
+    int src, dst;
+};
+
+void transform(std::span<std::byte> b) {
+    for (auto& x : b) x ^= std::byte{0x5a};
+}
+
+}  // namespace
+
+static void BM_CopyBlocking(benchmark::State& st) {
+    Files files(st.range(0) == 1);
+    const bool sync = st.range(0) == 2;
+    Buffers buf;
+    tf::Scheduler s(4);
+    s.start();
+    for (auto _ : st) {
+        std::vector<tf::TaskHandle> done;
+        for (size_t i = 0; i < kChunks; ++i)
+            done.push_back(s.schedule_once(tf::Clock::now(), [&, i] {
+                auto b = buf.chunk(i);
+                if (::pread(files.src, b.data(), b.size(), i * kChunk) < 0) std::abort();
+                transform(b);
+                if (::pwrite(files.dst, b.data(), b.size(), i * kChunk) < 0) std::abort();
+                if (sync) ::fsync(files.dst);
+            }));
+        for (auto h : done) s.wait_for(h);
+    }
+    s.stop();
+    st.SetBytesProcessed(static_cast<int64_t>(st.iterations() * kFileBytes));
+}
+BENCHMARK(BM_CopyBlocking)->DenseRange(0, 2)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void copy_async(benchmark::State& st, tf::IoBackend backend) {
+    Files files(st.range(0) == 1);
+    const bool sync = st.range(0) == 2;
+    Buffers buf;
+    tf::Scheduler s(4);
+    s.start();
+    tf::IoExecutor io(s, backend, 64);
+    if (io.backend() != backend) st.SkipWithError("io_uring unavailable");
+    // A few copy loops, each taking every kLoops-th chunk through read,
+    // transform and write before starting its next one.
+    auto loop = [&](size_t first) -> tf::Co<void> {
+        for (size_t i = first; i < kChunks; i += kLoops) {
+            auto b = buf.chunk(i);
+            co_await io.async_read(files.src, b, i * kChunk);
+            transform(b);
+            co_await io.async_write(files.dst, b, i * kChunk);
+            if (sync) co_await io.async_fsync(files.dst);
+        }
+    };
+    for (auto _ : st) {
+        std::vector<tf::TaskHandle> done;
+        for (size_t k = 0; k < kLoops; ++k) done.push_back(s.spawn(loop(k)));
+        for (auto h : done) s.wait_for(h);
+    }
+    s.stop();
+    st.SetBytesProcessed(static_cast<int64_t>(st.iterations() * kFileBytes));
+}
+
+static void BM_CopyIoUring(benchmark::State& st) { copy_async(st, tf::IoBackend::io_uring); }
+BENCHMARK(BM_CopyIoUring)->DenseRange(0, 2)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_CopyIoThreads(benchmark::State& st) { copy_async(st, tf::IoBackend::threads); }
+BENCHMARK(BM_CopyIoThreads)->DenseRange(0, 2)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
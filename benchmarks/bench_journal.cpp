@@ -0,0 +1,70 @@
+#include <taskflow/scheduler.hpp>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+// Warm restart: BM_Reregister is what a service without a journal does,
+// registering its cron jobs again one schedule_recurring call at a time.
+// BM_Recover opens a journal of N jobs (cron, interval and one-shot in
+// equal parts) and recovers them all into a fresh scheduler.
+
+namespace {
+
+const char* const kCrons[] = {"*/5 * * * *", "0 * * * *", "30 2 * * 1-5", "0 0 1 * *", "15,45 8-18 * * *"};
+const char* const kFile = "/tmp/taskflow_bench.journal";
+
+void write_journal(size_t n) {
+    static size_t written = 0;
+    if (written == n) return;
+    std::filesystem::remove(kFile);
+    tf::Scheduler s(1);
+    tf::ScheduleJournal j(s, kFile);
+    j.bind("job", [] {});
+    const auto later = std::chrono::system_clock::now() + std::chrono::hours(24);
+    for (size_t i = 0; i < n; ++i) {
+        switch (i % 3) {
+        case 0: j.schedule_recurring("job", kCrons[i / 3 % 5]); break;
+        case 1: j.schedule_every("job", std::chrono::minutes(1 + i % 60)); break;
+        default: j.schedule_once("job", later + std::chrono::seconds(i)); break;
+        }
+    }
+    written = n;
+}
+
+}  // namespace
+
+static void BM_Reregister(benchmark::State& st) {
+    const auto n = static_cast<size_t>(st.range(0));
+    for (auto _ : st) {
+        auto s = std::make_unique<tf::Scheduler>(1);
+        for (size_t i = 0; i < n; ++i) s->schedule_recurring(kCrons[i % 5], [] {});
+        st.PauseTiming();
+        s.reset();
+        st.ResumeTiming();
+    }
+    st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+}
+BENCHMARK(BM_Reregister)->Arg(100'000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_Recover(benchmark::State& st) {
+    const auto n = static_cast<size_t>(st.range(0));
+    write_journal(n);
+    for (auto _ : st) {
+        auto s = std::make_unique<tf::Scheduler>(1);
+        {
+            tf::ScheduleJournal j(*s, kFile);
+            j.bind("job", [] {});
+            auto stats = j.recover();
+            if (stats.scheduled != n) st.SkipWithError("lost jobs");
+            st.PauseTiming();
+        }
+        s.reset();
+        st.ResumeTiming();
+    }
+    st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+}
+BENCHMARK(BM_Recover)->Arg(100'000)->Arg(1'000'000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,90 @@
+#include <taskflow/scheduler.hpp>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+// "Process N records": a light per-record transform, then a sum.
+
+namespace {
+
+constexpr size_t kRecords = 10'000'000;
+
+std::vector<double>& records() {
+    static std::vector<double> v = [] {
+        std::vector<double> r(kRecords);
+        std::iota(r.begin(), r.end(), 0.0);
+        return r;
+    }();
+    return v;
+}
+
+void transform(double& x) { x = std::sqrt(x * x + 1.0); }
+
+}  // namespace
+
+static void BM_SerialFor(benchmark::State& st) {
+    auto& v = records();
+    for (auto _ : st) {
+        for (auto& x : v) transform(x);
+        benchmark::ClobberMemory();
+    }
+    st.SetItemsProcessed(st.iterations() * static_cast<int64_t>(v.size()));
+}
+BENCHMARK(BM_SerialFor)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// The old way: one schedule_once per fixed chunk, then wait for all of them.
+static void BM_HandSplitFor(benchmark::State& st) {
+    const size_t chunks = static_cast<size_t>(st.range(0));
+    auto& v = records();
+    tf::Scheduler s;
+    s.start();
+    for (auto _ : st) {
+        std::vector<tf::TaskHandle> hs;
+        size_t per = (v.size() + chunks - 1) / chunks;
+        for (size_t lo = 0; lo < v.size(); lo += per) {
+            size_t hi = std::min(v.size(), lo + per);
+            hs.push_back(s.schedule_once(tf::Clock::now(), [&v, lo, hi] {
+                for (size_t i = lo; i < hi; ++i) transform(v[i]);
+            }));
+        }
+        for (auto h : hs) s.wait_for(h);
+    }
+    st.SetItemsProcessed(st.iterations() * static_cast<int64_t>(v.size()));
+    s.stop();
+}
+BENCHMARK(BM_HandSplitFor)->Arg(16)->Arg(1024)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_ParallelFor(benchmark::State& st) {
+    auto& v = records();
+    tf::Scheduler s;
+    s.start();
+    for (auto _ : st) {
+        s.wait_for(s.parallel_for(v.begin(), v.end(), [](double& x) { transform(x); }));
+    }
+    st.SetItemsProcessed(st.iterations() * static_cast<int64_t>(v.size()));
+    s.stop();
+}
+BENCHMARK(BM_ParallelFor)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_SerialReduce(benchmark::State& st) {
+    auto& v = records();
+    for (auto _ : st) benchmark::DoNotOptimize(std::accumulate(v.begin(), v.end(), 0.0));
+    st.SetItemsProcessed(st.iterations() * static_cast<int64_t>(v.size()));
+}
+BENCHMARK(BM_SerialReduce)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_ParallelReduce(benchmark::State& st) {
+    auto& v = records();
+    tf::Scheduler s;
+    s.start();
+    for (auto _ : st) {
+        benchmark::DoNotOptimize(s.parallel_reduce(v.begin(), v.end(), 0.0, std::plus<>{}).get());
+    }
+    st.SetItemsProcessed(st.iterations() * static_cast<int64_t>(v.size()));
+    s.stop();
+}
+BENCHMARK(BM_ParallelReduce)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,186 @@
+#include <taskflow/thread_pool.hpp>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <ctime>
+#include <condition_variable>
+#include <memory>
+#include <numeric>
+#include <queue>
+
+// The single-queue pool tf::ThreadPool used before work stealing, kept here
+// as the baseline for comparison.
+class LegacyPool {
+public:
+    explicit LegacyPool(size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            workers_.emplace_back([this] {
+                while (true) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lk(mtx_);
+                        cv_.wait(lk, [this]{ return stop_ || !tasks_.empty(); });
+                        if (stop_ && tasks_.empty()) return;
+                        task = std::move(tasks_.front());
+                        tasks_.pop();
+                    }
+                    task();
+                }
+            });
+        }
+    }
+    ~LegacyPool() {
+        { std::lock_guard<std::mutex> lk(mtx_); stop_ = true; }
+        cv_.notify_all();
+        for (auto& w : workers_) w.join();
+    }
+    void enqueue(std::function<void()> task) {
+        { std::lock_guard<std::mutex> lk(mtx_); tasks_.push(std::move(task)); }
+        cv_.notify_one();
+    }
+private:
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+};
+
+// tf::ThreadPool with every worker pinned to a CPU, grouped by NUMA node.
+class PinnedPool : public tf::ThreadPool {
+public:
+    explicit PinnedPool(size_t n) : tf::ThreadPool(options(n)) {}
+
+private:
+    static tf::PoolOptions options(size_t n) {
+        tf::PoolOptions o;
+        o.threads = n;
+        o.pinning = tf::Pinning::core;
+        return o;
+    }
+};
+
+static void wait_until(std::atomic<int64_t>& c, int64_t n) {
+    for (int64_t v = c.load(); v < n; v = c.load()) c.wait(v);
+}
+
+static void finish(std::atomic<int64_t>& c, int64_t n) {
+    if (c.fetch_add(1) + 1 == n) c.notify_all();
+}
+
+// N empty tasks submitted from one outside thread.
+template<class Pool>
+static void BM_FlatFanOut(benchmark::State& st) {
+    Pool pool(std::thread::hardware_concurrency());
+    const int64_t n = st.range(0);
+    for (auto _ : st) {
+        std::atomic<int64_t> done{0};
+        for (int64_t i = 0; i < n; ++i) pool.enqueue([&]{ finish(done, n); });
+        wait_until(done, n);
+    }
+    st.SetItemsProcessed(st.iterations() * n);
+}
+
+// One root spawns `fan` tasks, each of which spawns `fan` leaves: the
+// work-stealing pool keeps these on local deques.
+template<class Pool>
+static void BM_NestedFanOut(benchmark::State& st) {
+    Pool pool(std::thread::hardware_concurrency());
+    const int64_t fan = st.range(0);
+    const int64_t n = fan * fan;
+    for (auto _ : st) {
+        std::atomic<int64_t> done{0};
+        pool.enqueue([&] {
+            for (int64_t i = 0; i < fan; ++i)
+                pool.enqueue([&] {
+                    for (int64_t j = 0; j < fan; ++j) pool.enqueue([&]{ finish(done, n); });
+                });
+        });
+        wait_until(done, n);
+    }
+    st.SetItemsProcessed(st.iterations() * n);
+}
+
+// Data-heavy two-stage pipeline: each producer fills a fresh 1 MiB chunk
+// (first touch places its pages on the producer's node) and spawns the
+// consumer that reads it back, which pinned pools keep on the same node.
+template<class Pool>
+static void BM_ChunkPipeline(benchmark::State& st) {
+    Pool pool(std::thread::hardware_concurrency());
+    const int64_t chunks = st.range(0);
+    constexpr size_t kWords = (1 << 20) / sizeof(uint64_t);
+    std::atomic<uint64_t> sink{0};
+    for (auto _ : st) {
+        std::atomic<int64_t> done{0};
+        for (int64_t c = 0; c < chunks; ++c)
+            pool.enqueue([&, c] {
+                std::shared_ptr<uint64_t[]> data(new uint64_t[kWords]);
+                std::iota(data.get(), data.get() + kWords, static_cast<uint64_t>(c));
+                pool.enqueue([&, data] {
+                    sink.fetch_add(std::accumulate(data.get(), data.get() + kWords, uint64_t{0}),
+                                   std::memory_order_relaxed);
+                    finish(done, chunks);
+                });
+            });
+        wait_until(done, chunks);
+    }
+    benchmark::DoNotOptimize(sink.load());
+    st.SetBytesProcessed(st.iterations() * chunks * static_cast<int64_t>(kWords * sizeof(uint64_t)));
+}
+
+// One task after an idle gap, as with sporadic requests: the time until it
+// runs, and the process CPU time burnt per round, idle gap included. Args
+// are spin_rounds and yield_rounds; 0/0 parks right away.
+static void BM_IdleWakeLatency(benchmark::State& st) {
+    tf::PoolOptions opts;
+    opts.threads = std::thread::hardware_concurrency();
+    opts.spin_rounds = static_cast<uint32_t>(st.range(0));
+    opts.yield_rounds = static_cast<uint32_t>(st.range(1));
+    tf::ThreadPool pool(opts);
+    const std::clock_t cpu0 = std::clock();
+    for (auto _ : st) {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+        std::atomic<int64_t> done{0};
+        auto t0 = std::chrono::steady_clock::now();
+        pool.enqueue([&]{ finish(done, 1); });
+        wait_until(done, 1);
+        st.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    }
+    st.counters["cpu_us"] = benchmark::Counter(
+        1e6 * static_cast<double>(std::clock() - cpu0) / CLOCKS_PER_SEC / static_cast<double>(st.iterations()));
+}
+
+// Short bursts of tiny tasks separated by gaps, with a fixed pool and with an
+// elastic one whose spares come and go.
+static void BM_BurstsOfMicroTasks(benchmark::State& st) {
+    const size_t n = std::thread::hardware_concurrency();
+    tf::PoolOptions opts;
+    opts.threads = n;
+    opts.spin_rounds = static_cast<uint32_t>(st.range(1));
+    opts.max_threads = st.range(2) ? 2 * n : 0;
+    opts.idle_timeout = std::chrono::milliseconds(1);
+    tf::ThreadPool pool(opts);
+    const int64_t burst = st.range(0);
+    for (auto _ : st) {
+        std::atomic<int64_t> done{0};
+        for (int64_t i = 0; i < burst; ++i) pool.enqueue([&]{ finish(done, burst); });
+        wait_until(done, burst);
+        st.PauseTiming();
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        st.ResumeTiming();
+    }
+    st.SetItemsProcessed(st.iterations() * burst);
+}
+
+BENCHMARK_TEMPLATE(BM_FlatFanOut, LegacyPool)->Arg(1 << 14)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_FlatFanOut, tf::ThreadPool)->Arg(1 << 14)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_FlatFanOut, PinnedPool)->Arg(1 << 14)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_NestedFanOut, LegacyPool)->Arg(128)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_NestedFanOut, tf::ThreadPool)->Arg(128)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_NestedFanOut, PinnedPool)->Arg(128)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChunkPipeline, tf::ThreadPool)->Arg(256)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ChunkPipeline, PinnedPool)->Arg(256)->UseRealTime();
+
+BENCHMARK(BM_IdleWakeLatency)->Args({0, 0})->Args({32, 32})->Args({1024, 256})->UseManualTime();
+BENCHMARK(BM_BurstsOfMicroTasks)->Args({64, 0, 0})->Args({64, 32, 0})->Args({64, 32, 1})->UseRealTime();
+
+BENCHMARK_MAIN();
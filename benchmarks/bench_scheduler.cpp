@@ -0,0 +1,335 @@
+#include <taskflow/scheduler.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Scheduler workloads with latency percentiles. Reported counters:
+//   sched_p50/p99/p999  deadline (or submission, if later) to task start, us
+//   dep_p50/p99/p999    last dependency finishing to dependent start, us
+
+using namespace std::chrono_literals;
+
+namespace {
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        tf::Clock::now().time_since_epoch()).count();
+}
+
+// Samples appended concurrently by tasks during an iteration, then folded into
+// the run-wide set between iterations.
+class Latencies {
+public:
+    explicit Latencies(size_t per_iteration) : cur_(per_iteration) {}
+
+    void add(int64_t ns) {
+        size_t i = n_.fetch_add(1, std::memory_order_relaxed);
+        if (i < cur_.size()) cur_[i] = ns;
+    }
+
+    void collect() {
+        size_t n = std::min(n_.exchange(0), cur_.size());
+        if (all_.size() < kMaxSamples) all_.insert(all_.end(), cur_.begin(), cur_.begin() + n);
+    }
+
+    void report(benchmark::State& st, const std::string& prefix) {
+        collect();
+        if (all_.empty()) return;
+        auto pct = [&](double q) {
+            size_t k = std::min(all_.size() - 1, static_cast<size_t>(q * all_.size()));
+            std::nth_element(all_.begin(), all_.begin() + k, all_.end());
+            return all_[k] / 1e3;
+        };
+        st.counters[prefix + "_p50"] = pct(0.50);
+        st.counters[prefix + "_p99"] = pct(0.99);
+        st.counters[prefix + "_p999"] = pct(0.999);
+    }
+
+private:
+    static constexpr size_t kMaxSamples = 1 << 24;
+    std::vector<int64_t> cur_;
+    std::atomic<size_t> n_{0};
+    std::vector<int64_t> all_;
+};
+
+struct Countdown {
+    std::atomic<int64_t> left;
+    explicit Countdown(int64_t n) : left(n) {}
+    void done() { if (left.fetch_sub(1) == 1) left.notify_all(); }
+    void wait() { for (auto v = left.load(); v != 0; v = left.load()) left.wait(v); }
+};
+
+void fetch_max(std::atomic<int64_t>& a, int64_t v) {
+    for (int64_t cur = a.load(std::memory_order_relaxed);
+         cur < v && !a.compare_exchange_weak(cur, v, std::memory_order_relaxed);) {}
+}
+
+}  // namespace
+
+// source -> W independent tasks -> sink, submitted as one graph.
+static void BM_FanOutFanIn(benchmark::State& st) {
+    const int64_t width = st.range(0);
+    tf::Scheduler s;
+    s.start();
+    Latencies dep(static_cast<size_t>(width) + 1);
+    for (auto _ : st) {
+        std::atomic<int64_t> src_end{0}, mid_end{0};
+        tf::TaskGraph g;
+        auto src = g.add([&] { src_end = now_ns(); });
+        auto sink = g.add([&] { dep.add(now_ns() - mid_end.load()); });
+        for (int64_t i = 0; i < width; ++i) {
+            auto m = g.add([&] {
+                dep.add(now_ns() - src_end.load());
+                fetch_max(mid_end, now_ns());
+            });
+            g.precede(src, m);
+            g.precede(m, sink);
+        }
+        auto hs = s.submit(std::move(g));
+        s.wait_for(hs[sink]);
+        st.PauseTiming();
+        dep.collect();
+        st.ResumeTiming();
+    }
+    st.SetItemsProcessed(st.iterations() * (width + 2));
+    dep.report(st, "dep");
+    s.stop();
+}
+BENCHMARK(BM_FanOutFanIn)->RangeMultiplier(10)->Range(1000, 100000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// N nodes, each depending on 1-3 random nodes among the previous 1000.
+static void BM_RandomDag(benchmark::State& st) {
+    const size_t n = static_cast<size_t>(st.range(0));
+    tf::Scheduler s;
+    s.start();
+    Latencies dep(n);
+    std::mt19937 rng(7);
+    std::vector<std::vector<uint32_t>> preds(n);
+    for (size_t i = 1; i < n; ++i) {
+        size_t lo = i > 1000 ? i - 1000 : 0;
+        for (int k = 0, deg = 1 + static_cast<int>(rng() % 3); k < deg; ++k)
+            preds[i].push_back(static_cast<uint32_t>(lo + rng() % (i - lo)));
+        std::sort(preds[i].begin(), preds[i].end());
+        preds[i].erase(std::unique(preds[i].begin(), preds[i].end()), preds[i].end());
+    }
+    std::vector<std::atomic<int64_t>> end(n);
+
+    for (auto _ : st) {
+        st.PauseTiming();
+        Countdown left(static_cast<int64_t>(n));
+        tf::TaskGraph g;
+        for (size_t i = 0; i < n; ++i) {
+            g.add([&, i] {
+                int64_t ready = 0;
+                for (auto p : preds[i]) ready = std::max(ready, end[p].load(std::memory_order_relaxed));
+                if (ready) dep.add(now_ns() - ready);
+                end[i].store(now_ns(), std::memory_order_relaxed);
+                left.done();
+            });
+            for (auto p : preds[i]) g.precede(p, i);
+        }
+        st.ResumeTiming();
+
+        s.submit(std::move(g));
+        left.wait();
+
+        st.PauseTiming();
+        dep.collect();
+        while (s.task_count() != 0) std::this_thread::sleep_for(100us);
+        st.ResumeTiming();
+    }
+    st.SetItemsProcessed(st.iterations() * static_cast<int64_t>(n));
+    dep.report(st, "dep");
+    s.stop();
+}
+BENCHMARK(BM_RandomDag)->RangeMultiplier(10)->Range(10000, 1000000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// 1000 near-term timers racing a heap already holding `far` entries an hour out.
+static void BM_TimerHeavy(benchmark::State& st) {
+    const int64_t far = st.range(0);
+    constexpr int kNear = 1000;
+    tf::Scheduler s;
+    s.start();
+    for (int64_t i = 0; i < far; ++i) s.schedule_once(tf::Clock::now() + 1h + std::chrono::microseconds(i), []{});
+    Latencies sched(kNear);
+    std::mt19937 rng(11);
+    for (auto _ : st) {
+        Countdown left(kNear);
+        auto base = tf::Clock::now();
+        for (int i = 0; i < kNear; ++i) {
+            auto when = base + std::chrono::microseconds(rng() % 2000);
+            s.schedule_once(when, [&, when] {
+                sched.add(std::chrono::duration_cast<std::chrono::nanoseconds>(tf::Clock::now() - when).count());
+                left.done();
+            });
+        }
+        left.wait();
+        st.PauseTiming();
+        sched.collect();
+        st.ResumeTiming();
+    }
+    st.SetItemsProcessed(st.iterations() * kNear);
+    sched.report(st, "sched");
+    s.stop();
+}
+BENCHMARK(BM_TimerHeavy)->Arg(0)->Arg(10000)->Arg(100000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// K recurring tasks every millisecond for 100ms; latency is each run's start
+// against the deadline the scheduler planned for it.
+static void BM_ScheduleEvery(benchmark::State& st) {
+    const int64_t k = st.range(0);
+    Latencies sched(static_cast<size_t>(k) * 200);
+    int64_t runs = 0;
+    for (auto _ : st) {
+        std::atomic<int64_t> count{0};
+        {
+            tf::Scheduler s;
+            s.start();
+            for (int64_t i = 0; i < k; ++i)
+                s.schedule_every(1ms, [&] {
+                    auto planned = tf::ScheduledTask::current()->next_run;
+                    sched.add(std::chrono::duration_cast<std::chrono::nanoseconds>(tf::Clock::now() - planned).count());
+                    count.fetch_add(1, std::memory_order_relaxed);
+                });
+            std::this_thread::sleep_for(100ms);
+            s.stop();
+        }
+        runs += count.load();
+        st.PauseTiming();
+        sched.collect();
+        st.ResumeTiming();
+    }
+    st.SetItemsProcessed(runs);
+    sched.report(st, "sched");
+}
+BENCHMARK(BM_ScheduleEvery)->Arg(10)->Arg(100)->Arg(1000)->Iterations(3)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// P producer threads submitting due-now tasks; latency is submit to start.
+static void BM_MultiProducer(benchmark::State& st) {
+    const int producers = static_cast<int>(st.range(0));
+    constexpr int kTotal = 100000;
+    const int per = kTotal / producers;
+    tf::Scheduler s;
+    s.start();
+    Latencies sched(kTotal);
+    for (auto _ : st) {
+        Countdown left(int64_t(per) * producers);
+        std::vector<std::thread> ts;
+        for (int p = 0; p < producers; ++p)
+            ts.emplace_back([&] {
+                for (int i = 0; i < per; ++i) {
+                    int64_t t0 = now_ns();
+                    s.schedule_once(tf::Clock::now(), [&, t0] {
+                        sched.add(now_ns() - t0);
+                        left.done();
+                    });
+                }
+            });
+        for (auto& t : ts) t.join();
+        left.wait();
+        st.PauseTiming();
+        sched.collect();
+        st.ResumeTiming();
+    }
+    st.SetItemsProcessed(st.iterations() * int64_t(per) * producers);
+    sched.report(st, "sched");
+    s.stop();
+}
+BENCHMARK(BM_MultiProducer)->RangeMultiplier(4)->Range(1, 64)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Interactive tasks submitted one at a time while low-priority batch jobs
+// (50us each) keep every worker busy. Arg 0 runs both at the default
+// priority; arg 1 marks the batch Priority::low and the interactive tasks
+// Priority::high. Latency is submit to start.
+static void BM_MixedPriority(benchmark::State& st) {
+    const bool prioritized = st.range(0) != 0;
+    constexpr int kInteractive = 200;
+    tf::Scheduler s;
+    s.start();
+    tf::TaskOptions batch, interactive;
+    if (prioritized) {
+        batch.priority = tf::Priority::low;
+        interactive.priority = tf::Priority::high;
+    }
+    std::atomic<bool> flooding{true};
+    std::atomic<int64_t> batch_live{0};
+    std::thread flood([&] {
+        while (flooding.load(std::memory_order_relaxed)) {
+            if (batch_live.load(std::memory_order_relaxed) > 2000) {
+                std::this_thread::sleep_for(100us);
+                continue;
+            }
+            batch_live.fetch_add(1, std::memory_order_relaxed);
+            s.schedule_once(tf::Clock::now(), [&] {
+                auto end = tf::Clock::now() + 50us;
+                while (tf::Clock::now() < end) {}
+                batch_live.fetch_sub(1, std::memory_order_relaxed);
+            }, {}, batch);
+        }
+    });
+    while (batch_live.load() < 1000) std::this_thread::sleep_for(1ms);
+    Latencies sched(kInteractive);
+    for (auto _ : st) {
+        Countdown left(kInteractive);
+        for (int i = 0; i < kInteractive; ++i) {
+            int64_t t0 = now_ns();
+            s.schedule_once(tf::Clock::now(), [&, t0] {
+                sched.add(now_ns() - t0);
+                left.done();
+            }, {}, interactive);
+            std::this_thread::sleep_for(200us);
+        }
+        left.wait();
+        st.PauseTiming();
+        sched.collect();
+        st.ResumeTiming();
+    }
+    flooding = false;
+    flood.join();
+    st.SetItemsProcessed(st.iterations() * kInteractive);
+    sched.report(st, "sched");
+    s.stop();
+}
+BENCHMARK(BM_MixedPriority)->Arg(0)->Arg(1)->Iterations(3)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Empty tasks straight on the pool through intrusive Work items: the floor
+// under everything above.
+static void BM_PoolEmptyTasks(benchmark::State& st) {
+    struct Item : tf::ThreadPool::Work {
+        Countdown* left;
+    };
+    const size_t n = static_cast<size_t>(st.range(0));
+    tf::ThreadPool pool;
+    std::vector<Item> items(n);
+    for (auto& it : items)
+        it.execute = [](tf::ThreadPool::Work* w) { static_cast<Item*>(w)->left->done(); };
+    for (auto _ : st) {
+        Countdown left(static_cast<int64_t>(n));
+        for (auto& it : items) {
+            it.left = &left;
+            pool.submit(&it);
+        }
+        left.wait();
+    }
+    st.SetItemsProcessed(st.iterations() * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_PoolEmptyTasks)->Arg(100000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Same empty tasks through the full scheduler path (slot, intake, dispatch).
+static void BM_SchedulerEmptyTasks(benchmark::State& st) {
+    const int64_t n = st.range(0);
+    tf::Scheduler s;
+    s.start();
+    for (auto _ : st) {
+        Countdown left(n);
+        for (int64_t i = 0; i < n; ++i) s.schedule_once(tf::Clock::now(), [&] { left.done(); });
+        left.wait();
+    }
+    st.SetItemsProcessed(st.iterations() * n);
+    s.stop();
+}
+BENCHMARK(BM_SchedulerEmptyTasks)->Arg(100000)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
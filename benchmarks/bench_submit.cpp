@@ -0,0 +1,35 @@
+#include <taskflow/scheduler.hpp>
+#include <benchmark/benchmark.h>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+// Submissions per second from N producer threads hammering schedule_once.
+// Only the submission phase is timed; the scheduler then drains untimed.
+static void BM_Submit(benchmark::State& st) {
+    const int producers = static_cast<int>(st.range(0));
+    const int per_producer = 200000 / producers;
+    tf::Scheduler s;
+    s.start();
+    for (auto _ : st) {
+        std::atomic<int> go{0};
+        std::vector<std::thread> ts;
+        for (int p = 0; p < producers; ++p)
+            ts.emplace_back([&] {
+                go.fetch_add(1);
+                while (go.load() < producers) std::this_thread::yield();
+                for (int i = 0; i < per_producer; ++i) s.schedule_once(tf::Clock::now(), []{});
+            });
+        while (go.load() < producers) std::this_thread::yield();
+        auto begin = std::chrono::steady_clock::now();
+        for (auto& t : ts) t.join();
+        st.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count());
+        while (s.task_count() != 0) std::this_thread::sleep_for(1ms);
+    }
+    st.SetItemsProcessed(st.iterations() * producers * per_producer);
+    s.stop();
+}
+BENCHMARK(BM_Submit)->RangeMultiplier(2)->Range(1, 64)->UseManualTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,97 @@
+#include <taskflow/scheduler.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Recurring-timer accuracy. Reported counters, in us:
+//   jitter_p50/p99  fixed-rate 1ms ticks: run start minus its slot on the grid
+//   skipped         ticks dropped by the skip misfire policy, per 500 runs
+//   drift           last of 100 runs of a 1ms timer doing 200us of work,
+//                   minus where a perfect 1ms grid puts it (arg 0 = fixed
+//                   delay, 1 = fixed rate)
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// Start times of the first n runs.
+struct Ticks {
+    explicit Ticks(size_t n) : at(n) {}
+
+    void mark() {
+        size_t i = n.fetch_add(1, std::memory_order_relaxed);
+        if (i < at.size()) at[i] = tf::Clock::now();
+    }
+    void wait() const {
+        while (n.load(std::memory_order_relaxed) < at.size()) std::this_thread::sleep_for(1ms);
+    }
+
+    std::atomic<size_t> n{0};
+    std::vector<tf::TimePoint> at;
+};
+
+tf::TaskOptions fixed_rate() {
+    tf::TaskOptions o;
+    o.recurrence.rate = tf::Rate::fixed_rate;
+    return o;
+}
+
+double us(tf::Duration d) { return std::chrono::duration<double, std::micro>(d).count(); }
+
+}  // namespace
+
+static void BM_TickJitter(benchmark::State& st) {
+    std::vector<double> jitter;
+    double skipped = 0;
+    for (auto _ : st) {
+        Ticks ticks(500);
+        tf::TimePoint origin;
+        {
+            tf::Scheduler s(2);
+            s.start();
+            origin = tf::Clock::now() + 1ms;   // the first slot, give or take the call
+            s.schedule_every(1ms, [&] { ticks.mark(); }, {}, fixed_rate());
+            ticks.wait();
+            s.stop();
+        }
+        // A run later than a whole period skips a slot, so each start is
+        // measured from the last slot at or before it.
+        for (auto t : ticks.at) jitter.push_back(us((t - origin) % tf::Duration(1ms)));
+        skipped += static_cast<double>((ticks.at.back() - origin) / 1ms) - 499;
+    }
+    auto pct = [&](double q) {
+        size_t k = std::min(jitter.size() - 1, static_cast<size_t>(q * jitter.size()));
+        std::nth_element(jitter.begin(), jitter.begin() + k, jitter.end());
+        return jitter[k];
+    };
+    st.counters["jitter_p50"] = pct(0.50);
+    st.counters["jitter_p99"] = pct(0.99);
+    st.counters["skipped"] = skipped / static_cast<double>(st.iterations());
+}
+BENCHMARK(BM_TickJitter)->Iterations(5)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_Drift(benchmark::State& st) {
+    const bool rate = st.range(0) != 0;
+    double drift = 0;
+    for (auto _ : st) {
+        Ticks ticks(100);
+        {
+            tf::Scheduler s(2);
+            s.start();
+            s.schedule_every(1ms, [&] {
+                ticks.mark();
+                auto until = tf::Clock::now() + 200us;
+                while (tf::Clock::now() < until) {}
+            }, {}, rate ? fixed_rate() : tf::TaskOptions{});
+            ticks.wait();
+            s.stop();
+        }
+        drift += us(ticks.at.back() - (ticks.at.front() + 99 * 1ms));
+    }
+    st.counters["drift"] = drift / static_cast<double>(st.iterations());
+}
+BENCHMARK(BM_Drift)->Arg(0)->Arg(1)->Iterations(5)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -1,10 +1,10 @@
 #include <taskflow/scheduler.hpp>
 #include <iostream>
 #include <fstream>
+#include <optional>
 #include <vector>
 #include <string>
 #include <thread>
-#include <map>
 
 using namespace std::chrono_literals;
 
@@ -30,22 +30,12 @@ int main() {
     tf::Scheduler scheduler;
     scheduler.start();
 
-    std::map<std::string, tf::TaskHandle> task_handles;
-    
     std::cout << "Starting data processing pipeline...\n\n";
 
+    // Declare every stage by name, then wire dependencies by name
+    tf::TaskGraph graph;
     for (const auto& task_def : pipeline) {
-        // Convert dependency names to handles
-        std::vector<tf::TaskHandle> deps;
-        for (const auto& dep_name : task_def.dependencies) {
-            if (task_handles.find(dep_name) != task_handles.end()) {
-                deps.push_back(task_handles[dep_name]);
-            }
-        }
-
-        // Create the task
-        auto handle = scheduler.schedule_once(
-            tf::Clock::now() + 100ms, 
+        graph.add(task_def.name,
             [name = task_def.name, input = task_def.input_file, output = task_def.output_file, duration = task_def.duration]() {
                 std::cout << "[START] " << name;
                 if (!input.empty()) std::cout << " (input: " << input << ")";
@@ -56,17 +46,38 @@ int main() {
                 std::this_thread::sleep_for(duration);
                 
                 std::cout << "[DONE]  " << name << " (took " << duration.count() << "ms)" << std::endl;
-            },
-            deps
-        );
-
-        task_handles[task_def.name] = handle;
+            });
     }
+    for (const auto& task_def : pipeline) {
+        for (const auto& dep_name : task_def.dependencies) {
+            graph.precede(dep_name, task_def.name);
+        }
+    }
+
+    // Validate and submit the whole pipeline at once
+    auto notify = graph.find("notify_users");
+    auto handles = scheduler.submit(std::move(graph), tf::Clock::now() + 100ms);
 
     // Wait for the final task to complete
-    if (task_handles.find("notify_users") != task_handles.end()) {
-        scheduler.wait_for(task_handles["notify_users"]);
-    }
+    scheduler.wait_for(handles[notify]);
+
+    // Record-level streaming: parse in parallel, enrich, and write in input
+    // order, with at most 16 records in flight however long the input is.
+    std::cout << "\nStreaming records...\n";
+    auto records = tf::make_pipeline(16,
+        [i = 0]() mutable -> std::optional<std::string> {
+            if (i == 10) return std::nullopt;
+            ++i;
+            return "row" + std::to_string(i) + ",value=" + std::to_string(i * 10);
+        },
+        tf::stage(tf::StageMode::parallel, [](std::string row) {
+            return std::stoi(row.substr(row.find('=') + 1));
+        }),
+        tf::stage(tf::StageMode::parallel, [](int value) { return value * 1.5; }),
+        tf::stage(tf::StageMode::serial_in_order, [](double v) {
+            std::cout << "  wrote " << v << std::endl;
+        }));
+    scheduler.submit(std::move(records), {handles[notify]}).get();
 
     std::cout << "\nPipeline completed successfully!" << std::endl;
     scheduler.stop();
@@ -0,0 +1,97 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace tf {
+
+// Bounded multi-producer, multi-consumer ring (Vyukov). Every cell carries a
+// sequence number that tells producers and consumers whose turn it is, so
+// push and pop are one CAS on the shared index each and never block.
+// Capacity is rounded up to a power of two.
+template<class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity)
+        : mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1),
+          cells_(std::make_unique<Cell[]>(mask_ + 1)) {
+        for (size_t i = 0; i <= mask_; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // Not safe against concurrent push/pop.
+    ~BoundedQueue() {
+        for (size_t pos = head_.load(); pos != tail_.load(); ++pos)
+            std::launder(reinterpret_cast<T*>(cells_[pos & mask_].storage))->~T();
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // False if the queue is full; v is left untouched then.
+    bool try_push(T&& v) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& c = cells_[pos & mask_];
+            size_t seq = c.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    new (c.storage) T(std::move(v));
+                    c.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::optional<T> try_pop() {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& c = cells_[pos & mask_];
+            size_t seq = c.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T* p = std::launder(reinterpret_cast<T*>(c.storage));
+                    std::optional<T> out(std::move(*p));
+                    p->~T();
+                    c.seq.store(pos + mask_ + 1, std::memory_order_release);
+                    return out;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Approximate unless the caller orders it against the producers.
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> seq;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    const size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+}  // namespace tf
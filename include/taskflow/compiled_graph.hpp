@@ -0,0 +1,58 @@
+#pragma once
+#include "task_graph.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <vector>
+
+namespace tf {
+
+// Immutable, re-runnable form of a TaskGraph. Nodes are renumbered in
+// topological order and adjacency is stored as flat CSR arrays; each run only
+// resets the per-node in-degree counters, so re-execution allocates nothing.
+// Run it through Scheduler::run()/run_n(). One run at a time per graph.
+class CompiledGraph {
+public:
+    // Throws std::invalid_argument on a cycle or on dependencies on
+    // external TaskHandles, which have no meaning across runs.
+    explicit CompiledGraph(TaskGraph&& g);
+    CompiledGraph(const CompiledGraph&) = delete;
+    CompiledGraph& operator=(const CompiledGraph&) = delete;
+
+    size_t size() const { return fns_.size(); }
+    size_t edge_count() const { return successors_.size(); }
+    // Position of a TaskGraph node in the compiled (topological) order.
+    uint32_t index_of(TaskGraph::NodeId n) const { return remap_.at(n); }
+
+    // Blocking: runs every node once on `pool` and rethrows the first task
+    // exception. Called from a pool worker, the caller helps run queued work;
+    // work a shut-down pool refuses runs on the calling thread.
+    void run(ThreadPool& pool);
+
+private:
+    struct NodeWork : ThreadPool::Work {
+        CompiledGraph* graph = nullptr;
+        uint32_t index = 0;
+    };
+
+    void execute(uint32_t i);
+
+    std::vector<UniqueTask> fns_;
+    std::vector<uint32_t> offsets_;      // successors of i: [offsets_[i], offsets_[i+1])
+    std::vector<uint32_t> successors_;
+    std::vector<uint32_t> in_degree_;
+    std::vector<uint32_t> roots_;
+    std::vector<uint32_t> remap_;
+    std::vector<NodeWork> work_;
+    std::unique_ptr<std::atomic<uint32_t>[]> pending_;
+
+    ThreadPool* pool_ = nullptr;
+    std::atomic<uint32_t> remaining_{0};
+    std::atomic<bool> notified_{false};   // the last node is done with *this
+    std::atomic<bool> running_{false};
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
+};
+
+}  // namespace tf
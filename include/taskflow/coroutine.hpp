@@ -0,0 +1,222 @@
+#pragma once
+#include "task.hpp"
+#include "task_future.hpp"
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace tf {
+
+class Scheduler;
+template<class T> class Co;
+
+namespace detail {
+// Implemented in scheduler.cpp. Schedules a one-shot task that resumes `h` on the pool once `when` has
+// passed and `dep` (if valid) has finished. If the scheduler goes away first,
+// the task is destroyed unrun and takes the whole coroutine chain (`root`)
+// with it. `task` is the spawned task the chain belongs to.
+void resume_after(Scheduler& s, TimePoint when, TaskHandle dep, const TaskOptions& opts,
+                  std::coroutine_handle<> h, std::coroutine_handle<> root, ScheduledTask* task);
+
+struct CoPromiseBase;
+
+// Resumes a suspended coroutine; if destroyed unrun (scheduler shut down),
+// frees the coroutine chain instead. While it runs, the spawned task is
+// current again, so CancelToken::current() sees that task's stop requests.
+struct Resume {
+    std::coroutine_handle<> h, root;
+    ScheduledTask* task;
+    Resume(std::coroutine_handle<> h, std::coroutine_handle<> root, ScheduledTask* task)
+        : h(h), root(root), task(task) {}
+    Resume(Resume&& o) noexcept : h(o.h), root(std::exchange(o.root, nullptr)), task(o.task) {}
+    ~Resume() { if (root) root.destroy(); }
+    void operator()() {
+        root = nullptr;
+        ScheduledTask* outer = std::exchange(ScheduledTask::current(), task);
+        h.resume();
+        ScheduledTask::current() = outer;
+    }
+};
+
+template<class A>
+concept SchedulerAwaitable = std::is_same_v<std::remove_cvref_t<A>, TaskHandle>;
+
+// co_await on a TaskHandle: resumes once that task has finished (or at once
+// if it was already reclaimed).
+struct HandleAwaiter {
+    TaskHandle h;
+    bool await_ready() const noexcept { return !h.is_valid(); }
+    template<class P> void await_suspend(std::coroutine_handle<P> c);
+    void await_resume() const noexcept {}
+};
+
+// co_await on a TaskFuture<R>: as above, then yields a copy of the value or
+// rethrows the task's exception.
+template<class R>
+struct FutureAwaiter {
+    TaskFuture<R> f;
+    bool await_ready() const { return f.ready(); }
+    template<class P> void await_suspend(std::coroutine_handle<P> c);
+    R await_resume() const {
+        if constexpr (std::is_void_v<R>) f.get();
+        else return f.get();
+    }
+};
+
+// Everything the coroutine frames of one spawned chain share: the scheduler
+// that resumes them, the options resume tasks are scheduled with, and the
+// outermost frame.
+struct CoPromiseBase {
+    Scheduler* sched = nullptr;
+    TaskOptions opts;
+    std::coroutine_handle<> root;           // outermost frame; owns the chain
+    std::coroutine_handle<> continuation;   // awaiting frame; null for the root
+    ScheduledTask* task = nullptr;          // the spawned task
+    TaskHandle self;                        // root only
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    void unhandled_exception() noexcept { error = std::current_exception(); }
+
+    HandleAwaiter await_transform(TaskHandle h) noexcept { return {h}; }
+    template<class R>
+    FutureAwaiter<R> await_transform(TaskFuture<R> f) { return {std::move(f)}; }
+    template<class A>
+        requires (!SchedulerAwaitable<A>)
+    A&& await_transform(A&& a) noexcept { return std::forward<A>(a); }
+};
+
+template<class P>
+void HandleAwaiter::await_suspend(std::coroutine_handle<P> c) {
+    CoPromiseBase& p = c.promise();
+    resume_after(*p.sched, Clock::now(), h, p.opts, c, p.root, p.task);
+}
+
+template<class R>
+template<class P>
+void FutureAwaiter<R>::await_suspend(std::coroutine_handle<P> c) {
+    CoPromiseBase& p = c.promise();
+    resume_after(*p.sched, Clock::now(), f.handle(), p.opts, c, p.root, p.task);
+}
+
+template<class T>
+struct CoValue {
+    std::optional<T> value;
+    template<class U = T> void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+    T take() { return std::move(*value); }
+};
+template<>
+struct CoValue<void> {
+    void return_void() noexcept {}
+    void take() noexcept {}
+};
+
+}  // namespace detail
+
+// co_await sched.sleep(d) / sched.sleep_until(tp): resumes on the pool once
+// the time has come, without holding a worker meanwhile.
+struct SleepAwaiter {
+    Scheduler* sched;
+    TimePoint when;
+    bool await_ready() const { return when <= Clock::now(); }
+    template<class P>
+    void await_suspend(std::coroutine_handle<P> c) {
+        detail::CoPromiseBase& p = c.promise();
+        detail::resume_after(*sched, when, TaskHandle{}, p.opts, c, p.root, p.task);
+    }
+    void await_resume() const noexcept {}
+};
+
+// Lazily started coroutine task. Run it with Scheduler::spawn, or co_await it
+// from another Co, which starts it right away on the same thread and resumes
+// the caller when it returns. Inside, co_await accepts a TaskHandle, a
+// TaskFuture, Scheduler::sleep(), or another Co; a suspended coroutine holds
+// no thread and is resumed on the pool.
+template<class T = void>
+class [[nodiscard]] Co {
+public:
+    struct promise_type : detail::CoPromiseBase, detail::CoValue<T> {
+        Co get_return_object() {
+            return Co(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        auto final_suspend() noexcept { return Final{}; }
+    };
+
+    Co(Co&& o) noexcept : h_(std::exchange(o.h_, nullptr)) {}
+    Co& operator=(Co o) noexcept { std::swap(h_, o.h_); return *this; }
+    ~Co() { if (h_) h_.destroy(); }
+
+    // Awaiting a child Co: inherit the chain, start it, and continue here
+    // when it finishes (symmetric transfer, no scheduler round-trip).
+    struct Awaiter {
+        std::coroutine_handle<promise_type> child;
+        bool await_ready() const noexcept { return false; }
+        template<class P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> parent) noexcept {
+            detail::CoPromiseBase& pp = parent.promise();
+            auto& cp = child.promise();
+            cp.sched = pp.sched;
+            cp.opts = pp.opts;
+            cp.root = pp.root;
+            cp.task = pp.task;
+            cp.continuation = parent;
+            return child;
+        }
+        T await_resume() {
+            auto& cp = child.promise();
+            if (cp.error) std::rethrow_exception(cp.error);
+            return cp.take();
+        }
+    };
+    Awaiter operator co_await() && noexcept { return Awaiter{h_}; }
+
+private:
+    friend class Scheduler;
+    explicit Co(std::coroutine_handle<promise_type> h) : h_(h) {}
+
+    // A child hands control back to whoever awaited it. The root stores its
+    // outcome in the spawned task, frees its frame, and completes the task
+    // unless ScheduledTask::run() still holds a ref.
+    struct Final {
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+            auto& p = h.promise();
+            if (p.continuation) return p.continuation;
+            ScheduledTask* t = p.task;
+            Scheduler* s = p.sched;
+            TaskHandle self = p.self;
+            if (p.error) {
+                t->error = p.error;
+            } else if constexpr (!std::is_void_v<T>) {
+                try { t->result.template emplace<T>(p.take()); }
+                catch (...) { t->error = std::current_exception(); }
+            }
+            h.destroy();
+            if (t->detach_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                detail::complete_detached(*s, self);
+            return std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+    };
+
+    // The spawned task's callable. Binds the frame to the running task and
+    // starts it; owns the frame until then.
+    struct Start {
+        std::coroutine_handle<promise_type> h;
+        explicit Start(std::coroutine_handle<promise_type> h) : h(h) {}
+        Start(Start&& o) noexcept : h(std::exchange(o.h, nullptr)) {}
+        ~Start() { if (h) h.destroy(); }
+        void operator()() {
+            auto& p = h.promise();
+            p.task = ScheduledTask::current();
+            p.self = detail::detach_current();
+            std::exchange(h, nullptr).resume();
+        }
+    };
+
+    std::coroutine_handle<promise_type> h_;
+};
+
+}  // namespace tf
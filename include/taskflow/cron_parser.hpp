@@ -1,15 +1,49 @@
 #pragma once
 #include <string>
 #include <chrono>
+#include <ctime>
+#include <cstdint>
+#include <vector>
 
 namespace tf {
 
+// A cron expression compiled to one bitmask per field. Bit i of a mask is set
+// when value i matches. Accepted syntax per field: `*`, `?` (day fields),
+// numbers, names (JAN-DEC, SUN-SAT), ranges `a-b`, steps `*/n`, `a/n`,
+// `a-b/n`, and comma-separated lists of those. Five fields
+// (min hour dom month dow) or six with a leading seconds field, plus the
+// macros @yearly, @annually, @monthly, @weekly, @daily, @midnight, @hourly.
 struct CronSchedule {
-    int minute = -1, hour = -1, day_of_month = -1, month = -1, day_of_week = -1;
+    uint64_t seconds = 0;       // bits 0-59
+    uint64_t minutes = 0;       // bits 0-59
+    uint32_t hours = 0;         // bits 0-23
+    uint32_t days_of_month = 0; // bits 1-31
+    uint16_t months = 0;        // bits 1-12
+    uint8_t days_of_week = 0;   // bits 0-6, Sunday = 0 (7 is accepted as Sunday)
+    // Vixie semantics: if both day fields are restricted, a day matches when
+    // either does; otherwise both must match.
+    bool dom_restricted = false;
+    bool dow_restricted = false;
     bool valid = false;
 };
 
 CronSchedule parse_cron(const std::string& expr);
-std::chrono::system_clock::time_point next_cron_time(const CronSchedule& s);
 
-}  // namespace tf
\ No newline at end of file
+// Whether the broken-down local time `tm` is a firing time of `s`.
+bool cron_matches(const CronSchedule& s, const std::tm& tm);
+
+// First firing time strictly after `from` (local time), found by scanning the
+// field bitmasks rather than stepping through minutes. Returns
+// time_point::max() for schedules that can never fire (e.g. Feb 30). A local
+// time skipped by a DST jump fires just after the jump.
+std::chrono::system_clock::time_point next_cron_time(
+    const CronSchedule& s,
+    std::chrono::system_clock::time_point from = std::chrono::system_clock::now());
+
+// Bulk form: out[i] = next_cron_time(schedules[i], from), sharing the
+// local-time decomposition of `from` across all schedules.
+void next_cron_times(const std::vector<CronSchedule>& schedules,
+                     std::chrono::system_clock::time_point from,
+                     std::vector<std::chrono::system_clock::time_point>& out);
+
+}  // namespace tf
@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <thread>
+
+#if defined(__linux__) && __has_include(<linux/futex.h>)
+#include <cerrno>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define TASKFLOW_HAS_FUTEX 1
+#else
+#define TASKFLOW_HAS_FUTEX 0
+#endif
+
+namespace tf {
+
+// Lets threads sleep until a condition they poll may have changed, with no
+// mutex on either side. A waiter announces itself, checks the condition once
+// more, and sleeps only if nobody has signalled since:
+//
+//     auto key = ec.prepare_wait();
+//     if (ready()) ec.cancel_wait(); else ec.wait(key);
+//
+// A signaller makes the condition true first, then calls notify_*(), which
+// costs a fence and a load while nobody waits.
+class EventCount {
+public:
+    using Key = uint32_t;
+
+    Key prepare_wait() {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        return epoch_.load(std::memory_order_seq_cst);
+    }
+    void cancel_wait() { waiters_.fetch_sub(1, std::memory_order_seq_cst); }
+
+    // Sleeps until a notify after prepare_wait() returned `key`. False if
+    // `timeout` ran out first. Either way the caller is no longer a waiter.
+    bool wait(Key key, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) {
+        bool notified = true;
+        const bool timed = timeout != std::chrono::nanoseconds::max();
+        const auto until = timed ? std::chrono::steady_clock::now() + timeout
+                                 : std::chrono::steady_clock::time_point::max();
+        while (epoch_.load(std::memory_order_acquire) == key) {
+            if (timed && std::chrono::steady_clock::now() >= until) {
+                notified = false;
+                break;
+            }
+#if TASKFLOW_HAS_FUTEX
+            timespec ts{}, *tp = nullptr;
+            if (timed) {
+                auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(until - std::chrono::steady_clock::now());
+                if (left.count() < 0) left = {};
+                ts.tv_sec = static_cast<time_t>(left.count() / 1'000'000'000);
+                ts.tv_nsec = static_cast<long>(left.count() % 1'000'000'000);
+                tp = &ts;
+            }
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAIT_PRIVATE, key, tp, nullptr, 0);
+#else
+            if (timed) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            else epoch_.wait(key, std::memory_order_acquire);
+#endif
+        }
+        waiters_.fetch_sub(1, std::memory_order_seq_cst);
+        return notified;
+    }
+
+    void notify_one() { notify(false); }
+    void notify_all() { notify(true); }
+    uint32_t waiters() const { return waiters_.load(std::memory_order_relaxed); }
+
+private:
+    void notify(bool all) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) == 0) return;
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+#if TASKFLOW_HAS_FUTEX
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_), FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1,
+                  nullptr, nullptr, 0);
+#else
+        if (all) epoch_.notify_all();
+        else epoch_.notify_one();
+#endif
+    }
+
+    std::atomic<uint32_t> epoch_{0};
+    std::atomic<uint32_t> waiters_{0};
+};
+
+}  // namespace tf
@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Set through the TASKFLOW_ENABLE_INSTRUMENTATION CMake option. When 0 every
+// recording hook compiles to nothing; metrics() reports enabled == false and
+// traces come out empty.
+#ifndef TASKFLOW_INSTRUMENTATION
+#define TASKFLOW_INSTRUMENTATION 0
+#endif
+
+namespace tf {
+
+// Power-of-two latency buckets: bucket i counts samples in [2^i, 2^(i+1)) ns,
+// bucket 0 also takes zero.
+struct LatencyHistogram {
+    static constexpr int kBuckets = 48;
+    std::array<uint64_t, kBuckets> counts{};
+
+    static int bucket(uint64_t ns) {
+        return ns ? std::min(kBuckets - 1, 63 - std::countl_zero(ns)) : 0;
+    }
+    uint64_t count() const {
+        uint64_t n = 0;
+        for (auto c : counts) n += c;
+        return n;
+    }
+    // Upper bound, in nanoseconds, of the bucket holding quantile q; 0 if empty.
+    uint64_t percentile(double q) const {
+        uint64_t n = count();
+        if (n == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(n - 1)) + 1;
+        for (int i = 0; i < kBuckets; ++i) {
+            if (counts[i] >= rank) return (uint64_t(2) << i) - 1;
+            rank -= counts[i];
+        }
+        return ~uint64_t(0);
+    }
+};
+
+struct WorkerMetrics {
+    uint64_t jobs = 0;      // pool jobs run
+    uint64_t steals = 0;    // of which taken from another worker's deque
+    uint64_t busy_ns = 0;   // time spent inside jobs; / uptime = utilization
+};
+
+struct SchedulerMetrics {
+    bool enabled = false;
+    double uptime_seconds = 0;
+    uint64_t submitted = 0;
+    uint64_t started = 0;
+    uint64_t finished = 0;
+    double throughput = 0;          // finished per second of uptime
+    size_t live_tasks = 0;          // slots held: pending, running, recurring, pinned
+    size_t queue_depth = 0;         // pool jobs waiting for a worker (approximate)
+    std::vector<WorkerMetrics> workers;
+    LatencyHistogram dependency_wait;   // due (or submitted, if later) -> ready
+    LatencyHistogram queue_wait;        // ready -> start
+    LatencyHistogram run_time;          // start -> finish
+};
+
+namespace detail {
+
+inline int64_t trace_clock_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Relaxed counter cell. Every worker owns its cells, so increments stay in
+// that worker's cache; readers only ever sum.
+struct Counter {
+    std::atomic<uint64_t> v{0};
+    void add(uint64_t n) { v.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t get() const { return v.load(std::memory_order_relaxed); }
+};
+
+struct alignas(64) PoolWorkerStats {
+    Counter jobs, steals, busy_ns;
+};
+
+struct alignas(64) TaskStats {
+    Counter submitted, started, finished;
+    std::array<Counter, LatencyHistogram::kBuckets> dependency_wait, queue_wait, run_time;
+
+    static void record(std::array<Counter, LatencyHistogram::kBuckets>& h, int64_t ns) {
+        h[LatencyHistogram::bucket(ns > 0 ? uint64_t(ns) : 0)].add(1);
+    }
+    static void fold(const std::array<Counter, LatencyHistogram::kBuckets>& h, LatencyHistogram& out) {
+        for (int i = 0; i < LatencyHistogram::kBuckets; ++i) out.counts[i] += h[i].get();
+    }
+};
+
+// Seqlock-protected slot; every field is a relaxed atomic so a racing reader
+// sees stale or mixed values (and discards them) rather than undefined ones.
+struct TraceEvent {
+    static constexpr size_t kNameWords = 4;
+    std::atomic<uint64_t> seq{0};   // 2 * lap + 1 while being written, + 2 when done
+    std::atomic<uint64_t> task{0};           // TaskHandle::id
+    std::atomic<uint64_t> released_by{0};    // dependency whose completion made it ready
+    std::atomic<int64_t> start_ns{0};
+    std::atomic<int64_t> end_ns{0};
+    std::array<std::atomic<uint64_t>, kNameWords> name{};
+};
+
+// Fixed-size ring of the most recent task runs of one worker. Single writer;
+// a reader skips slots that are mid-write or were overwritten while it copied.
+class TraceRing {
+public:
+    struct Record {
+        uint64_t task, released_by;
+        int64_t start_ns, end_ns;
+        char name[TraceEvent::kNameWords * 8];
+    };
+
+    explicit TraceRing(size_t capacity) : events_(std::max<size_t>(capacity, 1)) {}
+
+    void record(uint64_t task, uint64_t released_by, int64_t start, int64_t end, const char* name) {
+        uint64_t i = next_++;
+        TraceEvent& e = events_[i % events_.size()];
+        uint64_t lap = i / events_.size();
+        e.seq.store(2 * lap + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        e.task.store(task, std::memory_order_relaxed);
+        e.released_by.store(released_by, std::memory_order_relaxed);
+        e.start_ns.store(start, std::memory_order_relaxed);
+        e.end_ns.store(end, std::memory_order_relaxed);
+        uint64_t words[TraceEvent::kNameWords] = {};
+        std::strncpy(reinterpret_cast<char*>(words), name, sizeof(words) - 1);
+        for (size_t w = 0; w < TraceEvent::kNameWords; ++w)
+            e.name[w].store(words[w], std::memory_order_relaxed);
+        e.seq.store(2 * lap + 2, std::memory_order_release);
+    }
+
+    template<class Fn>
+    void for_each(Fn fn) const {
+        for (const TraceEvent& e : events_) {
+            uint64_t s = e.seq.load(std::memory_order_acquire);
+            if (s == 0 || (s & 1)) continue;
+            Record r{e.task.load(std::memory_order_relaxed), e.released_by.load(std::memory_order_relaxed),
+                     e.start_ns.load(std::memory_order_relaxed), e.end_ns.load(std::memory_order_relaxed), {}};
+            uint64_t words[TraceEvent::kNameWords];
+            for (size_t w = 0; w < TraceEvent::kNameWords; ++w)
+                words[w] = e.name[w].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (e.seq.load(std::memory_order_relaxed) != s) continue;
+            std::memcpy(r.name, words, sizeof(r.name));
+            r.name[sizeof(r.name) - 1] = '\0';
+            fn(r);
+        }
+    }
+
+private:
+    std::vector<TraceEvent> events_;
+    uint64_t next_ = 0;
+};
+
+}  // namespace detail
+}  // namespace tf
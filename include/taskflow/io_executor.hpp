@@ -0,0 +1,133 @@
+#pragma once
+#include "task.hpp"
+#include "task_future.hpp"
+#include "coroutine.hpp"
+#include "thread_pool.hpp"
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace tf {
+
+class Scheduler;
+
+namespace detail {
+class IoDriver;
+
+// One transfer. `done` is called once, on whichever thread saw it finish,
+// with the byte count or -errno.
+struct IoRequest {
+    enum Op : uint8_t { read, write, fsync };
+    Op op;
+    int fd;
+    void* buf;
+    size_t len;
+    uint64_t offset;
+    void (*done)(IoRequest*, long);
+};
+
+// Throws the std::system_error for a failed request.
+[[noreturn]] void throw_io_error(IoRequest::Op op, long res);
+}  // namespace detail
+
+enum class IoBackend { io_uring, threads };
+
+class IoExecutor;
+
+// co_await io.async_read(...) and friends inside a Co. The request lives in
+// the coroutine frame and the completion queues the resumption straight onto
+// the pool, so there is no task and no allocation per transfer.
+class IoAwaiter : detail::IoRequest {
+public:
+    bool await_ready() const noexcept { return false; }
+    template<class P>
+    void await_suspend(std::coroutine_handle<P> c) {
+        detail::CoPromiseBase& p = c.promise();
+        h_ = c;
+        root_ = p.root;
+        task_ = p.task;
+        priority_ = p.opts.priority;
+        deadline_ = p.opts.deadline;
+        pool_ = ThreadPool::current();
+        submit();
+    }
+    // Bytes transferred (0 for fsync); throws std::system_error on failure.
+    size_t await_resume() const {
+        if (res_ < 0) detail::throw_io_error(op, res_);
+        return static_cast<size_t>(res_);
+    }
+
+private:
+    friend class IoExecutor;
+    IoAwaiter(IoExecutor& io, Op op, int fd, void* buf, size_t len, uint64_t offset)
+        : IoRequest{op, fd, buf, len, offset, &resume}, io_(&io) {}
+    void submit();
+    static void resume(IoRequest* r, long res);
+
+    IoExecutor* io_;
+    ThreadPool* pool_ = nullptr;
+    std::coroutine_handle<> h_, root_;
+    ScheduledTask* task_ = nullptr;
+    Priority priority_ = Priority::normal;
+    Duration deadline_ = Duration::max();   // counted from the resumption
+    long res_ = 0;
+};
+
+// Asynchronous file I/O beside the compute pool. A request hands its
+// transfer to the backend and gives the worker back; the kernel does the
+// waiting. read/write/fsync are one-shot tasks of the scheduler that finish
+// with their transfer, so they take deps and can be depended on like any
+// other task. async_read/async_write/async_fsync are the cheaper form for
+// coroutines.
+//
+// The io_uring backend submits straight to a kernel ring and reaps
+// completions on one thread. Where io_uring is unavailable (old kernels,
+// seccomp, io_uring_disabled), or when IoBackend::threads is asked for,
+// a few dedicated threads make blocking calls instead.
+class IoExecutor {
+public:
+    // `queue_depth` bounds the transfers in the kernel at once; more wait
+    // in the executor. `threads` sizes the blocking fallback.
+    explicit IoExecutor(Scheduler& s, IoBackend backend = IoBackend::io_uring,
+                        unsigned queue_depth = 256, size_t threads = 4);
+    // Waits for transfers in flight. Requests still waiting on deps must not
+    // outlive the executor.
+    ~IoExecutor();
+    IoExecutor(const IoExecutor&) = delete;
+    IoExecutor& operator=(const IoExecutor&) = delete;
+
+    IoBackend backend() const { return backend_; }
+
+    // pread/pwrite/fsync as tasks. The future holds the byte count, short at
+    // end of file, or throws std::system_error. Buffers must stay valid
+    // until it is ready.
+    TaskFuture<size_t> read(int fd, std::span<std::byte> buf, uint64_t offset,
+                            const std::vector<TaskHandle>& deps = {}, const TaskOptions& opts = {});
+    TaskFuture<size_t> write(int fd, std::span<const std::byte> buf, uint64_t offset,
+                             const std::vector<TaskHandle>& deps = {}, const TaskOptions& opts = {});
+    TaskFuture<void> fsync(int fd, const std::vector<TaskHandle>& deps = {}, const TaskOptions& opts = {});
+
+    // The same, awaited directly from a Co; it resumes on the pool.
+    IoAwaiter async_read(int fd, std::span<std::byte> buf, uint64_t offset) {
+        return {*this, detail::IoRequest::read, fd, buf.data(), buf.size(), offset};
+    }
+    IoAwaiter async_write(int fd, std::span<const std::byte> buf, uint64_t offset) {
+        return {*this, detail::IoRequest::write, fd, const_cast<std::byte*>(buf.data()), buf.size(), offset};
+    }
+    IoAwaiter async_fsync(int fd) { return {*this, detail::IoRequest::fsync, fd, nullptr, 0, 0}; }
+
+private:
+    friend class IoAwaiter;
+    template<class R>
+    TaskFuture<R> submit(detail::IoRequest::Op op, int fd, void* buf, size_t len, uint64_t offset,
+                         const std::vector<TaskHandle>& deps, const TaskOptions& opts);
+
+    Scheduler& sched_;
+    IoBackend backend_;
+    std::unique_ptr<detail::IoDriver> driver_;
+};
+
+}  // namespace tf
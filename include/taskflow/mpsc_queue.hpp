@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+
+namespace tf {
+
+// Intrusive multi-producer, single-consumer queue. Producers link a node in
+// with one CAS; the consumer takes everything queued so far with one exchange
+// and walks it in push order. Nodes carry their own link (`Next`), so nothing
+// is allocated.
+template<class T, T* T::*Next>
+class MpscQueue {
+public:
+    // Any thread. Returns true if the queue was empty, i.e. the consumer may
+    // be about to sleep and need a wake-up.
+    bool push(T* n) { return push_chain(n, n); }
+
+    // Any thread. Pushes newest..oldest in one step; the caller has already
+    // linked them newest -> oldest through `Next`.
+    bool push_chain(T* newest, T* oldest) {
+        T* top = head_.load(std::memory_order_relaxed);
+        do {
+            oldest->*Next = top;
+        } while (!head_.compare_exchange_weak(top, newest, std::memory_order_release,
+                                              std::memory_order_relaxed));
+        return top == nullptr;
+    }
+
+    // Consumer only. Detaches everything queued and returns it oldest first.
+    T* take_all() {
+        T* n = head_.exchange(nullptr, std::memory_order_acquire);
+        T* fifo = nullptr;
+        while (n) {
+            T* next = n->*Next;
+            n->*Next = fifo;
+            fifo = n;
+            n = next;
+        }
+        return fifo;
+    }
+
+    bool empty() const { return head_.load(std::memory_order_relaxed) == nullptr; }
+
+private:
+    std::atomic<T*> head_{nullptr};
+};
+
+}  // namespace tf
@@ -0,0 +1,264 @@
+#pragma once
+#include "thread_pool.hpp"
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <thread>
+#include <utility>
+
+namespace tf {
+
+// Data-parallel loops over an integral range [first, last) (the body gets the
+// index) or a random-access iterator range / container (the body gets the
+// element). Blocking; exceptions from the body are rethrown after the loop.
+//
+// The range is split in halves recursively: a worker keeps the left half and
+// pushes the right half onto its own deque, where idle workers steal it.
+// A fresh range may split log2(workers) + 3 levels deep; a half that is
+// stolen gets that budget again, so splitting follows the actual imbalance
+// rather than a fixed chunk count. No piece is split below `grain`
+// iterations (0: one cache line of elements), and over contiguous storage
+// split points fall on cache-line boundaries, so no two pieces write to the
+// same line.
+//
+// Called on a pool worker (e.g. inside a scheduler task) the loop runs on
+// that pool and the caller helps instead of blocking; the forms without a
+// pool argument run serially anywhere else.
+
+namespace detail {
+
+inline constexpr size_t kCacheLine = 64;
+
+template<class I>
+concept ParallelIndex = std::integral<I> || std::random_access_iterator<I>;
+
+// Maps [0, n) back onto the caller's range.
+template<class I>
+decltype(auto) range_at(I first, size_t k) {
+    if constexpr (std::integral<I>) return static_cast<I>(first + static_cast<I>(k));
+    else return *(first + static_cast<std::iter_difference_t<I>>(k));
+}
+
+template<class I>
+size_t range_size(I first, I last) {
+    return last > first ? static_cast<size_t>(last - first) : 0;
+}
+
+// Recursive splitter over [0, n). Leaf(lo, hi) folds one piece into a T;
+// Combine(T, T) joins neighbouring pieces, left first.
+template<class T, class Leaf, class Combine>
+class ForkJoin {
+public:
+    ForkJoin(ThreadPool& pool, size_t n, size_t grain, size_t phase, size_t step,
+             Leaf& leaf, Combine& combine)
+        : pool_(pool), n_(n), phase_(phase), step_(step), leaf_(leaf), combine_(combine) {
+        grain_ = grain ? grain : step;
+        depth_ = std::bit_width(pool.size()) + 3;
+    }
+
+    // Worker threads take part; any other thread hands the root to the pool,
+    // or runs it itself if the pool has shut down.
+    std::optional<T> execute() {
+        std::optional<T> out;
+        if (pool_.current_worker() >= 0) {
+            out = run(0, n_, depth_);
+        } else {
+            Piece root(this, 0, n_, depth_, -1);
+            if (pool_.submit(&root)) {
+                root.done.wait(false, std::memory_order_acquire);
+                // The worker may still be in notify_one(); root must outlive that.
+                while (!root.notified.load(std::memory_order_acquire)) std::this_thread::yield();
+                out = std::move(root.result);
+            } else {
+                out = run(0, n_, depth_);
+            }
+        }
+        if (error_) std::rethrow_exception(error_);
+        return out;
+    }
+
+private:
+    // A right half queued on the pool. Lives in the frame that pushed it,
+    // which does not return before `done` is set.
+    struct Piece : ThreadPool::Work {
+        Piece(ForkJoin* fj, size_t lo, size_t hi, int depth, int owner)
+            : fj(fj), lo(lo), hi(hi), depth(depth), owner(owner) {
+            execute = [](ThreadPool::Work* w) {
+                auto* p = static_cast<Piece*>(w);
+                ForkJoin& f = *p->fj;
+                // Stolen: the imbalance is here, so split afresh.
+                int d = f.pool_.current_worker() == p->owner ? p->depth : f.depth_;
+                p->result = f.run(p->lo, p->hi, d);
+                p->done.store(true, std::memory_order_release);
+                if (p->owner < 0) {   // the root, waited for off the pool
+                    p->done.notify_one();
+                    p->notified.store(true, std::memory_order_release);
+                }
+            };
+        }
+        ForkJoin* fj;
+        size_t lo, hi;
+        int depth, owner;
+        std::optional<T> result;
+        std::atomic<bool> done{false}, notified{false};
+    };
+
+    // Split point near the middle, rounded down (or up) to a boundary of
+    // `step_` elements; 0 if [lo, hi) should not be split.
+    size_t split_point(size_t lo, size_t hi) const {
+        if (hi - lo < 2 * grain_) return 0;
+        size_t mid = lo + (hi - lo) / 2;
+        if (step_ > 1) {
+            mid = (mid + phase_) / step_ * step_ - phase_;
+            if (mid <= lo) mid += step_;
+            if (mid >= hi) return 0;
+        }
+        return mid;
+    }
+
+    std::optional<T> run(size_t lo, size_t hi, int depth) {
+        if (failed_.load(std::memory_order_relaxed)) return std::nullopt;
+        size_t mid = depth > 0 ? split_point(lo, hi) : 0;
+        if (mid == 0) {
+            try {
+                return leaf_(lo, hi);
+            } catch (...) {
+                if (!failed_.exchange(true)) error_ = std::current_exception();
+                return std::nullopt;
+            }
+        }
+        Piece right(this, mid, hi, depth - 1, pool_.current_worker());
+        if (!pool_.submit(&right)) right.execute(&right);
+        std::optional<T> left = run(lo, mid, depth - 1);
+        while (!right.done.load(std::memory_order_acquire))
+            if (!pool_.run_one()) std::this_thread::yield();
+        if (!left) return std::move(right.result);
+        if (!right.result) return left;
+        return combine_(std::move(*left), std::move(*right.result));
+    }
+
+    ThreadPool& pool_;
+    size_t n_, grain_, phase_, step_;
+    int depth_;
+    Leaf& leaf_;
+    Combine& combine_;
+    std::atomic<bool> failed_{false};
+    std::exception_ptr error_;
+};
+
+// Cache-line alignment of split points for contiguous element storage:
+// boundaries at indices k with (phase + k) % step == 0.
+template<class I>
+std::pair<size_t, size_t> line_alignment(I first) {
+    if constexpr (std::contiguous_iterator<I>) {
+        using V = std::iter_value_t<I>;
+        if constexpr (sizeof(V) < kCacheLine && kCacheLine % sizeof(V) == 0) {
+            auto addr = reinterpret_cast<uintptr_t>(std::to_address(first));
+            if (addr % sizeof(V) == 0) {
+                size_t step = kCacheLine / sizeof(V);
+                return {(addr % kCacheLine) / sizeof(V), step};
+            }
+        }
+    }
+    return {0, 1};
+}
+
+template<class I, class T, class Leaf, class Combine>
+std::optional<T> fork_join(ThreadPool* pool, I first, size_t n, size_t grain,
+                           Leaf leaf, Combine combine) {
+    if (n == 0) return std::nullopt;
+    if (!pool) return leaf(0, n);
+    auto [phase, step] = line_alignment(first);
+    return ForkJoin<T, Leaf, Combine>(*pool, n, grain, phase, step, leaf, combine).execute();
+}
+
+template<class I, class Body>
+void parallel_for_on(ThreadPool* pool, I first, I last, Body& body, size_t grain) {
+    fork_join<I, bool>(pool, first, range_size(first, last), grain,
+        [&](size_t lo, size_t hi) -> bool {
+            for (size_t k = lo; k < hi; ++k) body(range_at(first, k));
+            return true;
+        },
+        [](bool, bool) { return true; });
+}
+
+// Every piece starts from `identity`; op(T, element) folds, combine(T, T) joins.
+template<class I, class T, class Op, class Combine>
+T parallel_reduce_on(ThreadPool* pool, I first, I last, T identity, Op& op, Combine& combine,
+                     size_t grain) {
+    auto r = fork_join<I, T>(pool, first, range_size(first, last), grain,
+        [&](size_t lo, size_t hi) -> T {
+            T acc = identity;
+            for (size_t k = lo; k < hi; ++k) acc = op(std::move(acc), range_at(first, k));
+            return acc;
+        },
+        [&](T a, T b) -> T { return combine(std::move(a), std::move(b)); });
+    return r ? std::move(*r) : std::move(identity);
+}
+
+// op(T, T) both folds elements (converted to T) and joins pieces; each piece
+// is seeded with its first element, and the total is folded into `init`.
+template<class I, class T, class Op>
+T parallel_reduce_seeded(ThreadPool* pool, I first, I last, T init, Op& op, size_t grain) {
+    auto r = fork_join<I, T>(pool, first, range_size(first, last), grain,
+        [&](size_t lo, size_t hi) -> T {
+            T acc = static_cast<T>(range_at(first, lo));
+            for (size_t k = lo + 1; k < hi; ++k) acc = op(std::move(acc), range_at(first, k));
+            return acc;
+        },
+        [&](T a, T b) -> T { return op(std::move(a), std::move(b)); });
+    return r ? op(std::move(init), std::move(*r)) : std::move(init);
+}
+
+}  // namespace detail
+
+template<detail::ParallelIndex I, class Body>
+void parallel_for(ThreadPool& pool, I first, I last, Body body, size_t grain = 0) {
+    detail::parallel_for_on(&pool, first, last, body, grain);
+}
+template<detail::ParallelIndex I, class Body>
+void parallel_for(I first, I last, Body body, size_t grain = 0) {
+    detail::parallel_for_on(ThreadPool::current(), first, last, body, grain);
+}
+template<std::ranges::random_access_range R, class Body>
+void parallel_for(R&& range, Body body, size_t grain = 0) {
+    detail::parallel_for_on(ThreadPool::current(), std::ranges::begin(range),
+                            std::ranges::end(range), body, grain);
+}
+
+// Like std::reduce: op must be associative; pieces are joined in order.
+template<detail::ParallelIndex I, class T, class Op>
+T parallel_reduce(ThreadPool& pool, I first, I last, T init, Op op, size_t grain = 0) {
+    return detail::parallel_reduce_seeded(&pool, first, last, std::move(init), op, grain);
+}
+template<detail::ParallelIndex I, class T, class Op>
+T parallel_reduce(I first, I last, T init, Op op, size_t grain = 0) {
+    return detail::parallel_reduce_seeded(ThreadPool::current(), first, last, std::move(init), op, grain);
+}
+template<std::ranges::random_access_range R, class T, class Op>
+T parallel_reduce(R&& range, T init, Op op, size_t grain = 0) {
+    return detail::parallel_reduce_seeded(ThreadPool::current(), std::ranges::begin(range),
+                                          std::ranges::end(range), std::move(init), op, grain);
+}
+
+// Map-and-join form: op(T, element) folds an element (an index for integral
+// ranges) into a partial that starts from `identity`; combine joins partials.
+template<detail::ParallelIndex I, class T, class Op, class Combine>
+    requires (!std::integral<std::remove_cvref_t<Combine>>)
+T parallel_reduce(I first, I last, T identity, Op op, Combine combine, size_t grain = 0) {
+    return detail::parallel_reduce_on(ThreadPool::current(), first, last, std::move(identity),
+                                      op, combine, grain);
+}
+template<std::ranges::random_access_range R, class T, class Op, class Combine>
+    requires (!std::integral<std::remove_cvref_t<Combine>>)
+T parallel_reduce(R&& range, T identity, Op op, Combine combine, size_t grain = 0) {
+    return detail::parallel_reduce_on(ThreadPool::current(), std::ranges::begin(range),
+                                      std::ranges::end(range), std::move(identity), op, combine, grain);
+}
+
+}  // namespace tf
@@ -0,0 +1,291 @@
+#pragma once
+#include "bounded_queue.hpp"
+#include "task.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tf {
+
+class Scheduler;
+
+// How a pipeline stage takes its items.
+//   serial_in_order      one at a time, in the order the source produced them
+//   serial_out_of_order  one at a time, as they arrive
+//   parallel             as many at once as the pool has workers
+enum class StageMode { serial_in_order, serial_out_of_order, parallel };
+
+template<class F>
+struct StageSpec {
+    StageMode mode;
+    F fn;
+};
+
+template<class F>
+StageSpec<std::decay_t<F>> stage(StageMode mode, F&& fn) {
+    return {mode, std::forward<F>(fn)};
+}
+
+namespace detail {
+
+template<class T>
+struct PipeItem {
+    uint64_t seq;   // position in the source's output
+    T value;
+};
+
+// The live-item limit keeps every queue within capacity, but a consumer that
+// has claimed a cell and not yet released it still blocks that cell, so a
+// push can briefly find the ring full.
+template<class T>
+void push_item(BoundedQueue<PipeItem<T>>& q, PipeItem<T>&& item) {
+    while (!q.try_push(std::move(item))) std::this_thread::yield();
+}
+
+// Untyped half of a pipeline: stage activation, the live-item limit, and
+// completion. Each stage is drained by "pumps", pool jobs that call step()
+// until it has nothing to do; a stage runs at most `limit` pumps at once.
+class PipelineCore {
+public:
+    struct Stage {
+        explicit Stage(StageMode mode) : mode(mode) {}
+        virtual ~Stage() = default;
+        // Handles one item; false if there was none to take.
+        virtual bool step() = 0;
+        virtual bool has_input() const = 0;
+
+        StageMode mode;
+        int limit = 1;
+        std::atomic<int> active{0};
+    };
+
+    explicit PipelineCore(size_t tokens) : tokens_(tokens ? tokens : 1) {}
+
+    size_t tokens() const { return tokens_; }
+    // Worker, from inside the task that runs the pipeline.
+    void start(Scheduler& s);
+
+    // Starts a pump for stage k unless it already runs `limit` of them.
+    // Callers that just queued an item for k use pushed(k).
+    void wake(size_t k);
+    void pushed(size_t k) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wake(k);
+    }
+    // Source only: admits one more live item; false at the limit.
+    bool claim();
+    bool has_tokens() const { return live_.load(std::memory_order_relaxed) < tokens_; }
+    // An item left the pipeline, consumed by the last stage or dropped.
+    void retire();
+    // The source has nothing more to produce.
+    void exhaust();
+    bool exhausted() const { return exhausted_.load(std::memory_order_relaxed); }
+    // Keeps the first exception; every stage then drops its items.
+    void fail(std::exception_ptr e);
+    bool failed() const { return failed_.load(std::memory_order_relaxed); }
+
+    std::vector<std::unique_ptr<Stage>> stages;
+
+private:
+    void pump(size_t k);
+    void finish_once();
+    // Pumps and the running pipeline each hold a ref; the last one out
+    // completes the task.
+    void release();
+
+    const size_t tokens_;
+    std::atomic<size_t> live_{0};
+    std::atomic<size_t> refs_{0};
+    std::atomic<bool> exhausted_{false}, failed_{false}, finished_{false};
+    std::exception_ptr error_;
+    ThreadPool* pool_ = nullptr;
+    Scheduler* sched_ = nullptr;
+    ScheduledTask* task_ = nullptr;
+    TaskHandle self_;
+};
+
+template<class T, class F>
+class SourceStage : public PipelineCore::Stage {
+public:
+    SourceStage(PipelineCore& core, F fn)
+        : Stage(StageMode::serial_in_order), core_(core), fn_(std::move(fn)), out_(core.tokens()) {}
+
+    BoundedQueue<PipeItem<T>>& output() { return out_; }
+
+    bool step() override {
+        if (core_.failed()) core_.exhaust();
+        if (core_.exhausted() || !core_.claim()) return false;
+        std::optional<T> v;
+        try {
+            v = fn_();
+        } catch (...) {
+            core_.fail(std::current_exception());
+        }
+        if (!v) {
+            core_.exhaust();
+            core_.retire();
+            return false;
+        }
+        push_item(out_, {seq_++, std::move(*v)});
+        core_.pushed(1);
+        return true;
+    }
+
+    bool has_input() const override {
+        return !core_.exhausted() && !core_.failed() && core_.has_tokens();
+    }
+
+private:
+    PipelineCore& core_;
+    F fn_;
+    BoundedQueue<PipeItem<T>> out_;
+    uint64_t seq_ = 0;
+};
+
+template<class In, class Out, class F, bool Last>
+class FnStage : public PipelineCore::Stage {
+    using OutQueue = BoundedQueue<PipeItem<std::conditional_t<Last, char, Out>>>;
+
+public:
+    FnStage(PipelineCore& core, size_t index, StageMode mode, F fn, BoundedQueue<PipeItem<In>>& in)
+        : Stage(mode), core_(core), index_(index), fn_(std::move(fn)), in_(in) {
+        if constexpr (!Last) out_ = std::make_unique<OutQueue>(core.tokens());
+        if (mode == StageMode::serial_in_order) reorder_.resize(in.capacity());
+    }
+
+    OutQueue& output() { return *out_; }
+
+    bool step() override {
+        auto item = next_input();
+        if (!item) return false;
+        if (core_.failed()) {
+            core_.retire();
+            return true;
+        }
+        try {
+            if constexpr (Last) {
+                fn_(std::move(item->value));
+                core_.retire();
+            } else {
+                push_item(*out_, {item->seq, fn_(std::move(item->value))});
+                core_.pushed(index_ + 1);
+            }
+        } catch (...) {
+            core_.fail(std::current_exception());
+            core_.retire();
+        }
+        return true;
+    }
+
+    bool has_input() const override {
+        return !in_.empty() || (core_.failed() && buffered_.load(std::memory_order_relaxed) != 0);
+    }
+
+private:
+    // In-order stages park early arrivals in a ring indexed by sequence
+    // number. Every item between `next_` and a parked one is still live, so
+    // they span fewer than `tokens` numbers and never collide.
+    std::optional<PipeItem<In>> next_input() {
+        if (mode != StageMode::serial_in_order) return in_.try_pop();
+        if (core_.failed()) {
+            if (auto x = in_.try_pop()) return x;
+            if (buffered_.load(std::memory_order_relaxed) == 0) return std::nullopt;
+            for (auto& slot : reorder_)
+                if (slot) return take(slot);
+            return std::nullopt;
+        }
+        const size_t mask = reorder_.size() - 1;
+        while (true) {
+            if (auto& slot = reorder_[next_ & mask]) {
+                ++next_;
+                return take(slot);
+            }
+            auto x = in_.try_pop();
+            if (!x) return std::nullopt;
+            if (x->seq == next_) {
+                ++next_;
+                return x;
+            }
+            reorder_[x->seq & mask] = std::move(x);
+            buffered_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::optional<PipeItem<In>> take(std::optional<PipeItem<In>>& slot) {
+        auto x = std::move(slot);
+        slot.reset();
+        buffered_.fetch_sub(1, std::memory_order_relaxed);
+        return x;
+    }
+
+    PipelineCore& core_;
+    size_t index_;
+    F fn_;
+    BoundedQueue<PipeItem<In>>& in_;
+    std::unique_ptr<OutQueue> out_;
+    std::vector<std::optional<PipeItem<In>>> reorder_;
+    uint64_t next_ = 0;
+    std::atomic<size_t> buffered_{0};
+};
+
+template<class In, class F, class... Rest>
+void add_stages(PipelineCore& core, BoundedQueue<PipeItem<In>>& in, StageSpec<F> spec,
+                StageSpec<Rest>... rest) {
+    constexpr bool last = sizeof...(Rest) == 0;
+    using Out = std::invoke_result_t<F&, In&&>;
+    static_assert(last || !std::is_void_v<Out>, "only the last pipeline stage may return void");
+    auto st = std::make_unique<FnStage<In, Out, F, last>>(core, core.stages.size(), spec.mode,
+                                                          std::move(spec.fn), in);
+    auto* raw = st.get();
+    core.stages.push_back(std::move(st));
+    if constexpr (!last) add_stages<Out>(core, raw->output(), std::move(rest)...);
+}
+
+}  // namespace detail
+
+// A streaming pipeline: a source producing items one at a time, followed by
+// stages connected by bounded lock-free queues. Items stream through every
+// stage concurrently on the scheduler's pool. At most `tokens` items are
+// alive at once, so memory stays fixed however long the source runs; when
+// a downstream stage falls behind, the queues ahead of it fill and the
+// source waits (backpressure). Run it with Scheduler::submit; one run per
+// Pipeline.
+class Pipeline {
+public:
+    Pipeline(Pipeline&&) noexcept = default;
+    Pipeline& operator=(Pipeline&&) noexcept = default;
+
+    size_t tokens() const { return core_->tokens(); }
+    size_t stage_count() const { return core_->stages.size(); }
+
+private:
+    friend class Scheduler;
+    template<class Src, class... Fs>
+    friend Pipeline make_pipeline(size_t tokens, Src source, StageSpec<Fs>... stages);
+    explicit Pipeline(std::unique_ptr<detail::PipelineCore> core) : core_(std::move(core)) {}
+
+    std::unique_ptr<detail::PipelineCore> core_;
+};
+
+// `source` returns std::optional<T>, std::nullopt once exhausted, and is
+// called serially. Each stage takes the previous stage's output; the last
+// one's result, if any, is discarded.
+template<class Src, class... Fs>
+Pipeline make_pipeline(size_t tokens, Src source, StageSpec<Fs>... stages) {
+    static_assert(sizeof...(Fs) > 0, "a pipeline needs at least one stage after the source");
+    using T = typename std::invoke_result_t<Src&>::value_type;
+    auto core = std::make_unique<detail::PipelineCore>(tokens);
+    auto src = std::make_unique<detail::SourceStage<T, Src>>(*core, std::move(source));
+    auto* raw = src.get();
+    core->stages.push_back(std::move(src));
+    detail::add_stages<T>(*core, raw->output(), std::move(stages)...);
+    return Pipeline(std::move(core));
+}
+
+}  // namespace tf
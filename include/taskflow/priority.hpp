@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+namespace tf {
+
+// Dispatch class. A ready task of a higher class starts before any ready task
+// of a lower one, except that waiting work is promoted one class per aging
+// step (ThreadPool::set_aging) so low-priority work cannot starve.
+enum class Priority : uint8_t { high = 0, normal = 1, low = 2 };
+
+}  // namespace tf
@@ -0,0 +1,50 @@
+#pragma once
+#include "thread_pool.hpp"
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+namespace tf {
+
+// Admission limits shared by a set of tasks, attached with TaskOptions::group.
+// At most `max_in_flight` of them run at once (0: no limit), and with a rate
+// their starts are also paced by a token bucket that refills `per_second`
+// tokens up to `burst`; each start takes one. A task that cannot start yet
+// waits in the scheduler, not on a worker: in FIFO order for a free slot, or
+// on the timer heap until its token is due. A group serves one scheduler.
+class ResourceGroup {
+public:
+    explicit ResourceGroup(size_t max_in_flight, double per_second = 0, double burst = 1);
+    ResourceGroup(const ResourceGroup&) = delete;
+    ResourceGroup& operator=(const ResourceGroup&) = delete;
+
+    size_t max_in_flight() const { return max_; }
+    size_t in_flight() const;
+    // Tasks queued for a slot (not counting those waiting for a token).
+    size_t waiting() const;
+
+private:
+    friend class Scheduler;
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    // Takes a slot and a token for w and returns true. Otherwise w is queued
+    // for a slot (retry == max) or has to come back at `retry`.
+    bool acquire(ThreadPool::Work* w, TimePoint now, TimePoint& retry);
+    // Gives a slot back. Returns the queued task that is next in line, if
+    // any: it holds the slot if retry == max, else it has to come back then.
+    ThreadPool::Work* release(TimePoint now, TimePoint& retry);
+    // Forgets a queued task that will never run; false if it was not queued.
+    bool drop(ThreadPool::Work* w);
+    bool take_token(TimePoint now, TimePoint& retry);   // requires mtx_
+
+    const size_t max_;
+    const double rate_, burst_;
+    mutable std::mutex mtx_;
+    size_t in_flight_ = 0;
+    double tokens_;
+    TimePoint refilled_;
+    std::deque<ThreadPool::Work*> waiting_;
+};
+
+}  // namespace tf
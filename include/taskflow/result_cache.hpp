@@ -0,0 +1,132 @@
+#pragma once
+#include "task.hpp"
+#include "unique_function.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace tf {
+
+class TaskGraph;
+
+// 128-bit content hash naming a cached result. Not cryptographic: it guards
+// against accidental collisions, not against crafted inputs.
+struct CacheKey {
+    uint64_t hi = 0, lo = 0;
+
+    bool operator==(const CacheKey&) const = default;
+    explicit operator bool() const { return hi || lo; }
+    std::string hex() const;
+};
+
+// Incremental CacheKey builder.
+class KeyHasher {
+public:
+    KeyHasher& update(std::string_view bytes);
+    KeyHasher& update(const CacheKey& k);
+    CacheKey finish() const;
+
+private:
+    void mix(uint64_t word);
+
+    uint64_t a_ = 0x9e3779b97f4a7c15ull, b_ = 0xc2b2ae3d27d4eb4full;
+    uint64_t tail_ = 0;
+    size_t len_ = 0;
+};
+
+CacheKey content_hash(std::string_view bytes);
+// Hash of a file's contents; throws std::system_error if it cannot be read.
+CacheKey file_hash(const std::filesystem::path& path);
+
+// Immutable bytes of a cached result: held in memory or mapped from the
+// cache directory. Copies share the storage.
+class CacheBlob {
+public:
+    CacheBlob() = default;
+    explicit CacheBlob(std::string bytes);
+
+    std::string_view bytes() const { return {data_, size_}; }
+    size_t size() const { return size_; }
+
+private:
+    friend class ResultCache;
+    CacheBlob(std::shared_ptr<const void> owner, const char* data, size_t size)
+        : owner_(std::move(owner)), data_(data), size_(size) {}
+
+    std::shared_ptr<const void> owner_;
+    const char* data_ = "";
+    size_t size_ = 0;
+};
+
+// A cached node's outputs, one per cached predecessor, in node id order.
+using CacheInputs = std::span<const CacheBlob>;
+using CachedTask = UniqueFunction<std::string(CacheInputs)>;
+
+// What Scheduler::submit(TaskGraph&&, ResultCache&) did, indexed by NodeId.
+struct CachedRun {
+    std::vector<TaskHandle> handles;
+    std::vector<CacheKey> keys;   // zero for nodes added without a key
+    std::vector<bool> hits;       // served from the cache; their task ran nothing
+    size_t executed() const;      // cached nodes that had to run
+};
+
+// Content-addressed store of task results for incremental re-execution (see
+// TaskGraph::add_cached). Results live in an LRU bounded by `memory_bytes`
+// and, given a directory, in one file per key there; files are mapped, not
+// read, and outlive the process, so a later run picks them up. Thread-safe.
+class ResultCache {
+public:
+    explicit ResultCache(size_t memory_bytes = size_t{256} << 20, std::filesystem::path dir = {});
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    // Memory first, then disk; a disk hit is mapped and kept in memory.
+    std::optional<CacheBlob> get(const CacheKey& key);
+    // Without loading anything.
+    bool contains(const CacheKey& key) const;
+    // Stores under key (replacing any previous value) and returns the blob.
+    // A failed disk write leaves the result in memory only.
+    CacheBlob put(const CacheKey& key, std::string bytes);
+
+    struct Stats {
+        size_t hits = 0, disk_hits = 0, misses = 0, evictions = 0;
+        size_t memory_bytes = 0;   // currently held in the LRU
+    };
+    Stats stats() const;
+
+private:
+    friend class Scheduler;
+    friend class CompiledGraph;
+
+    struct KeyHash {
+        size_t operator()(const CacheKey& k) const { return static_cast<size_t>(k.lo); }
+    };
+    using Lru = std::list<std::pair<CacheKey, CacheBlob>>;
+
+    // Keys every cached node of g, probes the cache (or nothing, if cache is
+    // null) and turns each cached node into a plain task: a no-op for hits,
+    // else one that feeds its predecessors' outputs to the callable and
+    // stores the result. Throws std::invalid_argument on a cycle.
+    static CachedRun bind(TaskGraph& g, ResultCache* cache);
+
+    std::filesystem::path file(const CacheKey& key) const;
+    void remember(const CacheKey& key, CacheBlob blob);   // requires mtx_
+
+    const size_t capacity_;
+    const std::filesystem::path dir_;
+    mutable std::mutex mtx_;
+    Lru lru_;   // most recent first
+    std::unordered_map<CacheKey, Lru::iterator, KeyHash> index_;
+    Stats stats_;
+};
+
+}  // namespace tf
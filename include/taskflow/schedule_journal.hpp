@@ -0,0 +1,101 @@
+#pragma once
+#include "task.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+namespace tf {
+
+class Scheduler;
+
+// What ScheduleJournal::recover does about runs that fell due while the
+// process was down.
+enum class Catchup {
+    skip,   // resume at the next regular time; overdue one-shots are dropped
+    once,   // one run now however many were missed, then the regular schedule
+    all,    // every missed run now, back to back, up to max_catchup
+};
+
+struct JournalOptions {
+    Catchup catchup = Catchup::once;
+    size_t max_catchup = 64;
+    // Rewrite the journal with only the live jobs once it is this long and
+    // more than half of it is superseded. Zero leaves it to compact().
+    size_t compact_bytes = size_t{64} << 20;
+};
+
+struct RecoveryStats {
+    size_t jobs = 0;        // live jobs in the journal
+    size_t scheduled = 0;   // handed to the scheduler
+    size_t unbound = 0;     // no callable bound under their name; kept for later
+    size_t missed = 0;      // had at least one run fall due while down
+    size_t torn_bytes = 0;  // incomplete record at the tail, discarded
+};
+
+// Persistent schedule: one-shot, interval and cron jobs registered through
+// the journal are appended to a memory-mapped file along with each run's
+// next due time, so a restarted process gets them all back with recover()
+// instead of registering them again. Records hold cron schedules compiled
+// and times absolute (wall clock), so recovery parses nothing and computes
+// next times only for jobs that missed a run.
+//
+// Jobs name their code rather than carrying it: bind() each name to a
+// callable before recover(). The file only grows, with superseded records
+// dropped by compaction; a record cut short by a crash is discarded on the
+// next open. Writes reach the page cache at once and the disk on sync().
+//
+// Thread-safe. The jobs keep running in the scheduler if the journal is
+// destroyed first, and keep journaling their runs until it stops.
+class ScheduleJournal {
+public:
+    using SystemTime = std::chrono::system_clock::time_point;
+    using JobId = uint64_t;
+
+    // Opens or creates `file`. Throws std::system_error if it cannot be
+    // mapped, std::runtime_error if it is not a journal.
+    ScheduleJournal(Scheduler& s, std::filesystem::path file, JournalOptions opts = {});
+    ~ScheduleJournal();
+    ScheduleJournal(const ScheduleJournal&) = delete;
+    ScheduleJournal& operator=(const ScheduleJournal&) = delete;
+
+    // Binds `name` to code. Bind every name before recover() or scheduling
+    // under it; a name in use cannot be rebound.
+    void bind(std::string name, Task fn);
+
+    // Schedules every live job in the journal whose name is bound, applying
+    // the catch-up policy to runs missed in the meantime. Missed runs are
+    // made up at least once: a crash before a job's next regular run makes
+    // them up again. Jobs left unbound are tried again by a later call.
+    RecoveryStats recover();
+
+    // Journaled counterparts of the Scheduler calls. Throw
+    // std::invalid_argument for an unbound name or a bad cron expression.
+    // opts.priority, deadline and recurrence are journaled; opts.group is
+    // used but not journaled.
+    JobId schedule_once(const std::string& name, SystemTime when, const TaskOptions& opts = {});
+    JobId schedule_every(const std::string& name, Duration interval, const TaskOptions& opts = {});
+    JobId schedule_recurring(const std::string& name, const std::string& cron, const TaskOptions& opts = {});
+
+    // Removes the job from the journal and cancels its task in the
+    // scheduler; it runs no more. False if unknown or already finished.
+    bool cancel(JobId id);
+    // The job's task in the scheduler; invalid if it is not scheduled.
+    TaskHandle handle(JobId id) const;
+
+    size_t size() const;    // live jobs
+    size_t bytes() const;   // journal length in use
+    void compact();
+    void sync();            // msync: durable once this returns
+
+private:
+    struct State;
+    // Gives st its code and options the way the Scheduler calls would.
+    static TaskHandle launch(Scheduler& s, ScheduledTask&& st, Task fn, const TaskOptions& opts);
+
+    std::shared_ptr<State> st_;   // shared with the scheduled jobs
+};
+
+}  // namespace tf
@@ -1,12 +1,22 @@
 #pragma once
 #include "task.hpp"
+#include "task_future.hpp"
+#include "io_executor.hpp"
+#include "coroutine.hpp"
+#include "parallel.hpp"
+#include "pipeline.hpp"
+#include "resource_group.hpp"
+#include "result_cache.hpp"
+#include "schedule_journal.hpp"
+#include "task_graph.hpp"
+#include "compiled_graph.hpp"
 #include "thread_pool.hpp"
 #include "cron_parser.hpp"
+#include "instrumentation.hpp"
+#include <iosfwd>
 #include <memory>
 #include <vector>
 #include <atomic>
-#include <future>
-#include <any>
 #include <sstream>
 #include <iomanip>
 #include <type_traits>
@@ -16,29 +26,135 @@ namespace tf {
 class Scheduler {
 public:
     Scheduler(size_t threads = std::thread::hardware_concurrency());
+    // Pool layout: pinning and NUMA grouping of the workers.
+    explicit Scheduler(const PoolOptions& pool);
     ~Scheduler();
 
     void start();
     void stop();
     void wait();
 
-    // one-time
+    // one-time; opts sets the priority class and deadline (see TaskOptions)
     TaskHandle schedule_once(const std::string& iso, Task task,
-                            const std::vector<TaskHandle>& deps = {});
+                            const std::vector<TaskHandle>& deps = {}, const TaskOptions& opts = {});
     TaskHandle schedule_once(TimePoint tp, Task task,
-                            const std::vector<TaskHandle>& deps = {});
+                            const std::vector<TaskHandle>& deps = {}, const TaskOptions& opts = {});
+    // move-only callables; lambdas with small captures are stored inline
+    TaskHandle schedule_once(TimePoint tp, UniqueTask task,
+                            const std::vector<TaskHandle>& deps = {}, const TaskOptions& opts = {});
+    template<class F, class = std::enable_if_t<std::is_invocable_v<std::decay_t<F>&>>>
+    auto schedule_once(TimePoint tp, F&& f,
+                       const std::vector<TaskHandle>& deps = {}, const TaskOptions& opts = {})
+        -> ScheduleResult<std::invoke_result_t<std::decay_t<F>&>> {
+        using R = std::invoke_result_t<std::decay_t<F>&>;
+        if constexpr (std::is_void_v<R>) {
+            return schedule_once(tp, UniqueTask(std::forward<F>(f)), deps, opts);
+        } else {
+            return schedule_future<R>(tp, std::forward<F>(f), deps, opts);
+        }
+    }
+
+    // Runs f once every upstream future is ready, passing their values as
+    // arguments. An upstream exception propagates to the returned future.
+    template<class F, class... Rs>
+    auto then(F f, TaskFuture<Rs>... ups)
+        -> TaskFuture<std::invoke_result_t<F&, const Rs&...>> {
+        static_assert(sizeof...(Rs) > 0 && (!std::is_void_v<Rs> && ...),
+                      "then() needs value-producing upstream futures");
+        using R = std::invoke_result_t<F&, const Rs&...>;
+        std::vector<TaskHandle> deps{ups.handle()...};
+        return schedule_future<R>(Clock::now(),
+            [f = std::move(f), ups...]() mutable -> R { return f(ups.get()...); }, deps);
+    }
+
+    // Starts co on the pool as a one-shot task that finishes when the
+    // coroutine returns, so dependents, wait_for and the returned future see
+    // the coroutine's result rather than its first suspension.
+    template<class T>
+    ScheduleResult<T> spawn(Co<T> co, const std::vector<TaskHandle>& deps = {},
+                            const TaskOptions& opts = {}) {
+        auto& p = co.h_.promise();
+        p.sched = this;
+        p.opts = opts;
+        p.root = co.h_;
+        ScheduledTask st;
+        st.func = typename Co<T>::Start(std::exchange(co.h_, nullptr));
+        st.next_run = Clock::now();
+        st.dependencies = deps;
+        st.apply(opts);
+        if constexpr (std::is_void_v<T>) {
+            return create_task(std::move(st));
+        } else {
+            auto [h, t] = create_pinned(std::move(st));
+            return TaskFuture<T>(*this, h, t);
+        }
+    }
+    // co_await these inside a Co to suspend without holding a worker.
+    SleepAwaiter sleep(Duration d) { return {this, Clock::now() + d}; }
+    SleepAwaiter sleep_until(TimePoint tp) { return {this, tp}; }
+
+    // Data-parallel stages as tasks (see parallel.hpp): the handle finishes
+    // once the whole range is done, so ordinary tasks can precede it through
+    // deps and follow it by depending on the handle. The range is captured
+    // by value; iterators must stay valid until the stage has run.
+    template<detail::ParallelIndex I, class Body>
+    TaskHandle parallel_for(I first, I last, Body body, const std::vector<TaskHandle>& deps = {},
+                            const TaskOptions& opts = {}) {
+        return schedule_once(Clock::now(), UniqueTask([first, last, body = std::move(body)]() mutable {
+            tf::parallel_for(first, last, std::move(body));
+        }), deps, opts);
+    }
+    template<detail::ParallelIndex I, class T, class Op>
+    TaskFuture<T> parallel_reduce(I first, I last, T init, Op op,
+                                  const std::vector<TaskHandle>& deps = {}, const TaskOptions& opts = {}) {
+        return schedule_future<T>(Clock::now(), [first, last, init = std::move(init), op = std::move(op)]() mutable {
+            return tf::parallel_reduce(first, last, std::move(init), std::move(op));
+        }, deps, opts);
+    }
 
-    // recurring
+    // whole DAG in one batch; handles are indexed by TaskGraph::NodeId.
+    // Throws std::invalid_argument if the graph has a cycle.
+    std::vector<TaskHandle> submit(TaskGraph&& graph, TimePoint start = Clock::now());
+    // The same, skipping add_cached nodes whose result `cache` already holds
+    // and storing the results of those that run.
+    CachedRun submit(TaskGraph&& graph, ResultCache& cache, TimePoint start = Clock::now());
+    // Streams the pipeline on the pool as one task: it starts once deps are
+    // done and finishes when the source is exhausted and every item has left
+    // the last stage. The first exception from the source or a stage stops
+    // the pipeline and is rethrown by the future.
+    TaskFuture<void> submit(Pipeline&& pipeline, const std::vector<TaskHandle>& deps = {},
+                            const TaskOptions& opts = {});
+
+    // compiled graphs: execute on the pool and block until every node ran
+    void run(CompiledGraph& graph);
+    void run_n(CompiledGraph& graph, size_t n);
+
+    // recurring; opts.recurrence picks fixed-delay or fixed-rate timing, the
+    // misfire policy and how many runs may overlap (see Recurrence)
     TaskHandle schedule_recurring(const std::string& cron, Task task,
-                                 const std::vector<TaskHandle>& deps = {});
+                                 const std::vector<TaskHandle>& deps = {}, const TaskOptions& opts = {});
     TaskHandle schedule_every(Duration d, Task task,
-                             const std::vector<TaskHandle>& deps = {});
+                             const std::vector<TaskHandle>& deps = {}, const TaskOptions& opts = {});
+
+    // Ready work is promoted one priority class for every `step` it waits
+    // for a worker (default 50ms), so low-priority tasks cannot starve.
+    void set_priority_aging(Duration step);
+
+    // Critical-path ordering (on by default). Named TaskGraph nodes keep a
+    // run-time average per name; on submit every node is ranked by the
+    // longest estimated path from it to the end of its graph, and among
+    // nodes that become ready together the higher rank starts first.
+    void set_critical_path(bool enabled);
+    // Current estimate for tasks named `name`, zero before the first run.
+    // set_cost_estimate seeds it, e.g. with figures saved from an earlier run.
+    Duration cost_estimate(const std::string& name) const;
+    void set_cost_estimate(const std::string& name, Duration d);
 
     // result-bearing
     template<class F>
     auto schedule_once(const std::string& iso, F f,
-                       const std::vector<TaskHandle>& deps = {})
-        -> TaskHandle {
+                       const std::vector<TaskHandle>& deps = {}, const TaskOptions& opts = {})
+        -> ScheduleResult<decltype(f())> {
         std::tm tm{}; 
         std::istringstream ss(iso);
         ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
@@ -50,23 +166,71 @@ public:
         auto duration_from_now = tp - system_now;
         auto steady_target = steady_now + duration_from_now;
         
-        using R = decltype(f());
-        if constexpr (std::is_void_v<R>) {
-            Task task = [f = std::move(f)]() mutable { f(); };
-            return schedule_once(steady_target, task, deps);
-        } else {
-            // For non-void return types, we'd need to handle result storage
-            Task task = [f = std::move(f)]() mutable { f(); };
-            return schedule_once(steady_target, task, deps);
-        }
+        return schedule_once(steady_target, std::move(f), deps, opts);
     }
 
     void wait_for(TaskHandle h);
-    template<class T = void>
-    T get_result(TaskHandle h);
+    // Cancels h and everything downstream of it that has not started: those
+    // tasks never run, and their waiters complete at once with
+    // TaskStatus::canceled (TaskFuture::get() throws TaskCanceled). Dependents
+    // marked always_run still run. A running task is only asked to stop,
+    // through its CancelToken. False if h has already finished or been
+    // canceled. A task that fails or times out prunes its dependents the
+    // same way.
+    bool cancel(TaskHandle h);
+    // Tasks currently holding a slot: pending, running, or recurring.
+    size_t task_count() const;
+
+    // Aggregate counters and latency histograms, summed over workers at the
+    // time of the call. Counters and histograms stay zero (enabled == false)
+    // unless built with TASKFLOW_ENABLE_INSTRUMENTATION.
+    SchedulerMetrics metrics() const;
+    // Records every task run into a per-worker ring of the most recent
+    // `events_per_worker` runs. The capacity is fixed by the first call.
+    void start_trace(size_t events_per_worker = 1 << 16);
+    void stop_trace();
+    // Chrome trace-event JSON (chrome://tracing, Perfetto): one slice per task
+    // run on its worker's track, with flow arrows from the dependency that
+    // released it. Best called while idle; runs recorded concurrently may be
+    // missing.
+    void write_trace(std::ostream& out) const;
+    // Waits for h and copies out its result. Throws std::runtime_error if h
+    // was already reclaimed; prefer holding the TaskFuture instead.
+    template<class T>
+    T get_result(TaskHandle h) {
+        ScheduledTask* t = detail::pin_task(*this, h);
+        if (!t) throw std::runtime_error("bad handle");
+        TaskFuture<T> f(*this, h, t);
+        if constexpr (std::is_void_v<T>) f.get();
+        else return f.get();
+    }
 
 private:
+    friend class IoExecutor;
+    friend class ScheduleJournal;
+    friend ScheduledTask* detail::pin_task(Scheduler&, TaskHandle);
+    friend void detail::unpin_task(Scheduler&, TaskHandle);
+    friend TaskHandle detail::detach_current();
+    friend void detail::complete_detached(Scheduler&, TaskHandle);
+
     TaskHandle create_task(ScheduledTask&& st);
+    void set_recurring(ScheduledTask& st, Task t, const TaskOptions& o);
+    // Inserts st with one pin already held for the caller.
+    std::pair<TaskHandle, ScheduledTask*> create_pinned(ScheduledTask&& st);
+
+    template<class R, class F>
+    TaskFuture<R> schedule_future(TimePoint tp, F&& f, const std::vector<TaskHandle>& deps,
+                                  const TaskOptions& opts = {}) {
+        ScheduledTask st;
+        st.func = [f = std::forward<F>(f)]() mutable {
+            ScheduledTask::current()->result.template emplace<R>(f());
+        };
+        st.next_run = tp;
+        st.dependencies = deps;
+        st.apply(opts);
+        auto [h, t] = create_pinned(std::move(st));
+        return TaskFuture<R>(*this, h, t);
+    }
     void run_loop();
 
     struct Impl;
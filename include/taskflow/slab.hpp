@@ -0,0 +1,155 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace tf {
+
+// Chunked object pool with stable addresses and per-slot generation counters.
+// Objects never move once constructed, so a pointer obtained from get() stays
+// valid until that slot is released. Chunks are allocated on demand and never
+// freed, which keeps lookups lock-free: the chunk directory is fixed-size.
+//
+// allocate() is lock-free and may run on any number of threads at once.
+// release() must be serialized by the caller, but may overlap allocate();
+// get()/generation() may run concurrently with both.
+template<class T, uint32_t ChunkBits = 12, uint32_t DirBits = 12>
+class Slab {
+public:
+    static constexpr uint32_t kChunkSize = 1u << ChunkBits;
+    static constexpr uint32_t kMaxChunks = 1u << DirBits;
+    static constexpr uint64_t kCapacity = uint64_t(kChunkSize) * kMaxChunks;
+
+    Slab() = default;
+    Slab(const Slab&) = delete;
+    Slab& operator=(const Slab&) = delete;
+
+    ~Slab() {
+        for (auto& d : dir_) {
+            Chunk* ch = d.load(std::memory_order_relaxed);
+            if (!ch) continue;
+            for (auto& e : ch->entries) if (e.live) e.ptr()->~T();
+            delete ch;
+        }
+    }
+
+    // Constructs a T in a free slot; returns {slot, generation}.
+    template<class... Args>
+    std::pair<uint32_t, uint32_t> allocate(Args&&... args) {
+        uint32_t slot;
+        if (!pop_free(slot)) {
+            uint64_t s = next_.fetch_add(1, std::memory_order_relaxed);
+            if (s >= kCapacity) throw std::length_error("Slab: capacity exhausted");
+            slot = static_cast<uint32_t>(s);
+            ensure_chunk(slot >> ChunkBits);
+        }
+        Entry& e = entry(slot);
+        new (e.storage) T(std::forward<Args>(args)...);
+        e.live = true;
+        live_.fetch_add(1, std::memory_order_relaxed);
+        return {slot, e.generation.load(std::memory_order_relaxed)};
+    }
+
+    // Destroys the object and bumps the generation so outstanding handles go stale.
+    void release(uint32_t slot) {
+        Entry& e = entry(slot);
+        e.generation.fetch_add(1, std::memory_order_release);
+        e.ptr()->~T();
+        e.live = false;
+        live_.fetch_sub(1, std::memory_order_relaxed);
+        push_free(slot);
+    }
+
+    // Object at `slot` if its generation still matches, nullptr otherwise.
+    T* get(uint32_t slot, uint32_t generation) {
+        if ((slot >> ChunkBits) >= kMaxChunks) return nullptr;
+        Chunk* ch = dir_[slot >> ChunkBits].load(std::memory_order_acquire);
+        if (!ch) return nullptr;
+        Entry& e = ch->entries[slot & (kChunkSize - 1)];
+        if (e.generation.load(std::memory_order_acquire) != generation) return nullptr;
+        return e.ptr();
+    }
+
+    // Unchecked; the caller knows the slot is live.
+    T& operator[](uint32_t slot) { return *entry(slot).ptr(); }
+
+    // Not safe against concurrent allocate()/release().
+    template<class Fn>
+    void for_each(Fn fn) {
+        for (auto& d : dir_) {
+            Chunk* ch = d.load(std::memory_order_acquire);
+            if (!ch) continue;
+            for (auto& e : ch->entries) if (e.live) fn(*e.ptr());
+        }
+    }
+
+    size_t live() const { return live_.load(std::memory_order_relaxed); }
+    size_t capacity() const { return size_t(chunk_count_.load(std::memory_order_relaxed)) * kChunkSize; }
+
+private:
+    struct Entry {
+        alignas(T) unsigned char storage[sizeof(T)];
+        std::atomic<uint32_t> generation{1};
+        std::atomic<uint32_t> next_free{0};   // free-list link, slot + 1 (0 ends the list)
+        bool live = false;
+        T* ptr() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+    struct Chunk { std::array<Entry, kChunkSize> entries; };
+
+    Entry& entry(uint32_t slot) {
+        Chunk* ch = dir_[slot >> ChunkBits].load(std::memory_order_acquire);
+        return ch->entries[slot & (kChunkSize - 1)];
+    }
+
+    // Racing allocators may both build the chunk; the loser frees its copy.
+    void ensure_chunk(uint32_t c) {
+        if (dir_[c].load(std::memory_order_acquire)) return;
+        auto* ch = new Chunk;
+        Chunk* expected = nullptr;
+        if (dir_[c].compare_exchange_strong(expected, ch, std::memory_order_acq_rel))
+            chunk_count_.fetch_add(1, std::memory_order_relaxed);
+        else
+            delete ch;
+    }
+
+    // Treiber stack of free slots. The head packs a modification tag (high 32
+    // bits) with slot + 1 (low 32 bits), so a pop racing a pop/push/pop of the
+    // same slot fails its CAS instead of linking in a stale successor.
+    bool pop_free(uint32_t& slot) {
+        uint64_t head = free_head_.load(std::memory_order_acquire);
+        while (true) {
+            uint32_t top = static_cast<uint32_t>(head);
+            if (top == 0) return false;
+            uint32_t next = entry(top - 1).next_free.load(std::memory_order_relaxed);
+            uint64_t want = ((head >> 32) + 1) << 32 | next;
+            if (free_head_.compare_exchange_weak(head, want, std::memory_order_acquire,
+                                                 std::memory_order_acquire)) {
+                slot = top - 1;
+                return true;
+            }
+        }
+    }
+
+    void push_free(uint32_t slot) {
+        uint64_t head = free_head_.load(std::memory_order_relaxed);
+        while (true) {
+            entry(slot).next_free.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+            uint64_t want = ((head >> 32) + 1) << 32 | (uint64_t(slot) + 1);
+            if (free_head_.compare_exchange_weak(head, want, std::memory_order_release,
+                                                 std::memory_order_relaxed))
+                return;
+        }
+    }
+
+    std::array<std::atomic<Chunk*>, kMaxChunks> dir_{};
+    std::atomic<uint32_t> chunk_count_{0};
+    std::atomic<uint64_t> next_{0};
+    std::atomic<uint64_t> free_head_{0};
+    std::atomic<size_t> live_{0};
+};
+
+}  // namespace tf
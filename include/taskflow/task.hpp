@@ -1,80 +1,325 @@
 #pragma once
+#include "unique_function.hpp"
+#include "cron_parser.hpp"
+#include "priority.hpp"
 #include <functional>
 #include <chrono>
 #include <optional>
 #include <memory>
-#include <variant>
-#include <any>
 #include <atomic>
-#include <future>
+#include <exception>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <cstdint>
+#include <string>
+#include <vector>
 
 namespace tf {
 
+class ResourceGroup;
+
 using Task = std::function<void()>;
 using Clock = std::chrono::steady_clock;
 using TimePoint = Clock::time_point;
 using Duration = Clock::duration;
 
+// id packs the scheduler slot (low 32 bits, stored +1 so 0 stays invalid) and
+// the slot's generation (high 32 bits). A handle whose generation no longer
+// matches refers to a task that has finished and been reclaimed.
 struct TaskHandle {
     uint64_t id = 0;
     bool is_valid() const { return id != 0; }
     bool operator==(const TaskHandle& o) const { return id == o.id; }
+
+    uint32_t slot() const { return static_cast<uint32_t>(id) - 1; }
+    uint32_t generation() const { return static_cast<uint32_t>(id >> 32); }
+    static TaskHandle make(uint32_t slot, uint32_t generation) {
+        return TaskHandle{(uint64_t(generation) << 32) | (uint64_t(slot) + 1)};
+    }
 };
 
 template<typename T = void>
 using TaskWithResult = std::function<T()>;
 
+#ifndef TASKFLOW_RESULT_INLINE_BYTES
+#define TASKFLOW_RESULT_INLINE_BYTES 32
+#endif
+
+// Typed return value of a task, held in the task's own slot. Values up to
+// TASKFLOW_RESULT_INLINE_BYTES live in place; larger ones are boxed. The
+// stored type is tagged so a mismatched get<R>() throws instead of reading
+// garbage.
+class TaskResult {
+public:
+    TaskResult() = default;
+    TaskResult(const TaskResult&) = delete;
+    TaskResult& operator=(const TaskResult&) = delete;
+    ~TaskResult() { reset(); }
+
+    template<class R, class... A>
+    void emplace(A&&... args) {
+        reset();
+        if constexpr (fits<R>) {
+            new (buf_) R(std::forward<A>(args)...);
+            destroy_ = [](void* p) { static_cast<R*>(p)->~R(); };
+        } else {
+            *reinterpret_cast<R**>(buf_) = new R(std::forward<A>(args)...);
+            destroy_ = [](void* p) { delete *static_cast<R**>(p); };
+        }
+        tag_ = &type_tag<R>;
+    }
+
+    template<class R>
+    R& get() {
+        if (tag_ != &type_tag<R>) throw std::logic_error("TaskResult: no result of this type");
+        if constexpr (fits<R>) return *std::launder(reinterpret_cast<R*>(buf_));
+        else return **reinterpret_cast<R**>(buf_);
+    }
+
+    bool has_value() const { return tag_ != nullptr; }
+
+    void reset() {
+        if (destroy_) destroy_(buf_);
+        destroy_ = nullptr;
+        tag_ = nullptr;
+    }
+
+private:
+    template<class R> static constexpr char type_tag = 0;
+    template<class R> static constexpr bool fits =
+        sizeof(R) <= TASKFLOW_RESULT_INLINE_BYTES && alignof(R) <= alignof(std::max_align_t);
+
+    alignas(std::max_align_t) unsigned char buf_[TASKFLOW_RESULT_INLINE_BYTES];
+    void (*destroy_)(void*) = nullptr;
+    const void* tag_ = nullptr;
+};
+
+// How a task ended, as seen by its waiters.
+enum class TaskStatus : uint8_t {
+    pending,     // not finished yet
+    succeeded,
+    failed,      // it threw, or a dependency failed and it was pruned
+    canceled,    // Scheduler::cancel(), on it or a dependency
+    timed_out,   // TaskOptions::timeout ran out, on it or a dependency
+};
+
+// What TaskFuture::get() throws for a canceled or timed-out task, and what
+// CancelToken::throw_if_requested() throws to end a task cooperatively.
+class TaskCanceled : public std::runtime_error {
+public:
+    explicit TaskCanceled(TaskStatus why)
+        : std::runtime_error(why == TaskStatus::timed_out ? "task timed out" : "task canceled"), why_(why) {}
+    TaskStatus status() const noexcept { return why_; }
+
+private:
+    TaskStatus why_;
+};
+
+// How a recurring task is timed.
+enum class Rate : uint8_t {
+    fixed_delay,   // each run one interval after the previous one finished
+    fixed_rate,    // runs on the grid start + k * interval, however long each takes
+};
+
+// What a fixed-rate or cron task does about ticks that passed while its
+// previous run was still going (or the dispatcher was late).
+enum class Misfire : uint8_t {
+    skip,       // drop them and wait for the next tick
+    coalesce,   // one run now for all of them
+    catch_up,   // run the last Recurrence::catch_up of them back to back
+};
+
+struct Recurrence {
+    Rate rate = Rate::fixed_delay;   // cron tasks are always on their grid
+    Misfire misfire = Misfire::skip;
+    uint32_t catch_up = 1;
+    // Runs allowed in flight at once. Above one (fixed-rate and cron only),
+    // a tick that finds a run still going starts another, each run being a
+    // one-shot task of its own; the misfire policy applies once all are busy.
+    uint32_t max_concurrency = 1;
+};
+
+// Dispatch attributes accepted by the schedule_* calls.
+struct TaskOptions {
+    Priority priority = Priority::normal;
+    // Start-by budget counted from the scheduled time. Ready tasks of one
+    // class run earliest absolute deadline first; a task without one is
+    // ordered as if due one aging step after it became ready.
+    Duration deadline = Duration::max();
+    // Concurrency and rate limits shared with other tasks; see ResourceGroup.
+    std::shared_ptr<ResourceGroup> group;
+    // Recurring tasks only.
+    Recurrence recurrence;
+    // NUMA node of the scheduler's pool to run on (see ThreadPool::nodes()).
+    // -1 follows the data: the node where the dependency releasing the task
+    // ran. A preference only; ignored by unpinned pools.
+    int node = -1;
+    // One-shot tasks: finish-by budget counted from the scheduled time. Once
+    // it runs out the task is timed out like Scheduler::cancel() does.
+    Duration timeout = Duration::max();
+    // Runs even when a dependency failed or was canceled (cleanup steps),
+    // instead of being pruned with it.
+    bool always_run = false;
+};
+
 struct ScheduledTask {
-    Task func;
+    UniqueTask func;
     TimePoint next_run;
     Duration interval{};
+    Recurrence recurrence;      // recurring tasks
     bool recurring = false;
-    bool canceled = false;
+    bool always_run = false;                // see TaskOptions
+    Duration timeout = Duration::max();     // see TaskOptions
     std::string cron_expr;
+    CronSchedule cron;          // compiled cron_expr; valid only for cron tasks
+    std::string name;           // shown in traces; TaskGraph node names land here
+    Priority priority = Priority::normal;
+    Duration deadline = Duration::max();    // see TaskOptions
+    int node = -1;                          // see TaskOptions
+    std::shared_ptr<ResourceGroup> group;
 
     std::vector<TaskHandle> dependencies;
     std::vector<TaskHandle> dependents;
     std::atomic<int> pending_deps{0};
 
-    std::promise<std::optional<std::any>> completion;
+    // Completion state. There is no promise: waiters block on `completions`
+    // with C++20 atomic wait, which costs nothing unless someone waits.
+    std::atomic<uint32_t> completions{0};
+    TaskStatus status = TaskStatus::pending;   // of the latest run; set before completions
+    std::exception_ptr error;
+    // Why the task was asked to stop (a TaskStatus), pending if it was not;
+    // what CancelToken reads.
+    std::atomic<uint8_t> stop{0};
+    TaskResult result;
+    // Tasks that finish after func returns (coroutines, pipelines) set this
+    // to 2 from inside func: run() and the asynchronous end each drop one,
+    // and whichever comes last completes the task.
+    std::atomic<uint8_t> detach_refs{0};
     
-    // Make it movable
+    // Make it movable (before it is scheduled; completion state is not moved)
     ScheduledTask() = default;
     ScheduledTask(const ScheduledTask&) = delete;
     ScheduledTask& operator=(const ScheduledTask&) = delete;
     ScheduledTask(ScheduledTask&& other) noexcept 
         : func(std::move(other.func)), next_run(other.next_run), interval(other.interval),
-          recurring(other.recurring), canceled(other.canceled), cron_expr(std::move(other.cron_expr)),
+          recurrence(other.recurrence), recurring(other.recurring), always_run(other.always_run), timeout(other.timeout), cron_expr(std::move(other.cron_expr)), cron(other.cron), name(std::move(other.name)),
+          priority(other.priority), deadline(other.deadline), node(other.node), group(std::move(other.group)),
           dependencies(std::move(other.dependencies)), dependents(std::move(other.dependents)),
-          pending_deps(other.pending_deps.load()), completion(std::move(other.completion)) {}
+          pending_deps(other.pending_deps.load()) {}
     
     ScheduledTask& operator=(ScheduledTask&& other) noexcept {
         if (this != &other) {
             func = std::move(other.func);
             next_run = other.next_run;
             interval = other.interval;
+            recurrence = other.recurrence;
             recurring = other.recurring;
-            canceled = other.canceled;
+            always_run = other.always_run;
+            timeout = other.timeout;
             cron_expr = std::move(other.cron_expr);
+            cron = other.cron;
+            name = std::move(other.name);
+            priority = other.priority;
+            deadline = other.deadline;
+            node = other.node;
+            group = std::move(other.group);
             dependencies = std::move(other.dependencies);
             dependents = std::move(other.dependents);
             pending_deps = other.pending_deps.load();
-            completion = std::move(other.completion);
         }
         return *this;
     }
-    
-    std::shared_future<std::optional<std::any>> future() { return completion.get_future(); }
 
-    void run() {
-        if (canceled) return;
+    // Dispatch attributes from the options a schedule_* call was given.
+    // Recurrence is left to the recurring calls.
+    void apply(const TaskOptions& o) {
+        priority = o.priority;
+        deadline = o.deadline;
+        node = o.node;
+        group = o.group;
+        timeout = o.timeout;
+        always_run = o.always_run;
+    }
+
+    // The task whose func is running on the calling thread, if any.
+    static ScheduledTask*& current() {
+        static thread_local ScheduledTask* t = nullptr;
+        return t;
+    }
+
+    // False if a coroutine still holds the task; it completes it later.
+    bool run() {
+        ScheduledTask* outer = std::exchange(current(), this);
         try {
             func();
-            completion.set_value(std::nullopt);
+            if (detach_refs.load(std::memory_order_relaxed) == 0) error = nullptr;
         } catch (...) { 
-            completion.set_exception(std::current_exception()); 
+            error = std::current_exception();
+        }
+        current() = outer;
+        if (detach_refs.load(std::memory_order_relaxed) != 0 &&
+            detach_refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return false;
+        complete();
+        return true;
+    }
+
+    void complete() { complete(outcome()); }
+    void complete(TaskStatus s) {
+        status = s;
+        completions.fetch_add(1, std::memory_order_release);
+        completions.notify_all();
+    }
+
+    // Status of a run that ended with `error`: a TaskCanceled thrown after a
+    // stop request ends it the way the request asked.
+    TaskStatus outcome() const {
+        if (!error) return TaskStatus::succeeded;
+        auto why = static_cast<TaskStatus>(stop.load(std::memory_order_acquire));
+        if (why != TaskStatus::pending) {
+            try { std::rethrow_exception(error); }
+            catch (const TaskCanceled&) { return why; }
+            catch (...) {}
         }
+        return TaskStatus::failed;
+    }
+
+    // Blocks until the task has completed more than `seen` times.
+    void wait_past(uint32_t seen) const {
+        for (auto c = completions.load(std::memory_order_acquire); c <= seen;
+             c = completions.load(std::memory_order_acquire))
+            completions.wait(c, std::memory_order_acquire);
+    }
+};
+
+// Lets a long-running task notice Scheduler::cancel() or its timeout and
+// stop early. Valid until the task has finished; a default one never fires.
+//
+//     auto token = tf::CancelToken::current();
+//     for (auto& chunk : input) { token.throw_if_requested(); load(chunk); }
+class CancelToken {
+public:
+    CancelToken() = default;
+    // Token of the task running on the calling thread; a default one elsewhere.
+    static CancelToken current() {
+        ScheduledTask* t = ScheduledTask::current();
+        return t ? CancelToken(&t->stop) : CancelToken();
+    }
+
+    bool requested() const { return reason() != TaskStatus::pending; }
+    // canceled or timed_out; pending until requested.
+    TaskStatus reason() const {
+        return flag_ ? static_cast<TaskStatus>(flag_->load(std::memory_order_relaxed)) : TaskStatus::pending;
+    }
+    // Ends the task with the requested status, dependents pruned.
+    void throw_if_requested() const {
+        if (requested()) throw TaskCanceled(reason());
     }
+
+private:
+    explicit CancelToken(const std::atomic<uint8_t>* flag) : flag_(flag) {}
+    const std::atomic<uint8_t>* flag_ = nullptr;
 };
 
 }  // namespace tf
\ No newline at end of file
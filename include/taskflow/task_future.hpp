@@ -0,0 +1,87 @@
+#pragma once
+#include "task.hpp"
+#include "thread_pool.hpp"
+#include <type_traits>
+#include <utility>
+
+namespace tf {
+
+class Scheduler;
+class IoExecutor;
+
+namespace detail {
+// Implemented in scheduler.cpp. A pinned slot is not reclaimed until every
+// pin is released, so the result stays readable after the task finished.
+ScheduledTask* pin_task(Scheduler& s, TaskHandle h);   // nullptr if stale
+void unpin_task(Scheduler& s, TaskHandle h);
+// Marks the task running on this thread as finished by someone else later
+// (a coroutine, a pipeline, an I/O request; see ScheduledTask::detach_refs)
+// and returns its handle.
+TaskHandle detach_current();
+// Completes a detached task once the last detach ref has been dropped.
+void complete_detached(Scheduler& s, TaskHandle h);
+}  // namespace detail
+
+// Typed handle to a one-shot task's result. Holds a pin on the task slot for
+// as long as it (or a copy) lives; the value is read straight from the slot.
+// Converts to TaskHandle, so it can be used wherever a dependency is expected.
+template<class R>
+class TaskFuture {
+public:
+    TaskFuture() = default;
+    TaskFuture(const TaskFuture& o) : s_(o.s_), h_(o.h_), t_(o.t_) {
+        if (t_) detail::pin_task(*s_, h_);
+    }
+    TaskFuture(TaskFuture&& o) noexcept
+        : s_(o.s_), h_(o.h_), t_(std::exchange(o.t_, nullptr)) {}
+    TaskFuture& operator=(TaskFuture o) noexcept {
+        std::swap(s_, o.s_);
+        std::swap(h_, o.h_);
+        std::swap(t_, o.t_);
+        return *this;
+    }
+    ~TaskFuture() { if (t_) detail::unpin_task(*s_, h_); }
+
+    TaskHandle handle() const { return h_; }
+    operator TaskHandle() const { return h_; }
+    bool valid() const { return t_ != nullptr; }
+
+    bool ready() const {
+        return t_ && t_->completions.load(std::memory_order_acquire) != 0;
+    }
+    // succeeded, failed, canceled or timed_out once ready; pending before.
+    TaskStatus status() const { return ready() ? t_->status : TaskStatus::pending; }
+    // A pool worker waiting here counts as blocked (see ThreadPool::Blocking).
+    void wait() const {
+        if (!t_ || ready()) return;
+        ThreadPool::Blocking blocking;
+        t_->wait_past(0);
+    }
+
+    // Waits, then rethrows the task's exception or returns its value. A
+    // canceled or timed-out task throws TaskCanceled, and one pruned after a
+    // dependency failed rethrows that dependency's exception.
+    decltype(auto) get() const {
+        if (!t_) throw std::logic_error("TaskFuture: no task");
+        wait();
+        if (t_->error) std::rethrow_exception(t_->error);
+        if constexpr (!std::is_void_v<R>) return static_cast<const R&>(t_->result.template get<R>());
+    }
+
+private:
+    friend class Scheduler;
+    friend class IoExecutor;
+    // Adopts a pin the scheduler already took for us.
+    TaskFuture(Scheduler& s, TaskHandle h, ScheduledTask* t) : s_(&s), h_(h), t_(t) {}
+
+    Scheduler* s_ = nullptr;
+    TaskHandle h_{};
+    ScheduledTask* t_ = nullptr;
+};
+
+// What the result-bearing schedule_once overloads return: a plain handle for
+// void tasks (no pin, nothing to read), a TaskFuture otherwise.
+template<class R>
+using ScheduleResult = std::conditional_t<std::is_void_v<R>, TaskHandle, TaskFuture<R>>;
+
+}  // namespace tf
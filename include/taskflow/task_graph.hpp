@@ -0,0 +1,66 @@
+#pragma once
+#include "task.hpp"
+#include "result_cache.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tf {
+
+// Declarative DAG builder. Nodes and edges are collected locally, validated
+// with a topological sort, and handed to Scheduler::submit() in one batch.
+class TaskGraph {
+public:
+    using NodeId = size_t;
+
+    NodeId add(UniqueTask fn);
+    // Named nodes can be wired up by name; names must be unique.
+    NodeId add(std::string name, UniqueTask fn);
+    // Node whose result is cached by key: a hash of its name, `input` (a
+    // fingerprint of whatever it reads besides its predecessors, e.g.
+    // file_hash of a source) and the keys of its cached predecessors. fn gets
+    // those predecessors' outputs and returns its own. Submitted with a
+    // ResultCache, a node whose key is already stored does not run, so only
+    // the nodes downstream of a changed input execute again. Predecessors
+    // added without a key only order the node.
+    NodeId add_cached(std::string name, CacheKey input, CachedTask fn);
+
+    // `from` must finish before `to` starts.
+    void precede(NodeId from, NodeId to);
+    void precede(const std::string& from, const std::string& to);
+    // Dependency on a task that was scheduled outside this graph.
+    void depend_on(NodeId n, TaskHandle external);
+
+    NodeId find(const std::string& name) const;   // throws std::out_of_range
+    const std::string& name(NodeId n) const { return nodes_.at(n).name; }
+    size_t size() const { return nodes_.size(); }
+    size_t edge_count() const { return edges_; }
+
+    // Kahn's algorithm; throws std::invalid_argument naming a node on a cycle.
+    std::vector<NodeId> topological_order() const;
+    bool has_cycle() const;
+
+private:
+    friend class Scheduler;
+    friend class CompiledGraph;
+    friend class ResultCache;
+
+    struct Node {
+        std::string name;
+        UniqueTask fn;
+        std::vector<NodeId> successors;
+        std::vector<TaskHandle> external;
+        uint32_t in_degree = 0;
+        CachedTask cached;   // add_cached nodes until submitted
+        CacheKey input;
+        bool hit = false;    // served from the cache; fn does nothing
+    };
+
+    void check(NodeId n) const;
+
+    std::vector<Node> nodes_;
+    std::unordered_map<std::string, NodeId> by_name_;
+    size_t edges_ = 0;
+};
+
+}  // namespace tf
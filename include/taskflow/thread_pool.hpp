@@ -1,25 +1,218 @@
 #pragma once
+#include "work_stealing_deque.hpp"
+#include "unique_function.hpp"
+#include "instrumentation.hpp"
+#include "priority.hpp"
+#include "topology.hpp"
+#include "event_count.hpp"
+#include <array>
+#include <chrono>
 #include <thread>
 #include <vector>
-#include <queue>
+#include <deque>
 #include <mutex>
-#include <condition_variable>
 #include <functional>
 #include <atomic>
+#include <memory>
 
 namespace tf {
 
+// Where a pool's workers run.
+enum class Pinning : uint8_t {
+    none,   // wherever the OS puts them; the pool is one node
+    core,   // each worker on one CPU of its own, nodes taking turns
+    node,   // each worker on any CPU of one node, nodes taking turns
+};
+
+struct PoolOptions {
+    size_t threads = 0;              // 0: one per CPU (of the topology, if pinned)
+    Pinning pinning = Pinning::none;
+    Topology topology;               // empty: Topology::detect(); unused unpinned
+    // An idle worker polls for work spin_rounds times with a CPU pause, then
+    // yield_rounds times yielding, then parks. More rounds pick up the next
+    // burst without a wake-up, at the price of CPU burnt while idle.
+    uint32_t spin_rounds = 32;
+    uint32_t yield_rounds = 32;
+    // Elastic sizing: while workers are blocked (see ThreadPool::Blocking),
+    // spare workers start so that `threads` keep running, up to max_threads
+    // in all; a spare exits once parked for idle_timeout. 0: fixed size.
+    size_t max_threads = 0;
+    std::chrono::nanoseconds idle_timeout = std::chrono::seconds(5);
+};
+
+// Work-stealing pool. Every worker owns a Chase-Lev deque; work submitted from
+// a worker of this pool goes to that worker's deque, work from any other
+// thread goes through a shared injection queue. Idle workers steal.
+//
+// Work with a non-normal priority or a deadline bypasses the deques and waits
+// in one earliest-deadline-first heap per priority class. Workers look at
+// high (and aged) work before their deques and at low work only when there
+// is nothing else to do.
+//
+// Idle workers spin, then yield, then park on an event count. A push wakes a
+// parked worker only when no worker is already looking for work; one that
+// finds some while it was the last one looking wakes the next, so a burst
+// ramps up the pool one wake-up at a time.
+//
+// A pinned pool groups its workers by NUMA node. Thieves look at workers of
+// their own node first, and take from another node only after some rounds of
+// finding nothing and while none of that node's workers is looking for work,
+// so work spawned by a task tends to stay on its node. Work naming a node
+// (Work::node) from anywhere else waits in that node's queue.
 class ThreadPool {
 public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    // Intrusive unit of work. submit() queues the pointer itself, so callers
+    // that embed a Work in longer-lived storage dispatch without allocating.
+    struct Work {
+        void (*execute)(Work*) = nullptr;
+        Priority priority = Priority::normal;
+        // Node to run on, as a pool node index; -1 for any. A preference:
+        // idle workers of other nodes still take it. Prioritized work ignores it.
+        int16_t node = -1;
+        TimePoint deadline = TimePoint::max();   // EDF key within the class
+
+        bool prioritized() const {
+            return priority != Priority::normal || deadline != TimePoint::max();
+        }
+    };
+
     explicit ThreadPool(size_t n = std::thread::hardware_concurrency());
+    // Pinning a worker is best effort: if the OS refuses, it runs unpinned
+    // and keeps its node for scheduling.
+    explicit ThreadPool(const PoolOptions& opts);
     ~ThreadPool();
-    void enqueue(std::function<void()> task);
+    // Runs everything already queued, then joins the workers. Idempotent;
+    // the destructor calls it. Outside submissions are dropped afterwards.
+    void shutdown();
+    void enqueue(UniqueTask task);
+    void enqueue(UniqueTask task, Priority priority, TimePoint deadline = TimePoint::max());
+    // `w` must stay alive until w->execute(w) has been called. False if the
+    // pool has shut down and refused it; w is then the caller's again.
+    bool submit(Work* w);
+
+    // Worker slots, spare ones included; current_worker() is below this.
+    size_t size() const { return workers_.size(); }
+    // Workers running now: size() unless elastic.
+    size_t threads() const { return live_.load(std::memory_order_relaxed); }
+    // Index of the calling thread in this pool, or -1 for outside threads.
+    int current_worker() const;
+    // NUMA nodes the workers are spread over; 1 unless pinned.
+    size_t nodes() const { return node_queues_.size(); }
+    // Node index of worker `i`, and of the calling worker (-1 outside).
+    int node_of(size_t i) const { return workers_[i]->node; }
+    int current_node() const;
+    // CPUs the pool was laid out on; empty unless pinned.
+    const Topology& topology() const { return topology_; }
+    // Pool the calling thread is a worker of, or nullptr.
+    static ThreadPool* current();
+    // Runs one queued job on the calling worker, if any is available, so a
+    // worker that has to wait for other pool work can help instead of blocking.
+    // Always false on outside threads.
+    bool run_one();
+
+    // Jobs waiting in any queue; approximate while workers are running.
+    size_t queued() const;
+    // True while high-priority work is waiting for a worker.
+    bool has_urgent() const { return prio_count_[0].load(std::memory_order_relaxed) != 0; }
+    // Queued work is promoted one priority class for every `step` it waits.
+    // Work without a deadline is ordered as if due one step after it was queued.
+    void set_aging(std::chrono::nanoseconds step) { aging_ns_ = step.count() > 0 ? step.count() : 1; }
+
+    // Per-worker counters; all zero unless built with instrumentation.
+    std::vector<WorkerMetrics> worker_metrics() const;
+
+    // Marks the calling worker as blocked (on I/O, a lock, another task)
+    // while in scope, so an elastic pool can start a spare in its place.
+    // Does nothing off the pool or in a fixed-size pool; nests.
+    class Blocking {
+    public:
+        Blocking();
+        ~Blocking();
+        Blocking(const Blocking&) = delete;
+        Blocking& operator=(const Blocking&) = delete;
+
+    private:
+        ThreadPool* pool_;
+    };
+
 private:
-    std::vector<std::thread> workers_;
-    std::queue<std::function<void()>> tasks_;
-    std::mutex mtx_;
-    std::condition_variable cv_;
+    struct Worker {
+        WorkStealingDeque<Work*> deque;
+        std::thread thread;
+        uint64_t rng;
+        std::atomic<bool> live{false};     // a thread is running this slot
+        int node = 0;
+        std::vector<int> cpus;              // affinity; empty when unpinned
+        std::vector<size_t> near, far;      // steal victims on this node, then others
+#if TASKFLOW_INSTRUMENTATION
+        detail::PoolWorkerStats stats;
+#endif
+    };
+
+    // Per node: work queued for it, and where its idle workers park.
+    struct NodeQueue {
+        std::deque<Work*> q;                // guarded by mtx_
+        std::atomic<size_t> size{0};
+        std::atomic<int> searching{0};      // workers awake and looking for work
+        EventCount parked;
+        std::atomic<uint32_t> waking{0};    // parked workers notified, not yet up
+    };
+
+    void run(size_t id);
+    void start(size_t id);
+    // Blocking: starts a spare if fewer than core_ workers are left running.
+    void grow();
+    // A spare idle for idle_timeout; false if it has to stay after all.
+    bool retire(size_t id);
+    void pin(size_t id);
+    bool push(Work* w);
+    bool push_node(Work* w);
+    // With `remote`, also work queued for or stolen from other nodes.
+    Work* take(size_t id, bool remote = true);
+    Work* take_queued(int node, bool remote);
+    bool attended(const NodeQueue& nq) const;
+    Work* steal(size_t id, bool remote);
+    void run_job(size_t id, Work* job);
+    bool push_prioritized(Work* w);
+    // Highest effective class first; with `urgent_only`, only work that
+    // should run ahead of normal deque work.
+    Work* take_prioritized(bool urgent_only);
+    bool has_work() const;
+    // Wakes a sleeper, one of `node` if there is any.
+    void wake_one(int node = -1);
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    size_t core_ = 0;                        // workers that never retire
+    std::atomic<size_t> live_{0};
+    std::atomic<size_t> blocked_{0};         // live workers inside a Blocking scope
+    std::mutex spawn_mtx_;                   // starting and retiring spares
+    bool closed_ = false;                    // guarded by spawn_mtx_: no more spares
+    uint32_t spin_rounds_, idle_rounds_;
+    std::chrono::nanoseconds idle_timeout_;
+    std::deque<Work*> injection_;
+    std::atomic<size_t> injected_{0};
+    std::vector<std::unique_ptr<NodeQueue>> node_queues_;
+    std::atomic<size_t> node_queued_{0};
+    Topology topology_;
+    mutable std::mutex mtx_;
+    std::atomic<size_t> sleeping_{0};
     std::atomic<bool> stop_{false};
+
+    struct PrioEntry {
+        int64_t key;        // deadline, ns
+        uint64_t seq;       // FIFO among equal keys
+        int64_t queued_ns;
+        Work* work;
+        bool operator>(const PrioEntry& o) const { return key != o.key ? key > o.key : seq > o.seq; }
+    };
+    static constexpr size_t kClasses = 3;
+    std::array<std::vector<PrioEntry>, kClasses> prio_;   // min-heaps
+    std::array<std::atomic<size_t>, kClasses> prio_count_{};
+    uint64_t prio_seq_ = 0;
+    std::mutex prio_mtx_;
+    std::atomic<int64_t> aging_ns_{50'000'000};
 };
 
-}  // namespace tf
\ No newline at end of file
+}  // namespace tf
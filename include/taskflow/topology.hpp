@@ -0,0 +1,31 @@
+#pragma once
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace tf {
+
+// CPUs grouped by NUMA node.
+struct Topology {
+    struct Node {
+        int id = 0;              // kernel node number
+        std::vector<int> cpus;   // ascending
+    };
+    std::vector<Node> nodes;     // ascending id; none empty
+
+    size_t cpus() const;
+    // Node index holding `cpu`, or -1.
+    int node_of(int cpu) const;
+
+    // The nodes and CPUs this process may run on: sysfs node information
+    // narrowed to the affinity mask. Without sysfs (or on a non-NUMA kernel)
+    // one node holding every allowed CPU.
+    static Topology detect();
+    // Every node listed under `dir` (a sysfs node directory such as
+    // /sys/devices/system/node), as is. Empty if there are none.
+    static Topology read(const std::filesystem::path& dir);
+    // Parses a kernel CPU list such as "0-3,8-11"; malformed parts are skipped.
+    static std::vector<int> parse_cpulist(const std::string& s);
+};
+
+}  // namespace tf
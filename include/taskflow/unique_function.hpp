@@ -0,0 +1,119 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Inline buffer for scheduler and pool callables. Part of the ABI of
+// ScheduledTask: set it through the TASKFLOW_TASK_INLINE_BYTES CMake cache
+// variable so the library and its users agree.
+#ifndef TASKFLOW_TASK_INLINE_BYTES
+#define TASKFLOW_TASK_INLINE_BYTES 48
+#endif
+
+namespace tf {
+
+template<class Sig, size_t InlineBytes = TASKFLOW_TASK_INLINE_BYTES>
+class UniqueFunction;
+
+// Move-only type-erased callable. Callables up to InlineBytes (and no more
+// strictly aligned than max_align_t, with a noexcept move) are stored in place;
+// anything larger is boxed on the heap. Unlike std::function it accepts
+// move-only captures and never copies.
+template<class R, class... Args, size_t InlineBytes>
+class UniqueFunction<R(Args...), InlineBytes> {
+    struct VTable {
+        R (*invoke)(void*, Args&&...);
+        void (*move)(void* dst, void* src) noexcept;   // move-construct dst, destroy src
+        void (*destroy)(void*) noexcept;
+    };
+
+    template<class F>
+    static constexpr bool fits_inline =
+        sizeof(F) <= InlineBytes && alignof(F) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<F>;
+
+    template<class F>
+    static constexpr VTable inline_vtable{
+        [](void* p, Args&&... a) -> R { return std::invoke(*static_cast<F*>(p), std::forward<Args>(a)...); },
+        [](void* d, void* s) noexcept {
+            new (d) F(std::move(*static_cast<F*>(s)));
+            static_cast<F*>(s)->~F();
+        },
+        [](void* p) noexcept { static_cast<F*>(p)->~F(); },
+    };
+
+    template<class F>
+    static constexpr VTable heap_vtable{
+        [](void* p, Args&&... a) -> R { return std::invoke(**static_cast<F**>(p), std::forward<Args>(a)...); },
+        [](void* d, void* s) noexcept { *static_cast<F**>(d) = *static_cast<F**>(s); },
+        [](void* p) noexcept { delete *static_cast<F**>(p); },
+    };
+
+public:
+    static constexpr size_t inline_size = InlineBytes;
+
+    UniqueFunction() noexcept = default;
+    UniqueFunction(std::nullptr_t) noexcept {}
+
+    template<class F, class D = std::decay_t<F>,
+             class = std::enable_if_t<!std::is_same_v<D, UniqueFunction> &&
+                                      std::is_invocable_r_v<R, D&, Args...>>>
+    UniqueFunction(F&& f) {
+        if constexpr (std::is_pointer_v<D> || std::is_member_pointer_v<D> ||
+                      std::is_same_v<D, std::function<R(Args...)>>) {
+            if (!f) return;
+        }
+        if constexpr (fits_inline<D>) {
+            new (storage_) D(std::forward<F>(f));
+            vt_ = &inline_vtable<D>;
+        } else {
+            *reinterpret_cast<D**>(storage_) = new D(std::forward<F>(f));
+            vt_ = &heap_vtable<D>;
+        }
+    }
+
+    UniqueFunction(UniqueFunction&& o) noexcept : vt_(o.vt_) {
+        if (vt_) { vt_->move(storage_, o.storage_); o.vt_ = nullptr; }
+    }
+
+    UniqueFunction& operator=(UniqueFunction&& o) noexcept {
+        if (this != &o) {
+            reset();
+            if (o.vt_) { o.vt_->move(storage_, o.storage_); vt_ = o.vt_; o.vt_ = nullptr; }
+        }
+        return *this;
+    }
+
+    UniqueFunction(const UniqueFunction&) = delete;
+    UniqueFunction& operator=(const UniqueFunction&) = delete;
+
+    ~UniqueFunction() { reset(); }
+
+    void reset() noexcept {
+        if (vt_) { vt_->destroy(storage_); vt_ = nullptr; }
+    }
+
+    explicit operator bool() const noexcept { return vt_ != nullptr; }
+
+    R operator()(Args... args) {
+        if (!vt_) throw std::bad_function_call();
+        return vt_->invoke(storage_, std::forward<Args>(args)...);
+    }
+
+    // True when the callable is held in place rather than boxed on the heap.
+    template<class F>
+    static constexpr bool stores_inline() { return fits_inline<std::decay_t<F>>; }
+
+private:
+    static_assert(InlineBytes >= sizeof(void*), "inline buffer must hold a pointer");
+
+    alignas(std::max_align_t) unsigned char storage_[InlineBytes];
+    const VTable* vt_ = nullptr;
+};
+
+using UniqueTask = UniqueFunction<void()>;
+
+}  // namespace tf
@@ -0,0 +1,116 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+namespace tf {
+
+// Chase-Lev work-stealing deque (Le, Pop, Cohen, Zappa Nardelli, PPoPP'13).
+// The owning thread pushes and pops at the bottom; any thread may steal from
+// the top. T must be trivially copyable (in practice a pointer).
+template<class T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque holds raw values");
+
+    struct Array {
+        explicit Array(int64_t cap) : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[cap]) {}
+        int64_t capacity;
+        int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        void put(int64_t i, T v) { slots[i & mask].store(v, std::memory_order_relaxed); }
+        T get(int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+
+        Array* grow(int64_t b, int64_t t) const {
+            auto* a = new Array(capacity * 2);
+            for (int64_t i = t; i != b; ++i) a->put(i, get(i));
+            return a;
+        }
+    };
+
+public:
+    explicit WorkStealingDeque(int64_t capacity = 256) {
+        auto* a = new Array(capacity);
+        array_.store(a, std::memory_order_relaxed);
+        retired_.emplace_back(a);
+    }
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only.
+    void push(T v) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        Array* a = array_.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            // Old arrays stay alive until destruction: a thief may still read them.
+            a = a->grow(b, t);
+            retired_.emplace_back(a);
+            array_.store(a, std::memory_order_release);
+        }
+        a->put(b, v);
+        bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only. LIFO end.
+    std::optional<T> pop() {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* a = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        T v = a->get(b);
+        if (t == b) {
+            // Last element: race against thieves for it.
+            bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            if (!won) return std::nullopt;
+        }
+        return v;
+    }
+
+    // Any thread. FIFO end.
+    std::optional<T> steal() {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return std::nullopt;
+
+        Array* a = array_.load(std::memory_order_acquire);
+        T v = a->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed))
+            return std::nullopt;
+        return v;
+    }
+
+    // Approximate; exact only when called by the owner with no thieves running.
+    bool empty() const {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        return b <= t;
+    }
+    size_t size() const {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+private:
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    alignas(64) std::atomic<Array*> array_{nullptr};
+    std::vector<std::unique_ptr<Array>> retired_;
+};
+
+}  // namespace tf
@@ -0,0 +1,106 @@
+#include <taskflow/compiled_graph.hpp>
+#include <stdexcept>
+#include <thread>
+
+namespace tf {
+
+CompiledGraph::CompiledGraph(TaskGraph&& g) {
+    ResultCache::bind(g, nullptr);   // cached nodes just run; a replay has no cache
+    auto order = g.topological_order();
+    const size_t n = order.size();
+    remap_.resize(n);
+    for (size_t i = 0; i < n; ++i) remap_[order[i]] = static_cast<uint32_t>(i);
+
+    fns_.reserve(n);
+    offsets_.reserve(n + 1);
+    successors_.reserve(g.edge_count());
+    in_degree_.reserve(n);
+    offsets_.push_back(0);
+    for (size_t i = 0; i < n; ++i) {
+        auto& node = g.nodes_[order[i]];
+        if (!node.external.empty())
+            throw std::invalid_argument("CompiledGraph: external dependencies are not reusable");
+        fns_.push_back(std::move(node.fn));
+        for (auto s : node.successors) successors_.push_back(remap_[s]);
+        offsets_.push_back(static_cast<uint32_t>(successors_.size()));
+        in_degree_.push_back(node.in_degree);
+        if (node.in_degree == 0) roots_.push_back(static_cast<uint32_t>(i));
+    }
+
+    work_.resize(n);
+    pending_ = std::make_unique<std::atomic<uint32_t>[]>(n);
+    for (uint32_t i = 0; i < n; ++i) {
+        work_[i].graph = this;
+        work_[i].index = i;
+        work_[i].execute = [](ThreadPool::Work* w) {
+            auto* nw = static_cast<NodeWork*>(w);
+            nw->graph->execute(nw->index);
+        };
+    }
+}
+
+void CompiledGraph::run(ThreadPool& pool) {
+    if (running_.exchange(true)) throw std::logic_error("CompiledGraph: already running");
+    if (fns_.empty()) { running_ = false; return; }
+
+    pool_ = &pool;
+    error_ = nullptr;
+    failed_.store(false, std::memory_order_relaxed);
+    for (size_t i = 0; i < in_degree_.size(); ++i)
+        pending_[i].store(in_degree_[i], std::memory_order_relaxed);
+    notified_.store(false, std::memory_order_relaxed);
+    remaining_.store(static_cast<uint32_t>(fns_.size()), std::memory_order_release);
+
+    for (auto r : roots_)
+        if (!pool.submit(&work_[r])) execute(r);
+
+    if (pool.current_worker() >= 0) {
+        while (remaining_.load(std::memory_order_acquire) != 0)
+            if (!pool.run_one()) std::this_thread::yield();
+    } else {
+        for (auto v = remaining_.load(std::memory_order_acquire); v != 0;
+             v = remaining_.load(std::memory_order_acquire))
+            remaining_.wait(v, std::memory_order_acquire);
+    }
+    // The last node may still be in notify_all(); *this must outlive that.
+    while (!notified_.load(std::memory_order_acquire)) std::this_thread::yield();
+
+    running_ = false;
+    if (error_) std::rethrow_exception(error_);
+}
+
+// Runs node i, then follows the chain of successors it alone released, and
+// any the pool refused after a shutdown.
+void CompiledGraph::execute(uint32_t i) {
+    std::vector<uint32_t> refused;
+    while (true) {
+        try {
+            fns_[i]();
+        } catch (...) {
+            if (!failed_.exchange(true)) error_ = std::current_exception();
+        }
+
+        uint32_t next = UINT32_MAX;
+        for (uint32_t e = offsets_[i]; e < offsets_[i + 1]; ++e) {
+            uint32_t s = successors_[e];
+            if (pending_[s].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                if (next == UINT32_MAX) next = s;
+                else if (!pool_->submit(&work_[s])) refused.push_back(s);
+            }
+        }
+
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            remaining_.notify_all();
+            notified_.store(true, std::memory_order_release);
+            return;
+        }
+        if (next == UINT32_MAX) {
+            if (refused.empty()) return;
+            next = refused.back();
+            refused.pop_back();
+        }
+        i = next;
+    }
+}
+
+}  // namespace tf
@@ -1,44 +1,287 @@
 #include <taskflow/cron_parser.hpp>
 #include <sstream>
-#include <iomanip>
 #include <ctime>
 #include <vector>
+#include <bit>
+#include <cctype>
+#include <cstring>
 
 namespace tf {
 
+namespace {
+
+const char* const kMonthNames[] = {"JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+                                   "JUL", "AUG", "SEP", "OCT", "NOV", "DEC"};
+const char* const kDayNames[] = {"SUN", "MON", "TUE", "WED", "THU", "FRI", "SAT"};
+
+struct FieldSpec {
+    int min, max;
+    const char* const* names;   // optional 3-letter names, names[0] == min
+    int name_count;
+    bool question = false;      // `?` may stand for the whole field (day fields)
+};
+
+constexpr FieldSpec kSeconds{0, 59, nullptr, 0};
+constexpr FieldSpec kMinutes{0, 59, nullptr, 0};
+constexpr FieldSpec kHours{0, 23, nullptr, 0};
+constexpr FieldSpec kDom{1, 31, nullptr, 0, true};
+constexpr FieldSpec kMonths{1, 12, kMonthNames, 12};
+constexpr FieldSpec kDow{0, 7, kDayNames, 7, true};
+
+bool parse_value(const std::string& v, const FieldSpec& f, int& out) {
+    if (v.empty()) return false;
+    if (std::isalpha(static_cast<unsigned char>(v[0]))) {
+        if (!f.names || v.size() != 3) return false;
+        for (int i = 0; i < f.name_count; ++i) {
+            bool eq = true;
+            for (int k = 0; k < 3; ++k)
+                if (std::toupper(static_cast<unsigned char>(v[k])) != f.names[i][k]) eq = false;
+            if (eq) { out = f.min + i; return true; }
+        }
+        return false;
+    }
+    int n = 0;
+    for (char c : v) {
+        if (!std::isdigit(static_cast<unsigned char>(c)) || n > 1000) return false;
+        n = n * 10 + (c - '0');
+    }
+    if (n < f.min || n > f.max) return false;
+    out = n;
+    return true;
+}
+
+// One comma-separated field into a bitmask. `star` reports an unrestricted
+// field; like Vixie cron, any field starting with `*` (e.g. `*/2`) counts.
+// `?` is only accepted on its own, and only in the day fields.
+bool parse_field(const std::string& field, const FieldSpec& f, uint64_t& mask, bool& star) {
+    mask = 0;
+    if (field == "?") {
+        if (!f.question) return false;
+        star = true;
+        mask = ((uint64_t(1) << (f.max + 1)) - 1) & ~((uint64_t(1) << f.min) - 1);
+        return true;
+    }
+    star = !field.empty() && field[0] == '*';
+    if (field.empty() || field.back() == ',') return false;   // getline would drop the empty tail
+    std::istringstream items(field);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        if (item.empty()) return false;
+        int step = 1;
+        auto slash = item.find('/');
+        if (slash != std::string::npos) {
+            std::string st = item.substr(slash + 1);
+            int n = 0;
+            if (st.empty() || st.size() > 4) return false;
+            for (char c : st) {
+                if (!std::isdigit(static_cast<unsigned char>(c))) return false;
+                n = n * 10 + (c - '0');
+            }
+            if (n == 0) return false;
+            step = n;
+            item.resize(slash);
+        }
+
+        int lo, hi;
+        if (item == "*") {
+            lo = f.min;
+            hi = f.max;
+        } else if (auto dash = item.find('-'); dash != std::string::npos) {
+            if (!parse_value(item.substr(0, dash), f, lo) || !parse_value(item.substr(dash + 1), f, hi) || lo > hi)
+                return false;
+        } else {
+            if (!parse_value(item, f, lo)) return false;
+            hi = slash != std::string::npos ? f.max : lo;   // `a/n` runs to the field maximum
+        }
+        for (int v = lo; v <= hi; v += step) mask |= uint64_t(1) << v;
+    }
+    return mask != 0;
+}
+
+const char* expand_macro(const std::string& e) {
+    if (e == "@yearly" || e == "@annually") return "0 0 1 1 *";
+    if (e == "@monthly") return "0 0 1 * *";
+    if (e == "@weekly") return "0 0 * * 0";
+    if (e == "@daily" || e == "@midnight") return "0 0 * * *";
+    if (e == "@hourly") return "0 * * * *";
+    return nullptr;
+}
+
+// ---- civil calendar arithmetic (proleptic Gregorian) ----
+
+int64_t days_from_civil(int y, int m, int d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+int days_in_month(int y, int m) {
+    static constexpr int kDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+    return m == 2 && leap ? 29 : kDays[m - 1];
+}
+
+int weekday(int y, int m, int d) {
+    int64_t z = days_from_civil(y, m, d);
+    return static_cast<int>(z >= -4 ? (z + 4) % 7 : (z + 5) % 7 + 6);  // 1970-01-01 was a Thursday
+}
+
+// Lowest set bit of `mask` at or above `from`, or -1.
+int next_bit(uint64_t mask, int from) {
+    if (from >= 64) return -1;
+    uint64_t m = mask >> from;
+    return m ? from + std::countr_zero(m) : -1;
+}
+
+// Days of month (y, m) that match, as bits 1..31.
+uint32_t day_mask(const CronSchedule& s, int y, int m) {
+    int dim = days_in_month(y, m);
+    uint32_t valid = ((uint32_t(1) << dim) - 1) << 1;
+    // Rotate the weekday mask so bit k means "day 1 + k", then tile it.
+    int w1 = weekday(y, m, 1);
+    uint32_t dow = s.days_of_week & 0x7F;
+    uint32_t week = ((dow >> w1) | (dow << (7 - w1))) & 0x7F;
+    uint32_t dowm = (week | week << 7 | week << 14 | week << 21 | week << 28) << 1;
+    uint32_t m_days = (s.dom_restricted && s.dow_restricted) ? (s.days_of_month | dowm)
+                                                             : (s.days_of_month & dowm);
+    return m_days & valid;
+}
+
+struct Civil { int y, mon, d, h, mi, s; };
+
+// First matching civil time at or after c, or false if there is none within
+// the search horizon (which only impossible dates like Feb 30 exhaust).
+bool next_match(const CronSchedule& s, Civil& c) {
+    const int last_year = c.y + 9;   // leap days recur at least every 8 years
+    while (c.y <= last_year) {
+        int mo = next_bit(s.months, c.mon);
+        if (mo < 0) { c = {c.y + 1, 1, 1, 0, 0, 0}; continue; }
+        if (mo != c.mon) c = {c.y, mo, 1, 0, 0, 0};
+
+        int d = next_bit(day_mask(s, c.y, c.mon), c.d);
+        if (d < 0) {
+            c = c.mon == 12 ? Civil{c.y + 1, 1, 1, 0, 0, 0} : Civil{c.y, c.mon + 1, 1, 0, 0, 0};
+            continue;
+        }
+        if (d != c.d) c = {c.y, c.mon, d, 0, 0, 0};
+
+        int h = next_bit(s.hours, c.h);
+        if (h < 0) { c = {c.y, c.mon, c.d + 1, 0, 0, 0}; continue; }
+        if (h != c.h) c = {c.y, c.mon, c.d, h, 0, 0};
+
+        int mi = next_bit(s.minutes, c.mi);
+        if (mi < 0) { c = {c.y, c.mon, c.d, c.h + 1, 0, 0}; continue; }
+        if (mi != c.mi) c = {c.y, c.mon, c.d, c.h, mi, 0};
+
+        int sec = next_bit(s.seconds, c.s);
+        if (sec < 0) { c = {c.y, c.mon, c.d, c.h, c.mi + 1, 0}; continue; }
+        c.s = sec;
+        return true;
+    }
+    return false;
+}
+
+// `from` broken down once; shared by every schedule in a bulk query.
+struct Origin {
+    std::time_t t;
+    std::tm tm;
+    int64_t utc_offset;   // local - UTC, seconds, at `from`
+};
+
+Origin make_origin(std::chrono::system_clock::time_point from) {
+    Origin o;
+    o.t = std::chrono::system_clock::to_time_t(from);
+    if (std::chrono::system_clock::from_time_t(o.t) > from) --o.t;   // floor sub-seconds
+    localtime_r(&o.t, &o.tm);
+    int64_t local = days_from_civil(o.tm.tm_year + 1900, o.tm.tm_mon + 1, o.tm.tm_mday) * 86400 +
+                    o.tm.tm_hour * 3600 + o.tm.tm_min * 60 + o.tm.tm_sec;
+    o.utc_offset = local - static_cast<int64_t>(o.t);
+    return o;
+}
+
+std::chrono::system_clock::time_point next_from(const CronSchedule& s, const Origin& o) {
+    if (!s.valid) return std::chrono::system_clock::time_point::max();
+    Civil c{o.tm.tm_year + 1900, o.tm.tm_mon + 1, o.tm.tm_mday, o.tm.tm_hour, o.tm.tm_min, o.tm.tm_sec + 1};
+    if (!next_match(s, c)) return std::chrono::system_clock::time_point::max();
+
+    // Fast path: assume the UTC offset at `from` still holds, then confirm.
+    int64_t local = days_from_civil(c.y, c.mon, c.d) * 86400 + c.h * 3600 + c.mi * 60 + c.s;
+    std::time_t t = static_cast<std::time_t>(local - o.utc_offset);
+    std::tm check;
+    localtime_r(&t, &check);
+    if (check.tm_hour != c.h || check.tm_min != c.mi || check.tm_mday != c.d) {
+        // A DST transition lies in between: let mktime resolve the offset.
+        std::tm tm{};
+        tm.tm_year = c.y - 1900; tm.tm_mon = c.mon - 1; tm.tm_mday = c.d;
+        tm.tm_hour = c.h; tm.tm_min = c.mi; tm.tm_sec = c.s; tm.tm_isdst = -1;
+        t = std::mktime(&tm);
+        if (t <= o.t) t = o.t + 1;
+    }
+    return std::chrono::system_clock::from_time_t(t);
+}
+
+}  // namespace
+
 CronSchedule parse_cron(const std::string& expr) {
     CronSchedule s;
-    std::istringstream iss(expr);
+    std::string e = expr;
+    if (!e.empty() && e[0] == '@') {
+        const char* m = expand_macro(e);
+        if (!m) return s;
+        e = m;
+    }
+    std::istringstream iss(e);
     std::vector<std::string> f;
     std::string t;
-    while (std::getline(iss, t, ' ')) f.push_back(t);
-    if (f.size() != 5) return s;
-
-    auto parse = [](const std::string& v, int min, int max) -> int {
-        if (v == "*") return -1;
-        if (v.find("*/") == 0) { int step = std::stoi(v.substr(2)); return (step >= min && step <= max) ? step : -1; }
-        return std::stoi(v);
-    };
-
-    try {
-        s.minute = parse(f[0],0,59);
-        s.hour   = parse(f[1],0,23);
-        s.day_of_month = parse(f[2],1,31);
-        s.month = parse(f[3],1,12);
-        s.day_of_week = parse(f[4],0,6);
-        s.valid = true;
-    } catch(...) { s.valid = false; }
+    while (iss >> t) f.push_back(t);
+    if (f.size() == 5) f.insert(f.begin(), "0");
+    if (f.size() != 6) return s;
+
+    uint64_t sec, min, hour, dom, mon, dow;
+    bool star;
+    if (!parse_field(f[0], kSeconds, sec, star) ||
+        !parse_field(f[1], kMinutes, min, star) ||
+        !parse_field(f[2], kHours, hour, star) ||
+        !parse_field(f[3], kDom, dom, s.dom_restricted) ||
+        !parse_field(f[4], kMonths, mon, star) ||
+        !parse_field(f[5], kDow, dow, s.dow_restricted))
+        return s;
+    s.dom_restricted = !s.dom_restricted;
+    s.dow_restricted = !s.dow_restricted;
+    if (dow & (1u << 7)) dow = (dow | 1u) & 0x7F;   // 7 is Sunday too
+
+    s.seconds = sec;
+    s.minutes = min;
+    s.hours = static_cast<uint32_t>(hour);
+    s.days_of_month = static_cast<uint32_t>(dom);
+    s.months = static_cast<uint16_t>(mon);
+    s.days_of_week = static_cast<uint8_t>(dow);
+    s.valid = true;
     return s;
 }
 
-std::chrono::system_clock::time_point next_cron_time(const CronSchedule& s) {
-    auto now = std::chrono::system_clock::now();
-    auto tp = std::chrono::system_clock::to_time_t(now);
-    std::tm tm = *std::localtime(&tp);
-    tm.tm_sec = 0; ++tm.tm_min;
-    if (tm.tm_min >= 60) { tm.tm_min = 0; ++tm.tm_hour; }
-    if (s.minute >= 0) tm.tm_min = s.minute;
-    return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+bool cron_matches(const CronSchedule& s, const std::tm& tm) {
+    if (!s.valid) return false;
+    int y = tm.tm_year + 1900, m = tm.tm_mon + 1;
+    return (s.seconds >> tm.tm_sec & 1) && (s.minutes >> tm.tm_min & 1) &&
+           (s.hours >> tm.tm_hour & 1) && (s.months >> m & 1) &&
+           (day_mask(s, y, m) >> tm.tm_mday & 1);
+}
+
+std::chrono::system_clock::time_point next_cron_time(const CronSchedule& s,
+                                                     std::chrono::system_clock::time_point from) {
+    return next_from(s, make_origin(from));
+}
+
+void next_cron_times(const std::vector<CronSchedule>& schedules,
+                     std::chrono::system_clock::time_point from,
+                     std::vector<std::chrono::system_clock::time_point>& out) {
+    Origin o = make_origin(from);
+    out.resize(schedules.size());
+    for (size_t i = 0; i < schedules.size(); ++i) out[i] = next_from(schedules[i], o);
 }
 
-}  // namespace tf
\ No newline at end of file
+}  // namespace tf
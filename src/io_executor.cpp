@@ -0,0 +1,422 @@
+#include <taskflow/io_executor.hpp>
+#include <taskflow/scheduler.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define TASKFLOW_HAS_IO_URING 1
+#else
+#define TASKFLOW_HAS_IO_URING 0
+#endif
+
+// Requests reach the reaper through the kernel, which ThreadSanitizer cannot
+// see; annotate the handoff.
+#if defined(__SANITIZE_THREAD__)
+extern "C" void __tsan_acquire(void* addr);
+extern "C" void __tsan_release(void* addr);
+#define TASKFLOW_IO_HANDOFF(op, p) __tsan_##op(p)
+#else
+#define TASKFLOW_IO_HANDOFF(op, p) ((void)(p))
+#endif
+
+namespace tf {
+
+namespace detail {
+
+// Hands requests to the kernel, from any thread, and calls their `done`.
+class IoDriver {
+public:
+    virtual ~IoDriver() = default;
+    virtual void start(IoRequest* r) = 0;
+};
+
+static std::system_error io_error(IoRequest::Op op, long res) {
+    static constexpr const char* what[] = {"tf::IoExecutor read", "tf::IoExecutor write",
+                                           "tf::IoExecutor fsync"};
+    return std::system_error(static_cast<int>(-res), std::system_category(), what[op]);
+}
+
+void throw_io_error(IoRequest::Op op, long res) { throw io_error(op, res); }
+
+}  // namespace detail
+
+namespace {
+
+using detail::IoRequest;
+
+// Largest transfer Linux makes in one read or write call.
+constexpr size_t kMaxTransfer = 0x7ffff000;
+
+// A request made as a scheduler task. It detaches the task and drops its
+// detach ref when the transfer is done; the task completes then unless the
+// worker that submitted it has not returned yet.
+struct TaskRequest : IoRequest {
+    Scheduler* sched;
+    ScheduledTask* task = nullptr;
+    TaskHandle self;
+
+    static void finish(IoRequest* base, long res) {
+        auto* r = static_cast<TaskRequest*>(base);
+        ScheduledTask* t = r->task;
+        if (res < 0)
+            t->error = std::make_exception_ptr(detail::io_error(r->op, res));
+        else if (r->op != IoRequest::fsync)
+            t->result.emplace<size_t>(static_cast<size_t>(res));
+        Scheduler* s = r->sched;
+        TaskHandle h = r->self;
+        delete r;
+        if (t->detach_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) detail::complete_detached(*s, h);
+    }
+};
+
+long blocking_call(const IoRequest& r) {
+    long res;
+    do {
+        switch (r.op) {
+        case IoRequest::read: res = ::pread(r.fd, r.buf, r.len, static_cast<off_t>(r.offset)); break;
+        case IoRequest::write: res = ::pwrite(r.fd, r.buf, r.len, static_cast<off_t>(r.offset)); break;
+        default: res = ::fsync(r.fd); break;
+        }
+    } while (res < 0 && errno == EINTR);
+    return res < 0 ? -errno : res;
+}
+
+// Blocking fallback: a queue drained by dedicated threads.
+class ThreadBackend final : public detail::IoDriver {
+public:
+    explicit ThreadBackend(size_t n) {
+        for (size_t i = 0; i < std::max<size_t>(n, 1); ++i) threads_.emplace_back([this] { run(); });
+    }
+    ~ThreadBackend() override {
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    // Notifies under the lock: once r is done, the executor may be gone.
+    void start(IoRequest* r) override {
+        std::lock_guard<std::mutex> lk(mtx_);
+        queue_.push_back(r);
+        cv_.notify_one();
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lk(mtx_);
+        while (true) {
+            cv_.wait(lk, [&] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) return;
+            IoRequest* r = queue_.front();
+            queue_.pop_front();
+            lk.unlock();
+            r->done(r, blocking_call(*r));
+            lk.lock();
+        }
+    }
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::deque<IoRequest*> queue_;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+};
+
+#if TASKFLOW_HAS_IO_URING
+
+int uring_setup(unsigned entries, io_uring_params* p) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+int uring_enter(int fd, unsigned submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, submit, min_complete, flags, nullptr, 0));
+}
+int uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+// True if the ring takes every opcode the backend issues. Kernels before
+// 5.6 have neither the probe nor IORING_OP_READ/WRITE.
+bool supports_ops(int fd) {
+    constexpr unsigned kOps = 256;
+    alignas(io_uring_probe) unsigned char raw[sizeof(io_uring_probe) + kOps * sizeof(io_uring_probe_op)]{};
+    auto* probe = reinterpret_cast<io_uring_probe*>(raw);
+    if (uring_register(fd, IORING_REGISTER_PROBE, probe, kOps) < 0) return false;
+    for (unsigned op : {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_FSYNC})
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+    return true;
+}
+
+template<class T>
+T* at(void* base, uint32_t off) { return reinterpret_cast<T*>(static_cast<char*>(base) + off); }
+
+// A raw io_uring: workers fill submission entries under a lock and enter
+// the kernel themselves; one reaper thread waits for completions. At most
+// `depth` requests are in the kernel, which keeps the completion ring (twice
+// the size) from overflowing; the rest queue in `backlog_`.
+class UringBackend final : public detail::IoDriver {
+public:
+    // Throws std::system_error if the kernel refuses a ring or lacks an
+    // opcode the backend needs.
+    explicit UringBackend(unsigned depth) {
+        io_uring_params p{};
+        fd_ = uring_setup(std::max(depth, 2u), &p);
+        if (fd_ < 0) throw std::system_error(errno, std::system_category(), "io_uring_setup");
+        if (!supports_ops(fd_)) {
+            ::close(fd_);
+            throw std::system_error(EOPNOTSUPP, std::system_category(), "io_uring opcodes");
+        }
+        sq_len_ = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+        cq_len_ = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        const bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) sq_len_ = cq_len_ = std::max(sq_len_, cq_len_);
+        sq_ = map(sq_len_, IORING_OFF_SQ_RING);
+        cq_ = single ? sq_ : map(cq_len_, IORING_OFF_CQ_RING);
+        sqes_len_ = p.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqes_len_, IORING_OFF_SQES));
+        if (!sq_ || !cq_ || !sqes_) {
+            int err = errno;
+            unmap();
+            throw std::system_error(err, std::system_category(), "io_uring mmap");
+        }
+        sq_head_ = at<uint32_t>(sq_, p.sq_off.head);
+        sq_tail_ = at<uint32_t>(sq_, p.sq_off.tail);
+        sq_mask_ = *at<uint32_t>(sq_, p.sq_off.ring_mask);
+        sq_array_ = at<uint32_t>(sq_, p.sq_off.array);
+        cq_head_ = at<uint32_t>(cq_, p.cq_off.head);
+        cq_tail_ = at<uint32_t>(cq_, p.cq_off.tail);
+        cq_mask_ = *at<uint32_t>(cq_, p.cq_off.ring_mask);
+        cqes_ = at<io_uring_cqe>(cq_, p.cq_off.cqes);
+        depth_ = p.sq_entries;
+        reaper_ = std::thread([this] { reap(); });
+    }
+
+    ~UringBackend() override {
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            stopping_ = true;
+            push(nullptr);   // wakes the reaper
+        }
+        reaper_.join();
+        unmap();
+    }
+
+    void start(IoRequest* r) override {
+        int err;
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            if (in_flight_ == depth_) {
+                backlog_.push_back(r);
+                return;
+            }
+            err = submit(r);
+        }
+        if (err) r->done(r, -err);
+    }
+
+private:
+    void* map(size_t len, off_t off) {
+        void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, off);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    void unmap() {
+        if (sqes_) ::munmap(sqes_, sqes_len_);
+        if (cq_ && cq_ != sq_) ::munmap(cq_, cq_len_);
+        if (sq_) ::munmap(sq_, sq_len_);
+        ::close(fd_);
+    }
+
+    // Requires mtx_. Hands r to the kernel and counts it in flight; else
+    // returns the errno, and r is the caller's to complete outside the lock.
+    int submit(IoRequest* r) {
+        int err = push(r);
+        if (!err) ++in_flight_;
+        return err;
+    }
+
+    // Requires mtx_. Without SQPOLL the kernel consumes the entry during
+    // io_uring_enter, so the submission ring never fills up. An enter that
+    // fails outright has consumed nothing: the entry is taken back and the
+    // errno returned.
+    int push(IoRequest* r) {
+        uint32_t tail = *sq_tail_;
+        uint32_t idx = tail & sq_mask_;
+        io_uring_sqe& e = sqes_[idx];
+        std::memset(&e, 0, sizeof e);
+        e.user_data = reinterpret_cast<uint64_t>(r);
+        if (!r) {
+            e.opcode = IORING_OP_NOP;
+        } else {
+            e.fd = r->fd;
+            e.opcode = r->op == IoRequest::read    ? IORING_OP_READ
+                     : r->op == IoRequest::write ? IORING_OP_WRITE
+                                                 : IORING_OP_FSYNC;
+            e.addr = reinterpret_cast<uint64_t>(r->buf);
+            e.len = static_cast<uint32_t>(std::min(r->len, kMaxTransfer));
+            e.off = r->offset;
+        }
+        sq_array_[idx] = idx;
+        TASKFLOW_IO_HANDOFF(release, r);
+        std::atomic_ref<uint32_t>(*sq_tail_).store(tail + 1, std::memory_order_release);
+        while (uring_enter(fd_, 1, 0, 0) < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                std::this_thread::yield();
+                continue;
+            }
+            int err = errno;
+            if (std::atomic_ref<uint32_t>(*sq_head_).load(std::memory_order_acquire) != tail) return 0;
+            std::atomic_ref<uint32_t>(*sq_tail_).store(tail, std::memory_order_release);
+            return err;
+        }
+        return 0;
+    }
+
+    void reap() {
+        std::vector<std::pair<IoRequest*, long>> done, refused;
+        while (true) {
+            uint32_t head = *cq_head_;
+            uint32_t tail = std::atomic_ref<uint32_t>(*cq_tail_).load(std::memory_order_acquire);
+            if (head == tail) {
+                {
+                    std::lock_guard<std::mutex> lk(mtx_);
+                    if (stopping_ && in_flight_ == 0 && backlog_.empty()) return;
+                }
+                uring_enter(fd_, 0, 1, IORING_ENTER_GETEVENTS);   // EINTR just loops
+                continue;
+            }
+            done.clear();
+            for (; head != tail; ++head) {
+                const io_uring_cqe& c = cqes_[head & cq_mask_];
+                done.emplace_back(reinterpret_cast<IoRequest*>(c.user_data), c.res);
+            }
+            std::atomic_ref<uint32_t>(*cq_head_).store(head, std::memory_order_release);
+            size_t finished = 0;
+            for (auto [r, res] : done) {
+                if (!r) continue;
+                TASKFLOW_IO_HANDOFF(acquire, r);
+                ++finished;
+                r->done(r, res);
+            }
+            {
+                std::lock_guard<std::mutex> lk(mtx_);
+                in_flight_ -= finished;
+                while (in_flight_ < depth_ && !backlog_.empty()) {
+                    IoRequest* r = backlog_.front();
+                    backlog_.pop_front();
+                    if (int err = submit(r)) refused.emplace_back(r, -err);
+                }
+            }
+            for (auto [r, res] : refused) r->done(r, res);
+            refused.clear();
+        }
+    }
+
+    int fd_ = -1;
+    void* sq_ = nullptr;
+    void* cq_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sq_len_ = 0, cq_len_ = 0, sqes_len_ = 0;
+    uint32_t* sq_head_ = nullptr;
+    uint32_t* sq_tail_ = nullptr;
+    uint32_t* sq_array_ = nullptr;
+    uint32_t sq_mask_ = 0;
+    uint32_t* cq_head_ = nullptr;
+    uint32_t* cq_tail_ = nullptr;
+    uint32_t cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    std::mutex mtx_;
+    size_t depth_ = 0;
+    size_t in_flight_ = 0;
+    std::deque<IoRequest*> backlog_;
+    bool stopping_ = false;
+    std::thread reaper_;
+};
+
+#endif
+
+}  // namespace
+
+IoExecutor::IoExecutor(Scheduler& s, IoBackend backend, unsigned queue_depth, size_t threads)
+    : sched_(s) {
+#if TASKFLOW_HAS_IO_URING
+    if (backend == IoBackend::io_uring) {
+        try {
+            driver_ = std::make_unique<UringBackend>(queue_depth);
+            backend_ = IoBackend::io_uring;
+            return;
+        } catch (const std::system_error&) {
+        }
+    }
+#else
+    (void)queue_depth;
+#endif
+    driver_ = std::make_unique<ThreadBackend>(threads);
+    backend_ = IoBackend::threads;
+}
+
+IoExecutor::~IoExecutor() = default;
+
+template<class R>
+TaskFuture<R> IoExecutor::submit(IoRequest::Op op, int fd, void* buf, size_t len, uint64_t offset,
+                                 const std::vector<TaskHandle>& deps, const TaskOptions& opts) {
+    auto req = std::make_unique<TaskRequest>();
+    static_cast<IoRequest&>(*req) = {op, fd, buf, len, offset, &TaskRequest::finish};
+    req->sched = &sched_;
+    ScheduledTask st;
+    st.func = [driver = driver_.get(), req = std::move(req)]() mutable {
+        req->task = ScheduledTask::current();
+        req->self = detail::detach_current();
+        driver->start(req.release());
+    };
+    st.next_run = Clock::now();
+    st.dependencies = deps;
+    st.apply(opts);
+    auto [h, t] = sched_.create_pinned(std::move(st));
+    return TaskFuture<R>(sched_, h, t);
+}
+
+TaskFuture<size_t> IoExecutor::read(int fd, std::span<std::byte> buf, uint64_t offset,
+                                    const std::vector<TaskHandle>& deps, const TaskOptions& opts) {
+    return submit<size_t>(IoRequest::read, fd, buf.data(), buf.size(), offset, deps, opts);
+}
+
+TaskFuture<size_t> IoExecutor::write(int fd, std::span<const std::byte> buf, uint64_t offset,
+                                     const std::vector<TaskHandle>& deps, const TaskOptions& opts) {
+    return submit<size_t>(IoRequest::write, fd, const_cast<std::byte*>(buf.data()), buf.size(), offset,
+                          deps, opts);
+}
+
+TaskFuture<void> IoExecutor::fsync(int fd, const std::vector<TaskHandle>& deps, const TaskOptions& opts) {
+    return submit<void>(IoRequest::fsync, fd, nullptr, 0, 0, deps, opts);
+}
+
+void IoAwaiter::submit() { io_->driver_->start(this); }
+
+// Everything is read out of the awaiter before the resumption is queued: the
+// coroutine may run, and free the frame holding it, before enqueue returns.
+void IoAwaiter::resume(IoRequest* r, long res) {
+    auto* a = static_cast<IoAwaiter*>(r);
+    a->res_ = res;
+    ThreadPool* pool = a->pool_;
+    detail::Resume job(a->h_, a->root_, a->task_);
+    Priority priority = a->priority_;
+    TimePoint deadline = a->deadline_ == Duration::max() ? TimePoint::max() : Clock::now() + a->deadline_;
+    if (pool) pool->enqueue(UniqueTask(std::move(job)), priority, deadline);
+    else job();
+}
+
+}  // namespace tf
@@ -0,0 +1,86 @@
+#include <taskflow/pipeline.hpp>
+#include <taskflow/task_future.hpp>
+
+namespace tf::detail {
+
+void PipelineCore::start(Scheduler& s) {
+    pool_ = ThreadPool::current();
+    sched_ = &s;
+    task_ = ScheduledTask::current();
+    self_ = detach_current();
+    for (auto& st : stages)
+        st->limit = st->mode == StageMode::parallel ? static_cast<int>(pool_->size()) : 1;
+    refs_.store(1, std::memory_order_relaxed);   // dropped once the last item retires
+    wake(0);
+}
+
+void PipelineCore::wake(size_t k) {
+    Stage& st = *stages[k];
+    int a = st.active.load(std::memory_order_relaxed);
+    while (a < st.limit) {
+        if (st.active.compare_exchange_weak(a, a + 1, std::memory_order_seq_cst)) {
+            refs_.fetch_add(1, std::memory_order_relaxed);
+            pool_->enqueue([this, k] { pump(k); });
+            return;
+        }
+    }
+}
+
+// Pairs with pushed(): either the producer sees this pump still active, or
+// the pump sees the new item after stepping down.
+void PipelineCore::pump(size_t k) {
+    Stage& st = *stages[k];
+    while (true) {
+        while (st.step()) {}
+        st.active.fetch_sub(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!st.has_input()) break;
+        int a = st.active.load(std::memory_order_relaxed);
+        if (a >= st.limit || !st.active.compare_exchange_strong(a, a + 1, std::memory_order_seq_cst))
+            break;
+    }
+    release();
+}
+
+bool PipelineCore::claim() {
+    if (live_.load(std::memory_order_relaxed) >= tokens_) return false;
+    live_.fetch_add(1, std::memory_order_seq_cst);
+    return true;
+}
+
+void PipelineCore::retire() {
+    if (live_.fetch_sub(1, std::memory_order_seq_cst) == 1 && exhausted_.load(std::memory_order_seq_cst))
+        finish_once();
+    else if (!exhausted_.load(std::memory_order_relaxed))
+        wake(0);
+}
+
+void PipelineCore::exhaust() {
+    if (!exhausted_.exchange(true, std::memory_order_seq_cst) &&
+        live_.load(std::memory_order_seq_cst) == 0)
+        finish_once();
+}
+
+void PipelineCore::fail(std::exception_ptr e) {
+    if (failed_.exchange(true)) return;
+    error_ = std::move(e);
+    // Wake everything so queued and parked items are dropped.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (size_t k = 0; k < stages.size(); ++k) wake(k);
+}
+
+void PipelineCore::finish_once() {
+    if (!finished_.exchange(true)) release();
+}
+
+void PipelineCore::release() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    // Last touch: completing the task may free this pipeline.
+    ScheduledTask* t = task_;
+    Scheduler* s = sched_;
+    TaskHandle h = self_;
+    if (error_) t->error = error_;
+    if (t->detach_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) complete_detached(*s, h);
+}
+
+}  // namespace tf::detail
@@ -0,0 +1,66 @@
+#include <taskflow/resource_group.hpp>
+#include <algorithm>
+
+namespace tf {
+
+ResourceGroup::ResourceGroup(size_t max_in_flight, double per_second, double burst)
+    : max_(max_in_flight), rate_(per_second), burst_(std::max(burst, 1.0)),
+      tokens_(burst_), refilled_(std::chrono::steady_clock::now()) {}
+
+size_t ResourceGroup::in_flight() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return in_flight_;
+}
+
+size_t ResourceGroup::waiting() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return waiting_.size();
+}
+
+bool ResourceGroup::take_token(TimePoint now, TimePoint& retry) {
+    if (rate_ <= 0) return true;
+    if (now > refilled_) {
+        tokens_ = std::min(burst_, tokens_ + rate_ * std::chrono::duration<double>(now - refilled_).count());
+        refilled_ = now;
+    }
+    if (tokens_ >= 1) {
+        tokens_ -= 1;
+        return true;
+    }
+    retry = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>((1 - tokens_) / rate_));
+    return false;
+}
+
+bool ResourceGroup::acquire(ThreadPool::Work* w, TimePoint now, TimePoint& retry) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (max_ && in_flight_ >= max_) {
+        waiting_.push_back(w);
+        retry = TimePoint::max();
+        return false;
+    }
+    if (!take_token(now, retry)) return false;
+    ++in_flight_;
+    return true;
+}
+
+ThreadPool::Work* ResourceGroup::release(TimePoint now, TimePoint& retry) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    --in_flight_;
+    if (waiting_.empty()) return nullptr;
+    ThreadPool::Work* w = waiting_.front();
+    waiting_.pop_front();
+    retry = TimePoint::max();
+    if (take_token(now, retry)) ++in_flight_;
+    return w;
+}
+
+bool ResourceGroup::drop(ThreadPool::Work* w) {
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto it = std::find(waiting_.begin(), waiting_.end(), w);
+    if (it == waiting_.end()) return false;
+    waiting_.erase(it);
+    return true;
+}
+
+}  // namespace tf
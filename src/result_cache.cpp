@@ -0,0 +1,318 @@
+#include <taskflow/result_cache.hpp>
+#include <taskflow/task_graph.hpp>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace tf {
+
+namespace {
+
+constexpr uint64_t c1 = 0x87c37b91114253d5ull, c2 = 0x4cf5ad432745937full;
+
+uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+uint64_t fmix(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ull;
+    k ^= k >> 33;
+    return k;
+}
+
+// Maps path read-only; an empty blob for an empty file, nullopt if missing.
+std::optional<CacheBlob> map_file(const std::filesystem::path& path, CacheBlob (*make)(std::shared_ptr<const void>, const char*, size_t)) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return std::nullopt;
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+    void* p = size ? ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+    ::close(fd);
+    if (p == MAP_FAILED) return std::nullopt;
+    if (!p) return CacheBlob();
+    std::shared_ptr<const void> owner(p, [size](const void* q) { ::munmap(const_cast<void*>(q), size); });
+    return make(std::move(owner), static_cast<const char*>(p), size);
+}
+
+bool write_file(const std::filesystem::path& path, std::string_view bytes) {
+    static std::atomic<uint64_t> seq{0};
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    // Written aside and renamed into place, so readers never see a partial file.
+    auto tmp = path;
+    tmp += ".tmp." + std::to_string(::getpid()) + "." + std::to_string(seq.fetch_add(1));
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+    size_t done = 0;
+    while (done < bytes.size()) {
+        ssize_t n = ::write(fd, bytes.data() + done, bytes.size() - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        done += static_cast<size_t>(n);
+    }
+    bool ok = ::close(fd) == 0 && done == bytes.size();
+    if (ok) ok = ::rename(tmp.c_str(), path.c_str()) == 0;
+    if (!ok) ::unlink(tmp.c_str());
+    return ok;
+}
+
+}  // namespace
+
+std::string CacheKey::hex() const {
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string s(32, '0');
+    for (int i = 0; i < 16; ++i) {
+        s[15 - i] = digits[(hi >> (4 * i)) & 0xf];
+        s[31 - i] = digits[(lo >> (4 * i)) & 0xf];
+    }
+    return s;
+}
+
+// Two-lane block mix after MurmurHash3 x64-128, eight bytes at a time.
+void KeyHasher::mix(uint64_t w) {
+    a_ ^= rotl(w * c1, 31) * c2;
+    a_ = (rotl(a_, 27) + b_) * 5 + 0x52dce729;
+    b_ ^= rotl(w * c2, 33) * c1;
+    b_ = (rotl(b_, 31) + a_) * 5 + 0x38495ab5;
+}
+
+KeyHasher& KeyHasher::update(std::string_view bytes) {
+    size_t i = 0;
+    for (; i < bytes.size() && len_ % 8; ++i, ++len_) {
+        tail_ |= uint64_t{static_cast<uint8_t>(bytes[i])} << (8 * (len_ % 8));
+        if (len_ % 8 == 7) {
+            mix(tail_);
+            tail_ = 0;
+        }
+    }
+    for (; i + 8 <= bytes.size(); i += 8, len_ += 8) {
+        uint64_t w;
+        std::memcpy(&w, bytes.data() + i, 8);
+        mix(w);
+    }
+    for (; i < bytes.size(); ++i, ++len_)
+        tail_ |= uint64_t{static_cast<uint8_t>(bytes[i])} << (8 * (len_ % 8));
+    return *this;
+}
+
+KeyHasher& KeyHasher::update(const CacheKey& k) {
+    uint64_t w[2] = {k.hi, k.lo};
+    return update(std::string_view(reinterpret_cast<const char*>(w), sizeof w));
+}
+
+CacheKey KeyHasher::finish() const {
+    uint64_t a = a_ ^ rotl(tail_ * c1, 31) * c2 ^ len_;
+    uint64_t b = b_ ^ rotl(tail_ * c2, 33) * c1 ^ len_;
+    a += b;
+    b += a;
+    a = fmix(a);
+    b = fmix(b);
+    a += b;
+    b += a;
+    return {a, b};
+}
+
+CacheKey content_hash(std::string_view bytes) { return KeyHasher().update(bytes).finish(); }
+
+CacheKey file_hash(const std::filesystem::path& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st{};
+    if (fd < 0 || ::fstat(fd, &st) != 0) {
+        int err = errno;
+        if (fd >= 0) ::close(fd);
+        throw std::system_error(err, std::system_category(), "file_hash: " + path.string());
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+    KeyHasher h;
+    if (size) {
+        void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            int err = errno;
+            ::close(fd);
+            throw std::system_error(err, std::system_category(), "file_hash: " + path.string());
+        }
+        h.update(std::string_view(static_cast<const char*>(p), size));
+        ::munmap(p, size);
+    }
+    ::close(fd);
+    return h.finish();
+}
+
+CacheBlob::CacheBlob(std::string bytes) {
+    auto s = std::make_shared<const std::string>(std::move(bytes));
+    data_ = s->data();
+    size_ = s->size();
+    owner_ = std::move(s);
+}
+
+size_t CachedRun::executed() const {
+    size_t n = 0;
+    for (size_t i = 0; i < keys.size(); ++i) n += keys[i] && !hits[i];
+    return n;
+}
+
+ResultCache::ResultCache(size_t memory_bytes, std::filesystem::path dir)
+    : capacity_(memory_bytes), dir_(std::move(dir)) {
+    if (!dir_.empty()) std::filesystem::create_directories(dir_);
+}
+
+// Fanned out over 256 subdirectories by the first byte of the key.
+std::filesystem::path ResultCache::file(const CacheKey& key) const {
+    auto h = key.hex();
+    return dir_ / h.substr(0, 2) / h.substr(2);
+}
+
+std::optional<CacheBlob> ResultCache::get(const CacheKey& key) {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (auto it = index_.find(key); it != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            ++stats_.hits;
+            return it->second->second;
+        }
+        if (dir_.empty()) {
+            ++stats_.misses;
+            return std::nullopt;
+        }
+    }
+    auto blob = map_file(file(key), [](std::shared_ptr<const void> owner, const char* data, size_t size) {
+        return CacheBlob(std::move(owner), data, size);
+    });
+    std::lock_guard<std::mutex> lk(mtx_);
+    if (!blob) {
+        ++stats_.misses;
+        return std::nullopt;
+    }
+    ++stats_.disk_hits;
+    remember(key, *blob);
+    return blob;
+}
+
+bool ResultCache::contains(const CacheKey& key) const {
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (index_.count(key)) return true;
+    }
+    std::error_code ec;
+    return !dir_.empty() && std::filesystem::exists(file(key), ec);
+}
+
+CacheBlob ResultCache::put(const CacheKey& key, std::string bytes) {
+    CacheBlob blob(std::move(bytes));
+    if (!dir_.empty()) write_file(file(key), blob.bytes());
+    std::lock_guard<std::mutex> lk(mtx_);
+    remember(key, blob);
+    return blob;
+}
+
+void ResultCache::remember(const CacheKey& key, CacheBlob blob) {
+    if (auto it = index_.find(key); it != index_.end()) {
+        stats_.memory_bytes -= it->second->second.size();
+        lru_.erase(it->second);
+    }
+    stats_.memory_bytes += blob.size();
+    lru_.emplace_front(key, std::move(blob));
+    index_[key] = lru_.begin();
+    // The newest entry stays even if it alone is over budget.
+    while (stats_.memory_bytes > capacity_ && lru_.size() > 1) {
+        auto& [k, b] = lru_.back();
+        stats_.memory_bytes -= b.size();
+        index_.erase(k);
+        lru_.pop_back();
+        ++stats_.evictions;
+    }
+}
+
+ResultCache::Stats ResultCache::stats() const {
+    std::lock_guard<std::mutex> lk(mtx_);
+    return stats_;
+}
+
+CachedRun ResultCache::bind(TaskGraph& g, ResultCache* cache) {
+    using NodeId = TaskGraph::NodeId;
+    auto& nodes = g.nodes_;
+    const size_t n = nodes.size();
+    CachedRun run;
+    run.keys.resize(n);
+    run.hits.resize(n);
+    bool any = false;
+    for (auto& node : nodes) any = any || static_cast<bool>(node.cached);
+    if (!any) return run;
+
+    struct State {
+        ResultCache* cache;
+        std::vector<std::vector<NodeId>> preds;   // cached ones, by id
+        std::vector<CacheKey> keys;
+        std::vector<std::optional<CacheBlob>> out;
+        std::vector<std::string> names;
+    };
+    auto st = std::make_shared<State>();
+    st->cache = cache;
+    st->preds.resize(n);
+    st->out.resize(n);
+    for (NodeId i = 0; i < n; ++i)
+        if (nodes[i].cached)
+            for (NodeId s : nodes[i].successors)
+                if (nodes[s].cached) st->preds[s].push_back(i);
+
+    auto order = g.topological_order();
+    for (NodeId i : order) {
+        auto& node = nodes[i];
+        if (!node.cached) continue;
+        KeyHasher h;
+        const uint64_t len = node.name.size();
+        h.update(std::string_view(reinterpret_cast<const char*>(&len), sizeof len)).update(node.name);
+        h.update(node.input);
+        for (NodeId p : st->preds[i]) h.update(run.keys[p]);
+        run.keys[i] = h.finish();
+        run.hits[i] = cache && cache->contains(run.keys[i]);
+    }
+    // Load the hits that a node about to run reads. One that has vanished
+    // since contains() has to run after all; it comes later in this walk,
+    // so its own inputs get loaded too.
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        if (!nodes[*it].cached || run.hits[*it]) continue;
+        for (NodeId p : st->preds[*it]) {
+            if (!run.hits[p] || st->out[p]) continue;
+            st->out[p] = cache->get(run.keys[p]);
+            if (!st->out[p]) run.hits[p] = false;
+        }
+    }
+    st->keys = run.keys;
+    st->names.resize(n);
+    for (NodeId i = 0; i < n; ++i) {
+        auto& node = nodes[i];
+        if (!node.cached) continue;
+        if (run.hits[i]) {
+            node.hit = true;
+            node.fn = [] {};
+            node.cached = {};
+            continue;
+        }
+        st->names[i] = node.name;
+        node.fn = [st, i, f = std::move(node.cached)]() mutable {
+            std::vector<CacheBlob> in;
+            in.reserve(st->preds[i].size());
+            for (NodeId p : st->preds[i]) {
+                if (!st->out[p]) throw std::runtime_error("TaskGraph: no result from '" + st->names[p] + "'");
+                in.push_back(*st->out[p]);
+            }
+            std::string r = f(CacheInputs(in));
+            st->out[i] = st->cache ? st->cache->put(st->keys[i], std::move(r)) : CacheBlob(std::move(r));
+        };
+    }
+    return run;
+}
+
+}  // namespace tf
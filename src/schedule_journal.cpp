@@ -0,0 +1,580 @@
+#include <taskflow/schedule_journal.hpp>
+#include <taskflow/scheduler.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace tf {
+
+namespace {
+
+using SysClock = std::chrono::system_clock;
+
+// File layout: a 16-byte header, then records back to back, each a multiple
+// of 8 bytes long. The mapping extends past the last record and reads as
+// zeros there, which is how the end is found.
+constexpr char kMagic[8] = {'T', 'F', 'J', 'R', 'N', 'L', '0', '2'};
+constexpr size_t kFileHeader = 16;
+constexpr size_t kMinMap = size_t{1} << 20;
+constexpr int64_t kNever = std::numeric_limits<int64_t>::max();
+
+enum RecType : uint8_t { rec_add = 1, rec_ran = 2, rec_cancel = 3 };
+enum Kind : uint8_t { kind_once, kind_every, kind_cron };
+
+struct RecHeader {
+    uint32_t size;    // whole record; zero past the end of the journal
+    uint32_t check;   // over the rest of the record
+    uint8_t type, kind, priority, flags;   // flags: cron dom/dow restricted
+    uint16_t name_len, cron_len;
+    uint64_t id;
+};
+static_assert(sizeof(RecHeader) == 24);
+
+// After an add header; the name and the cron text follow.
+struct AddBody {
+    int64_t due_ns, interval_ns, deadline_ns;
+    uint64_t seconds, minutes;
+    uint32_t hours, days_of_month;
+    uint16_t months;
+    uint8_t days_of_week, rate, misfire, pad[3];
+    uint32_t catch_up, max_concurrency;   // Recurrence
+};
+static_assert(sizeof(AddBody) == 64);
+
+int64_t to_ns(SysClock::time_point tp) {
+    if (tp == SysClock::time_point::max()) return kNever;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count();
+}
+
+int64_t to_ns(Duration d) {
+    if (d == Duration::max()) return kNever;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+}
+
+Duration to_duration(int64_t ns) {
+    if (ns == kNever) return Duration::max();
+    return std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(ns));
+}
+
+size_t record_size(size_t body, size_t name, size_t cron) {
+    return (sizeof(RecHeader) + body + name + cron + 7) & ~size_t{7};
+}
+
+uint32_t checksum(const char* rec, size_t size) {
+    return static_cast<uint32_t>(content_hash(std::string_view(rec + 8, size - 8)).lo);
+}
+
+[[noreturn]] void throw_errno(const std::string& what) {
+    throw std::system_error(errno, std::system_category(), "ScheduleJournal: " + what);
+}
+
+}  // namespace
+
+struct ScheduleJournal::State : std::enable_shared_from_this<State> {
+    struct Job {
+        Kind kind;
+        std::string name, cron_expr;
+        CronSchedule cron;
+        int64_t due_ns = 0, interval_ns = 0, deadline_ns = kNever;
+        Priority priority = Priority::normal;
+        Recurrence recurrence;
+        std::shared_ptr<ResourceGroup> group;   // not journaled
+        TaskHandle handle;                      // invalid until scheduled
+
+        TaskOptions options() const {
+            TaskOptions o;
+            o.priority = priority;
+            o.deadline = to_duration(deadline_ns);
+            o.group = group;
+            o.recurrence = recurrence;
+            return o;
+        }
+    };
+
+    State(Scheduler& s, std::filesystem::path p, JournalOptions o)
+        : sched(s), path(std::move(p)), opts(o) {}
+
+    ~State() {
+        if (map) ::munmap(map, cap);
+        // Trim the unused tail, but only of a file open() accepted.
+        if (opened && ::ftruncate(fd, static_cast<off_t>(tail)) != 0) {}
+        if (fd >= 0) ::close(fd);
+    }
+
+    Scheduler& sched;
+    const std::filesystem::path path;
+    const JournalOptions opts;
+    mutable std::mutex mtx;
+    int fd = -1;
+    bool opened = false;   // set once open() has checked and mapped the file
+    char* map = nullptr;
+    size_t cap = 0, tail = kFileHeader;
+    size_t live_bytes = 0;   // what compaction would write
+    size_t torn = 0;
+    std::unordered_map<JobId, Job> jobs;
+    std::unordered_map<std::string, Task> code;
+    JobId next_id = 1;
+
+    static Job job(Kind kind, const std::string& name, const TaskOptions& opts) {
+        Job j;
+        j.kind = kind;
+        j.name = name;
+        j.deadline_ns = to_ns(opts.deadline);
+        j.priority = opts.priority;
+        j.recurrence = opts.recurrence;
+        j.group = opts.group;
+        return j;
+    }
+
+    static size_t add_size(const Job& j) { return record_size(sizeof(AddBody), j.name.size(), j.cron_expr.size()); }
+
+    void open() {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) throw_errno("open " + path.string());
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) throw_errno("stat " + path.string());
+        const auto size = static_cast<size_t>(st.st_size);
+        if (size == 0) {
+            grow(kMinMap);
+            std::memcpy(map, kMagic, sizeof kMagic);
+            opened = true;
+            return;
+        }
+        // Check before grow() resizes the file: anything else is left as is.
+        char magic[sizeof kMagic];
+        if (size < kFileHeader || ::pread(fd, magic, sizeof magic, 0) != static_cast<ssize_t>(sizeof magic) ||
+            std::memcmp(magic, kMagic, sizeof kMagic) != 0)
+            throw std::runtime_error("ScheduleJournal: not a journal: " + path.string());
+        grow(std::max(size, kMinMap));
+        opened = true;
+        // Read front to back once: prefetch, and size the table for the
+        // records that are there rather than rehashing on the way.
+        ::madvise(map, size, MADV_WILLNEED);
+        jobs.reserve(size / record_size(sizeof(AddBody), 8, 0));
+        replay();
+    }
+
+    // Extends the file to at least `need` bytes and maps all of it.
+    void grow(size_t need) {
+        size_t n = std::max(cap * 2, kMinMap);
+        while (n < need) n *= 2;
+        if (::ftruncate(fd, static_cast<off_t>(n)) != 0) throw_errno("grow " + path.string());
+        void* p = ::mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) throw_errno("mmap " + path.string());
+        if (map) ::munmap(map, cap);
+        map = static_cast<char*>(p);
+        cap = n;
+    }
+
+    void replay() {
+        size_t off = kFileHeader;
+        while (off + sizeof(RecHeader) <= cap) {
+            RecHeader h;
+            std::memcpy(&h, map + off, sizeof h);
+            if (h.size == 0) break;
+            if (h.size % 8 || h.size < sizeof h || h.size > cap - off || h.check != checksum(map + off, h.size)) {
+                // Cut short by a crash: drop it so appends start clean.
+                torn = std::min<size_t>(h.size, cap - off);
+                std::memset(map + off, 0, std::max(torn, sizeof h));
+                break;
+            }
+            apply(h, map + off + sizeof h);
+            off += h.size;
+        }
+        tail = off;
+    }
+
+    void apply(const RecHeader& h, const char* body) {
+        next_id = std::max(next_id, h.id + 1);
+        auto it = jobs.find(h.id);
+        switch (h.type) {
+        case rec_add: {
+            AddBody b;
+            std::memcpy(&b, body, sizeof b);
+            if (it != jobs.end()) live_bytes -= add_size(it->second);
+            else it = jobs.try_emplace(h.id).first;
+            Job& j = it->second;
+            j.kind = static_cast<Kind>(h.kind);
+            j.name.assign(body + sizeof b, h.name_len);
+            j.cron_expr.assign(body + sizeof b + h.name_len, h.cron_len);
+            j.due_ns = b.due_ns;
+            j.interval_ns = b.interval_ns;
+            j.deadline_ns = b.deadline_ns;
+            j.priority = static_cast<Priority>(h.priority);
+            j.recurrence = {static_cast<Rate>(b.rate), static_cast<Misfire>(b.misfire), b.catch_up,
+                            b.max_concurrency};
+            if (j.kind == kind_cron) {
+                j.cron = {b.seconds, b.minutes, b.hours, b.days_of_month, b.months, b.days_of_week,
+                          (h.flags & 1) != 0, (h.flags & 2) != 0, true};
+            } else {
+                j.cron = {};
+            }
+            live_bytes += add_size(j);
+            break;
+        }
+        case rec_ran: {
+            if (it == jobs.end()) break;
+            std::memcpy(&it->second.due_ns, body, sizeof(int64_t));
+            if (it->second.due_ns == 0) forget(it);
+            break;
+        }
+        case rec_cancel:
+            if (it != jobs.end()) forget(it);
+            break;
+        }
+    }
+
+    void forget(std::unordered_map<JobId, Job>::iterator it) {
+        live_bytes -= add_size(it->second);
+        jobs.erase(it);
+    }
+
+    // Requires mtx.
+    size_t put(char* at, RecHeader h, const void* body, size_t body_len, std::string_view name,
+               std::string_view cron) {
+        h.size = static_cast<uint32_t>(record_size(body_len, name.size(), cron.size()));
+        h.name_len = static_cast<uint16_t>(name.size());
+        h.cron_len = static_cast<uint16_t>(cron.size());
+        char* p = at + sizeof h;
+        for (std::string_view part : {std::string_view(static_cast<const char*>(body), body_len), name, cron}) {
+            if (part.empty()) continue;
+            std::memcpy(p, part.data(), part.size());
+            p += part.size();
+        }
+        std::memset(p, 0, at + h.size - p);
+        std::memcpy(at, &h, sizeof h);
+        h.check = checksum(at, h.size);
+        std::memcpy(at + offsetof(RecHeader, check), &h.check, sizeof h.check);
+        return h.size;
+    }
+
+    size_t put_add(char* at, JobId id, const Job& j) {
+        RecHeader h{};
+        h.type = rec_add;
+        h.kind = j.kind;
+        h.priority = static_cast<uint8_t>(j.priority);
+        h.flags = static_cast<uint8_t>(j.cron.dom_restricted | (j.cron.dow_restricted << 1));
+        h.id = id;
+        AddBody b{j.due_ns, j.interval_ns, j.deadline_ns, j.cron.seconds, j.cron.minutes,
+                  j.cron.hours, j.cron.days_of_month, j.cron.months, j.cron.days_of_week,
+                  static_cast<uint8_t>(j.recurrence.rate), static_cast<uint8_t>(j.recurrence.misfire), {},
+                  j.recurrence.catch_up, j.recurrence.max_concurrency};
+        return put(at, h, &b, sizeof b, j.name, j.cron_expr);
+    }
+
+    // Requires mtx. Makes room for `size` more bytes, compacting first if
+    // that is due.
+    char* reserve(size_t size) {
+        if (opts.compact_bytes && tail >= opts.compact_bytes && tail - kFileHeader > 2 * live_bytes)
+            compact();
+        if (tail + size > cap) grow(tail + size);
+        return map + tail;
+    }
+
+    void append_add(JobId id, const Job& j) {
+        char* at = reserve(add_size(j));
+        tail += put_add(at, id, j);
+    }
+
+    void append(RecType type, JobId id, int64_t due) {
+        char* at = reserve(record_size(type == rec_ran ? sizeof due : 0, 0, 0));
+        RecHeader h{};
+        h.type = type;
+        h.id = id;
+        tail += put(at, h, &due, type == rec_ran ? sizeof due : 0, {}, {});
+    }
+
+    // Requires mtx. Writes the live jobs to a new file and swaps it in.
+    void compact() {
+        auto tmp = path;
+        tmp += ".compact";
+        int nfd = ::open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (nfd < 0) throw_errno("open " + tmp.string());
+        const size_t need = kFileHeader + live_bytes;
+        size_t n = kMinMap;
+        while (n < need + need / 2) n *= 2;
+        void* p = ::ftruncate(nfd, static_cast<off_t>(n)) == 0
+            ? ::mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_SHARED, nfd, 0) : MAP_FAILED;
+        if (p == MAP_FAILED) {
+            int err = errno;
+            ::close(nfd);
+            ::unlink(tmp.c_str());
+            throw std::system_error(err, std::system_category(), "ScheduleJournal: compact " + path.string());
+        }
+        char* nmap = static_cast<char*>(p);
+        std::memcpy(nmap, kMagic, sizeof kMagic);
+        size_t off = kFileHeader;
+        for (auto& [id, j] : jobs) off += put_add(nmap + off, id, j);
+        // On disk before it replaces the old journal.
+        ::msync(nmap, off, MS_SYNC);
+        if (::rename(tmp.c_str(), path.c_str()) != 0) {
+            int err = errno;
+            ::munmap(nmap, n);
+            ::close(nfd);
+            ::unlink(tmp.c_str());
+            throw std::system_error(err, std::system_category(), "ScheduleJournal: compact " + path.string());
+        }
+        ::munmap(map, cap);
+        ::close(fd);
+        fd = nfd;
+        map = nmap;
+        cap = n;
+        tail = off;
+    }
+
+    // Requires mtx. Hands job `id` to the scheduler, first run at `due_ns`.
+    void start(JobId id, Job& j, int64_t due_ns, TimePoint steady_now, int64_t now_ns) {
+        const Task* fn = &code.find(j.name)->second;
+        ScheduledTask st;
+        st.next_run = due_ns == kNever ? TimePoint::max()
+                                       : steady_now + to_duration(std::max<int64_t>(due_ns - now_ns, 0));
+        st.recurring = j.kind != kind_once;
+        st.recurrence = j.recurrence;
+        if (j.kind == kind_every) st.interval = to_duration(j.interval_ns);
+        if (j.kind == kind_cron) {
+            st.cron = j.cron;
+            st.cron_expr = j.cron_expr;
+        }
+        st.name = j.name;
+        j.handle = launch(sched, std::move(st), [self = shared_from_this(), id, fn] { self->run(id, *fn); },
+                          j.options());
+    }
+
+    // One-shot that makes up `runs` missed runs of j now.
+    void catch_up(const Job& j, size_t runs) {
+        ScheduledTask st;
+        st.next_run = Clock::now();
+        st.name = j.name;
+        launch(sched, std::move(st), [fn = &code.find(j.name)->second, runs] {
+            for (size_t i = 0; i < runs; ++i) (*fn)();
+        }, j.options());
+    }
+
+    // The scheduled task of job `id`: runs the code unless the job is gone,
+    // then journals when it is due next, the same time the scheduler
+    // computes for it.
+    void run(JobId id, const Task& fn) {
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            if (!jobs.count(id)) return;   // canceled
+        }
+        std::exception_ptr err;
+        try {
+            fn();
+        } catch (...) {
+            err = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            auto it = jobs.find(id);
+            if (it != jobs.end()) {
+                Job& j = it->second;
+                j.due_ns = j.kind == kind_once ? 0
+                         : j.kind == kind_every ? next_every(j, to_ns(SysClock::now()))
+                                                : to_ns(next_cron_time(j.cron));
+                append(rec_ran, id, j.due_ns);
+                if (j.kind == kind_once) forget(it);
+            }
+        }
+        if (err) std::rethrow_exception(err);
+    }
+
+    // Next due time of an interval job that has just run: an interval from
+    // now, or for a fixed rate the first tick of its grid after now.
+    static int64_t next_every(const Job& j, int64_t now) {
+        if (j.recurrence.rate != Rate::fixed_rate) return now + j.interval_ns;
+        const int64_t iv = std::max<int64_t>(j.interval_ns, 1);
+        return now < j.due_ns ? j.due_ns + iv : j.due_ns + ((now - j.due_ns) / iv + 1) * iv;
+    }
+
+    JobId add(Job j) {
+        if (j.name.size() > 0xffff || j.cron_expr.size() > 0xffff)
+            throw std::invalid_argument("ScheduleJournal: name too long");
+        std::lock_guard<std::mutex> lk(mtx);
+        if (!code.count(j.name)) throw std::invalid_argument("ScheduleJournal: no code bound to '" + j.name + "'");
+        JobId id = next_id++;
+        append_add(id, j);
+        live_bytes += add_size(j);
+        auto& job = jobs.emplace(id, std::move(j)).first->second;
+        start(id, job, job.due_ns, Clock::now(), to_ns(SysClock::now()));
+        return id;
+    }
+};
+
+ScheduleJournal::ScheduleJournal(Scheduler& s, std::filesystem::path file, JournalOptions opts)
+    : st_(std::make_shared<State>(s, std::move(file), opts)) {
+    st_->open();
+}
+
+ScheduleJournal::~ScheduleJournal() = default;
+
+TaskHandle ScheduleJournal::launch(Scheduler& s, ScheduledTask&& st, Task fn, const TaskOptions& opts) {
+    if (st.recurring) {
+        s.set_recurring(st, std::move(fn), opts);
+    } else {
+        st.apply(opts);
+        st.func = std::move(fn);
+    }
+    return s.create_task(std::move(st));
+}
+
+void ScheduleJournal::bind(std::string name, Task fn) {
+    std::lock_guard<std::mutex> lk(st_->mtx);
+    if (!st_->code.emplace(std::move(name), std::move(fn)).second)
+        throw std::invalid_argument("ScheduleJournal: name bound twice");
+}
+
+RecoveryStats ScheduleJournal::recover() {
+    auto& s = *st_;
+    std::lock_guard<std::mutex> lk(s.mtx);
+    RecoveryStats stats;
+    stats.torn_bytes = std::exchange(s.torn, 0);
+    const auto steady_now = Clock::now();
+    const int64_t now = to_ns(SysClock::now());
+    const auto policy = s.opts.catchup;
+    auto runs_for = [&](size_t missed) {
+        return policy == Catchup::skip ? 0 : policy == Catchup::once ? 1 : std::min(missed, s.opts.max_catchup);
+    };
+    // Overdue cron jobs get their next times in one batch below.
+    std::vector<std::pair<JobId, State::Job*>> overdue;
+    std::vector<CronSchedule> crons;
+    std::vector<JobId> dropped;
+
+    for (auto& [id, j] : s.jobs) {
+        if (j.handle.is_valid()) continue;
+        ++stats.jobs;
+        if (!s.code.count(j.name)) {
+            ++stats.unbound;
+            continue;
+        }
+        ++stats.scheduled;
+        if (j.due_ns > now) {
+            s.start(id, j, j.due_ns, steady_now, now);
+            continue;
+        }
+        ++stats.missed;
+        switch (j.kind) {
+        case kind_once:
+            if (policy == Catchup::skip) {
+                dropped.push_back(id);
+                --stats.scheduled;
+            } else {
+                s.start(id, j, now, steady_now, now);
+            }
+            break;
+        case kind_every: {
+            const int64_t iv = std::max<int64_t>(j.interval_ns, 1);
+            const auto missed = static_cast<size_t>((now - j.due_ns) / iv + 1);
+            if (size_t runs = runs_for(missed)) s.catch_up(j, runs);
+            j.due_ns += static_cast<int64_t>(missed) * iv;   // keeps the phase
+            s.start(id, j, j.due_ns, steady_now, now);
+            break;
+        }
+        case kind_cron:
+            overdue.emplace_back(id, &j);
+            crons.push_back(j.cron);
+            break;
+        }
+    }
+    if (!overdue.empty()) {
+        std::vector<SysClock::time_point> next;
+        next_cron_times(crons, SysClock::time_point(std::chrono::nanoseconds(now)), next);
+        for (size_t i = 0; i < overdue.size(); ++i) {
+            auto& [id, j] = overdue[i];
+            size_t missed = 1;
+            if (policy == Catchup::all) {
+                auto t = next_cron_time(j->cron, SysClock::time_point(std::chrono::nanoseconds(j->due_ns)));
+                for (; missed < s.opts.max_catchup && to_ns(t) <= now; ++missed) t = next_cron_time(j->cron, t);
+            }
+            if (size_t runs = runs_for(missed)) s.catch_up(*j, runs);
+            j->due_ns = to_ns(next[i]);
+            s.start(id, *j, j->due_ns, steady_now, now);
+        }
+    }
+    for (JobId id : dropped) {
+        s.append(rec_ran, id, 0);
+        s.forget(s.jobs.find(id));
+    }
+    return stats;
+}
+
+ScheduleJournal::JobId ScheduleJournal::schedule_once(const std::string& name, SystemTime when,
+                                                      const TaskOptions& opts) {
+    auto j = State::job(kind_once, name, opts);
+    j.due_ns = std::max<int64_t>(to_ns(when), 1);   // zero marks a finished job
+    return st_->add(std::move(j));
+}
+
+ScheduleJournal::JobId ScheduleJournal::schedule_every(const std::string& name, Duration interval,
+                                                       const TaskOptions& opts) {
+    auto j = State::job(kind_every, name, opts);
+    j.due_ns = to_ns(SysClock::now() + interval);
+    j.interval_ns = to_ns(interval);
+    return st_->add(std::move(j));
+}
+
+ScheduleJournal::JobId ScheduleJournal::schedule_recurring(const std::string& name, const std::string& cron,
+                                                           const TaskOptions& opts) {
+    auto j = State::job(kind_cron, name, opts);
+    j.cron = parse_cron(cron);
+    if (!j.cron.valid) throw std::invalid_argument("ScheduleJournal: bad cron expression '" + cron + "'");
+    j.cron_expr = cron;
+    j.due_ns = to_ns(next_cron_time(j.cron));
+    return st_->add(std::move(j));
+}
+
+bool ScheduleJournal::cancel(JobId id) {
+    TaskHandle h;
+    {
+        std::lock_guard<std::mutex> lk(st_->mtx);
+        auto it = st_->jobs.find(id);
+        if (it == st_->jobs.end()) return false;
+        h = it->second.handle;
+        st_->append(rec_cancel, id, 0);
+        st_->forget(it);
+    }
+    // A run already going finishes; the job's task then stops.
+    if (h.is_valid()) st_->sched.cancel(h);
+    return true;
+}
+
+TaskHandle ScheduleJournal::handle(JobId id) const {
+    std::lock_guard<std::mutex> lk(st_->mtx);
+    auto it = st_->jobs.find(id);
+    return it == st_->jobs.end() ? TaskHandle{} : it->second.handle;
+}
+
+size_t ScheduleJournal::size() const {
+    std::lock_guard<std::mutex> lk(st_->mtx);
+    return st_->jobs.size();
+}
+
+size_t ScheduleJournal::bytes() const {
+    std::lock_guard<std::mutex> lk(st_->mtx);
+    return st_->tail;
+}
+
+void ScheduleJournal::compact() {
+    std::lock_guard<std::mutex> lk(st_->mtx);
+    st_->compact();
+}
+
+void ScheduleJournal::sync() {
+    std::lock_guard<std::mutex> lk(st_->mtx);
+    if (::msync(st_->map, st_->tail, MS_SYNC) != 0) throw_errno("msync " + st_->path.string());
+}
+
+}  // namespace tf
@@ -1,98 +1,896 @@
 #include <taskflow/scheduler.hpp>
+#include <taskflow/slab.hpp>
+#include <taskflow/mpsc_queue.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <ostream>
+#include <queue>
 #include <unordered_map>
-#include <shared_mutex>
-#include <format>
 #include <sstream>
 #include <iomanip>
 
+#if __has_include(<sys/timerfd.h>) && __has_include(<sys/epoll.h>)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/prctl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#define TASKFLOW_HAS_TIMERFD 1
+#else
+#define TASKFLOW_HAS_TIMERFD 0
+#endif
+
 namespace tf {
 
+namespace {
+// Wall-clock deadline to the steady clock the timer heap runs on.
+TimePoint to_steady(std::chrono::system_clock::time_point tp) {
+    if (tp == std::chrono::system_clock::time_point::max()) return TimePoint::max();
+    return Clock::now() + std::chrono::duration_cast<Duration>(tp - std::chrono::system_clock::now());
+}
+
+[[maybe_unused]] void write_json_string(std::ostream& out, const char* s) {
+    out << '"';
+    for (; *s; ++s) {
+        unsigned char c = static_cast<unsigned char>(*s);
+        if (c == '"' || c == '\\') out << '\\' << *s;
+        else if (c < 0x20) out << "\\u00" << "0123456789abcdef"[c >> 4] << "0123456789abcdef"[c & 15];
+        else out << *s;
+    }
+    out << '"';
+}
+
+// A recurring task whose runs may overlap (Recurrence::max_concurrency > 1).
+// The scheduled task only ticks; each run is a one-shot task of its own.
+// Once the ticking task has been canceled or stopped, runs that have not
+// started yet, owed ones included, are dropped.
+struct OverlappingRuns : std::enable_shared_from_this<OverlappingRuns> {
+    OverlappingRuns(Task f, const TaskOptions& o) : fn(std::move(f)), opts(o) {}
+
+    void tick(Scheduler& s, TaskHandle self) {
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            owner = self;
+            const auto& r = opts.recurrence;
+            if (running >= r.max_concurrency) {
+                if (r.misfire == Misfire::coalesce) owed = 1;
+                else if (r.misfire == Misfire::catch_up) owed = std::min(owed + 1, std::max(r.catch_up, 1u));
+                return;
+            }
+            ++running;
+        }
+        start(s);
+    }
+
+    void start(Scheduler& s) {
+        s.schedule_once(Clock::now(), UniqueTask([&s, self = shared_from_this()] {
+            if (self->stopped(s)) {
+                self->finished(s);
+                return;
+            }
+            try {
+                self->fn();
+            } catch (...) {
+                self->finished(s);
+                throw;
+            }
+            self->finished(s);
+        }), {}, opts);
+    }
+
+    // A run is over: its slot goes to a run still owed, if any.
+    void finished(Scheduler& s) {
+        const bool stop = stopped(s);
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            if (stop) owed = 0;
+            if (owed == 0) {
+                --running;
+                return;
+            }
+            --owed;
+        }
+        start(s);
+    }
+
+    // The ticking task was asked to stop, or is gone already.
+    bool stopped(Scheduler& s) {
+        TaskHandle h;
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            h = owner;
+        }
+        ScheduledTask* t = detail::pin_task(s, h);
+        if (!t) return true;
+        const bool stop = t->stop.load(std::memory_order_acquire) != 0;
+        detail::unpin_task(s, h);
+        return stop;
+    }
+
+    Task fn;
+    const TaskOptions opts;
+    std::mutex mtx;
+    TaskHandle owner;   // the ticking task
+    uint32_t running = 0, owed = 0;
+};
+}  // namespace
+
 struct Scheduler::Impl {
-    ThreadPool pool;
-    std::vector<ScheduledTask> tasks;
-    std::unordered_map<uint64_t, size_t> id2idx;
+    // Deadline-ordered min-heap entry. Each armed node has exactly one entry
+    // in flight (Node::armed; a prune may take its token back), plus one
+    // expiry entry if it has a timeout.
+    struct TimerEntry {
+        TimePoint when;
+        TaskHandle h;
+        bool expiry = false;   // TaskOptions::timeout ran out
+        bool operator>(const TimerEntry& o) const { return when > o.when; }
+    };
+
+    // Run-time history of one task name: an EWMA in which each new sample
+    // moves the estimate a quarter of the way. Updates from concurrent runs
+    // may overwrite each other; either sample is as good.
+    struct CostEstimate {
+        std::atomic<int64_t> ns{-1};   // -1 until the first sample
+        void record(int64_t sample) {
+            int64_t old = ns.load(std::memory_order_relaxed);
+            ns.store(old < 0 ? sample : old + (sample - old) / 4, std::memory_order_relaxed);
+        }
+    };
+
+    struct Node;
+    // Dependent registered on a node after it was published; see link().
+    struct Edge {
+        Node* node;
+        Edge* next;
+    };
+
+    // Scheduler-side bookkeeping around a ScheduledTask. Lives in a slab slot
+    // until the task has finished and released its dependents. Being a
+    // ThreadPool::Work, the node itself is what gets queued on the pool.
+    //
+    // task.pending_deps counts unfinished dependencies plus one token for the
+    // timer; whoever takes it to zero (the dispatcher when the timer fires, or
+    // the worker finishing the last dependency) dispatches the task.
+    struct Node : ThreadPool::Work {
+        Node(ScheduledTask&& st, Impl* owner)
+            : task(std::move(st)), owner(owner) {
+            execute = [](ThreadPool::Work* w) {
+                auto* n = static_cast<Node*>(w);
+                n->owner->execute(*n);
+            };
+            priority = task.priority;
+            node = static_cast<int16_t>(task.node);
+            set_deadline();
+        }
+        // Absolute EDF key for the pool, from the relative budget and next_run.
+        void set_deadline() {
+            deadline = task.deadline == Duration::max() ? TimePoint::max() : task.next_run + task.deadline;
+        }
+        ScheduledTask task;
+        Impl* owner;
+        TaskHandle self;
+        std::atomic<Edge*> waiters{nullptr};  // late dependents; closed() once finished
+        std::atomic<uint32_t> state{0};       // pin count | kFinished
+        std::atomic<bool> queued{false};      // on the intake queue
+        std::atomic<bool> armed{false};       // its timer token is in the heap
+        std::atomic<uint8_t> phase{kIdle};    // kIdle, kRunning, kPruned, kDone
+        bool settled = false;                 // prune() has completed its waiters
+        bool admitted = false;                // holds a slot of task.group
+        std::exception_ptr stop_error;        // failed dependency's error; see prune()
+        bool registered = false;              // dispatcher has linked and armed it
+        Node* intake_next = nullptr;
+        CostEstimate* cost = nullptr;         // named graph nodes: history to update
+        int64_t rank = 0;                     // estimated ns from start to the end of the graph
+        int16_t ran_on = -1;                  // pool node of its last run
+#if TASKFLOW_INSTRUMENTATION
+        int64_t t_submit = 0;
+        int64_t t_ready = 0;
+        uint64_t released_by = 0;             // TaskHandle::id of the releasing dependency
+#endif
+    };
+
+    static constexpr uint32_t kFinished = 1u << 31;
+    // Node::phase. A node leaves kIdle once, to run or to be pruned; a
+    // recurring one comes back to it for every run.
+    static constexpr uint8_t kIdle = 0, kRunning = 1, kPruned = 2, kDone = 3;
+    static inline thread_local Node* current = nullptr;   // node execute() is running here
+    static inline thread_local std::vector<Node*> released;   // completed() scratch
+    static Edge* closed() { static Edge sentinel{}; return &sentinel; }
+
+    // Among ready nodes, a starts first: better priority class, then the
+    // longer path still ahead of it.
+    static bool before(const Node& a, const Node& b) {
+        if (a.priority != b.priority) return a.priority < b.priority;
+        return a.rank > b.rank;
+    }
+
+    Slab<Node> nodes;
+    // Everything the dispatcher has to look at: new tasks, recurring tasks to
+    // re-arm, finished tasks to reclaim. Producers never take mtx.
+    MpscQueue<Node, &Node::intake_next> intake;
+    // Dispatcher-owned.
+    std::priority_queue<TimerEntry, std::vector<TimerEntry>, std::greater<>> timers;
+    // Guards the dispatcher's sleep, slot reclamation, and pinning by handle.
     std::mutex mtx;
-    std::condition_variable cv;
+    std::condition_variable cv;   // the dispatcher's sleep without timerfd
+    // The dispatcher sleeps in epoll on a timerfd armed for the earliest
+    // timer and an eventfd for everything else; -1 if unavailable.
+    int epoll_fd = -1, timer_fd = -1, event_fd = -1;
+    TimePoint armed = TimePoint::max();   // timer_fd's expiry; dispatcher-owned
+    std::atomic<bool> sleeping{false};
     std::atomic<bool> running{false};
+    std::atomic<bool> critical_path{true};
     std::thread worker;
-    uint64_t next_id{1};
+    // Keyed by task name; entries are never erased, so nodes keep pointers.
+    mutable std::mutex cost_mtx;
+    std::unordered_map<std::string, CostEstimate> costs;
+    const int64_t epoch_ns = detail::trace_clock_ns();
+#if TASKFLOW_INSTRUMENTATION
+    // One block per worker plus a shared one for outside threads.
+    std::unique_ptr<detail::TaskStats[]> stats;
+    std::vector<std::unique_ptr<detail::TraceRing>> rings;   // per worker, allocated by start_trace
+    std::atomic<bool> tracing{false};
+#endif
+    ThreadPool pool;    // last: drains queued work before the task table goes away
+
+    Impl(const PoolOptions& o) : pool(o) {
+#if TASKFLOW_INSTRUMENTATION
+        stats = std::make_unique<detail::TaskStats[]>(pool.size() + 1);
+#endif
+#if TASKFLOW_HAS_TIMERFD
+        epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        timer_fd = ::timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        event_fd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        bool ok = epoll_fd >= 0 && timer_fd >= 0 && event_fd >= 0;
+        for (int fd : {timer_fd, event_fd}) {
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            ok = ok && ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == 0;
+        }
+        if (!ok) close_fds();   // condition variable instead
+#endif
+    }
+
+    void close_fds() {
+#if TASKFLOW_HAS_TIMERFD
+        for (int* fd : {&epoll_fd, &timer_fd, &event_fd}) {
+            if (*fd >= 0) ::close(*fd);
+            *fd = -1;
+        }
+#endif
+    }
+
+    // Task callables may own TaskFutures whose destructors call back into the
+    // scheduler, so they are destroyed only after the pool has drained and
+    // without holding mtx.
+    ~Impl() {
+        pool.shutdown();
+        std::vector<UniqueTask> funcs;
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            nodes.for_each([&](Node& n) {
+                funcs.push_back(std::move(n.task.func));
+                if (n.task.group) n.task.group->drop(&n);
+                Edge* e = n.waiters.load(std::memory_order_relaxed);
+                if (e == closed()) return;
+                while (e) delete std::exchange(e, e->next);
+            });
+        }
+        close_fds();
+    }
+
+    // Live node for h, or nullptr if h is invalid or its task was reclaimed.
+    Node* find(TaskHandle h) {
+        return h.is_valid() ? nodes.get(h.slot(), h.generation()) : nullptr;
+    }
 
-    Impl(size_t n) : pool(n) {}
+    // Any thread. The slot is claimed lock-free; the node is private to the
+    // caller until it is pushed onto the intake queue.
+    Node& emplace(ScheduledTask&& st, uint32_t pins = 0) {
+        auto [slot, gen] = nodes.allocate(std::move(st), this);
+        Node& n = nodes[slot];
+        n.self = TaskHandle::make(slot, gen);
+        n.state.store(pins, std::memory_order_relaxed);
+        n.task.pending_deps.store(1, std::memory_order_relaxed);   // the timer token
+        on_submit(n);
+        return n;
+    }
+
+    // ---- instrumentation hooks; empty unless TASKFLOW_INSTRUMENTATION ----
+
+#if TASKFLOW_INSTRUMENTATION
+    detail::TaskStats& local_stats() {
+        int w = pool.current_worker();
+        return stats[w >= 0 ? static_cast<size_t>(w) : pool.size()];
+    }
+#endif
+
+    void on_submit([[maybe_unused]] Node& n) {
+#if TASKFLOW_INSTRUMENTATION
+        n.t_submit = detail::trace_clock_ns();
+        local_stats().submitted.add(1);
+#endif
+    }
+
+    // Called by whoever took n's pending count to zero, before dispatching it.
+    void on_ready([[maybe_unused]] Node& n, [[maybe_unused]] uint64_t released_by) {
+#if TASKFLOW_INSTRUMENTATION
+        n.t_ready = detail::trace_clock_ns();
+        n.released_by = released_by;
+#endif
+    }
+
+    void on_run([[maybe_unused]] Node& n, [[maybe_unused]] int64_t start,
+                [[maybe_unused]] int64_t end) {
+#if TASKFLOW_INSTRUMENTATION
+        auto& st = local_stats();
+        int64_t due = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            n.task.next_run.time_since_epoch()).count();
+        st.started.add(1);
+        st.finished.add(1);
+        detail::TaskStats::record(st.dependency_wait, n.t_ready - std::max(n.t_submit, due));
+        detail::TaskStats::record(st.queue_wait, start - n.t_ready);
+        detail::TaskStats::record(st.run_time, end - start);
+        if (tracing.load(std::memory_order_acquire)) {
+            rings[static_cast<size_t>(pool.current_worker())]->record(
+                n.self.id, n.released_by, start, end,
+                n.task.name.empty() ? "task" : n.task.name.c_str());
+        }
+#endif
+    }
+
+    // Hands n to the dispatcher. n must not be touched afterwards unless the
+    // caller knows it stays alive (pinned or recurring).
+    void post(Node& n) {
+        n.queued.store(true, std::memory_order_relaxed);
+        if (intake.push(&n)) wake();
+    }
+
+    // Pairs with the fence in loop(): either the dispatcher sees the new work
+    // before sleeping, or we see it asleep and wake it.
+    void wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!sleeping.load(std::memory_order_relaxed)) return;
+        interrupt();
+    }
+
+    // Wakes the dispatcher unconditionally. The eventfd stays readable until
+    // the dispatcher reads it, so a wake-up just before it sleeps is not
+    // lost; the condition variable is notified under mtx for the same reason.
+    void interrupt() {
+#if TASKFLOW_HAS_TIMERFD
+        if (event_fd >= 0) {
+            uint64_t one = 1;
+            if (::write(event_fd, &one, sizeof one) < 0) {}   // only fails if already readable
+            return;
+        }
+#endif
+        { std::lock_guard<std::mutex> lk(mtx); }
+        cv.notify_one();
+    }
+
+    // Dispatcher, holding lk: sleeps until `until`, new work or stop().
+    void sleep(std::unique_lock<std::mutex>& lk, TimePoint until) {
+#if TASKFLOW_HAS_TIMERFD
+        if (epoll_fd >= 0) {
+            if (until != armed) {
+                // Absolute CLOCK_MONOTONIC, which is what steady_clock reads.
+                itimerspec its{};
+                if (until != TimePoint::max()) {
+                    auto ns = std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                       until.time_since_epoch()).count());
+                    its.it_value.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+                    its.it_value.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+                }
+                ::timerfd_settime(timer_fd, TFD_TIMER_ABSTIME, &its, nullptr);
+                armed = until;
+            }
+            lk.unlock();
+            epoll_event evs[2];
+            int n = ::epoll_wait(epoll_fd, evs, 2, -1);
+            for (int i = 0; i < n; ++i) {
+                uint64_t count;
+                if (::read(evs[i].data.fd, &count, sizeof count) < 0) {}   // drained already
+                if (evs[i].data.fd == timer_fd) armed = TimePoint::max();
+            }
+            lk.lock();
+            return;
+        }
+#endif
+        if (until == TimePoint::max()) cv.wait(lk);
+        else cv.wait_until(lk, until);
+    }
+
+    Node& add(ScheduledTask st, uint32_t pins = 0) {
+        Node& n = emplace(std::move(st), pins);
+        post(n);
+        return n;
+    }
+
+    // Requires mtx.
+    Node* pin(TaskHandle h) {
+        Node* n = find(h);
+        if (n) n->state.fetch_add(1, std::memory_order_relaxed);
+        return n;
+    }
+
+    // Requires mtx. Frees the slot but hands the callable back, so that the
+    // caller destroys it after unlocking (see ~Impl).
+    UniqueTask release(Node& n) {
+        UniqueTask f = std::move(n.task.func);
+        nodes.release(n.self.slot());
+        return f;
+    }
 
-    TaskHandle add(ScheduledTask st) {
+    // Any thread; h must be pinned. Dropping the last pin of a finished task
+    // reclaims it here, unless a reclaim request is already queued for the
+    // dispatcher.
+    void unpin(TaskHandle h) {
+        Node& n = nodes[h.slot()];
+        if (n.state.fetch_sub(1, std::memory_order_acq_rel) - 1 != kFinished) return;
+        UniqueTask spent;
         std::lock_guard<std::mutex> lk(mtx);
-        st.pending_deps = static_cast<int>(st.dependencies.size());
-        size_t idx = tasks.size();
-        TaskHandle h{next_id++};
-        
-        // Set up dependency relationships - add this task as a dependent of its dependencies
-        for (auto dep_handle : st.dependencies) {
-            auto dep_it = id2idx.find(dep_handle.id);
-            if (dep_it != id2idx.end()) {
-                tasks[dep_it->second].dependents.push_back(h);
+        Node* p = find(h);
+        if (p && !p->queued.load(std::memory_order_relaxed) &&
+            p->state.load(std::memory_order_acquire) == kFinished)
+            spent = release(*p);
+    }
+
+    // Allocates every node of a validated graph, wires in-graph edges
+    // directly (successor lists and pending counts), and publishes the whole
+    // batch with a single push. External dependencies are linked by the
+    // dispatcher like any other task's.
+    std::vector<TaskHandle> add_graph(TaskGraph& g, TimePoint start) {
+        std::vector<CostEstimate*> cost;
+        auto rank = rank_graph(g, cost);   // throws on a cycle before anything is inserted
+        const size_t count = g.size();
+        std::vector<TaskHandle> handles(count);
+        if (count == 0) return handles;
+        std::vector<Node*> ns(count);
+        for (size_t i = 0; i < count; ++i) {
+            ScheduledTask st;
+            st.func = std::move(g.nodes_[i].fn);
+            st.name = std::move(g.nodes_[i].name);
+            st.next_run = start;
+            ns[i] = &emplace(std::move(st));
+            ns[i]->rank = rank[i];
+            if (!cost.empty()) ns[i]->cost = cost[i];
+            handles[i] = ns[i]->self;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            auto& gn = g.nodes_[i];
+            Node& n = *ns[i];
+            n.task.pending_deps.fetch_add(static_cast<int>(gn.in_degree), std::memory_order_relaxed);
+            n.task.dependencies = std::move(gn.external);
+            n.task.dependents.reserve(gn.successors.size());
+            for (auto succ : gn.successors) n.task.dependents.push_back(handles[succ]);
+            n.queued.store(true, std::memory_order_relaxed);
+            n.intake_next = i ? ns[i - 1] : nullptr;
+        }
+        if (intake.push_chain(ns.back(), ns.front())) wake();
+        return handles;
+    }
+
+    // Bottom level of every node of a graph: its own estimated cost plus the
+    // longest path through its successors. Nodes without history are costed
+    // at the mean of those with some, so an unknown graph is ranked by path
+    // length. Named nodes get their history entry in `cost` (left empty if
+    // there are none). Throws std::invalid_argument on a cycle.
+    std::vector<int64_t> rank_graph(const TaskGraph& g, std::vector<CostEstimate*>& cost) {
+        auto order = g.topological_order();
+        std::vector<int64_t> rank(g.size(), -1);   // own cost until ranked
+        int64_t known = 0, total = 0;
+        {
+            std::lock_guard<std::mutex> lk(cost_mtx);
+            for (size_t i = 0; i < g.size(); ++i) {
+                if (g.nodes_[i].hit) rank[i] = 0;   // nothing to run, nothing to learn
+                if (g.nodes_[i].name.empty() || g.nodes_[i].hit) continue;
+                if (cost.empty()) cost.resize(g.size());
+                cost[i] = &costs[g.nodes_[i].name];
+                rank[i] = cost[i]->ns.load(std::memory_order_relaxed);
+                if (rank[i] >= 0) { ++known; total += rank[i]; }
             }
         }
-        
-        tasks.push_back(std::move(st));
-        id2idx[h.id] = idx;
-        return h;
+        const int64_t fallback = known ? std::max<int64_t>(1, total / known) : 1;
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            int64_t below = 0;
+            for (auto succ : g.nodes_[*it].successors) below = std::max(below, rank[succ]);
+            rank[*it] = (rank[*it] >= 0 ? rank[*it] : fallback) + below;
+        }
+        return rank;
     }
 
-    void completed(uint64_t id) {
-        std::unique_lock<std::mutex> lk(mtx);
-        auto it = id2idx.find(id);
-        if (it == id2idx.end()) return;
-        size_t idx = it->second;
-        for (auto dep : tasks[idx].dependents) {
-            auto dit = id2idx.find(dep.id);
-            if (dit == id2idx.end()) continue;
-            if (--tasks[dit->second].pending_deps == 0) cv.notify_one();
+    // Dispatcher. Registers n as a dependent of `dep` unless dep has already
+    // finished (reclaimed, or its waiter list closed), which counts as
+    // satisfied; one still in its slot that did not succeed prunes n, as
+    // completed() would have. A reclaimed dep no longer says where it ran,
+    // nor how it ended.
+    void link(TaskHandle dep, Node& n) {
+        Node* d = find(dep);
+        if (!d) return;
+        n.task.pending_deps.fetch_add(1, std::memory_order_relaxed);
+        auto* e = new Edge{&n, nullptr};
+        Edge* head = d->waiters.load(std::memory_order_acquire);
+        do {
+            if (head == closed()) {
+                // Already finished: still follow the data (see TaskOptions::node).
+                if (n.task.node < 0) n.node = d->ran_on;
+                n.task.pending_deps.fetch_sub(1, std::memory_order_relaxed);
+                delete e;
+                if (d->task.status != TaskStatus::succeeded && !n.task.always_run) {
+                    std::vector<Node*> scratch;
+                    prune(n, d->task.status, d->task.error, scratch);
+                }
+                return;
+            }
+            e->next = head;
+        } while (!d->waiters.compare_exchange_weak(head, e, std::memory_order_release,
+                                                   std::memory_order_acquire));
+    }
+
+    // Drops one of n's pending counts; true if that made it runnable.
+    static bool satisfy(Node& n) {
+        return n.task.pending_deps.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+    // Dispatcher. Consumes the timer token now if the deadline has passed,
+    // otherwise leaves it to the heap.
+    // A pruned node does not wait for its time. One pruned after the check
+    // had its token put in the heap; pairs with the exchange in prune().
+    void arm(Node& n, TimePoint now, std::vector<Node*>& ready) {
+        if (n.task.next_run > now && n.phase.load() != kPruned) {
+            n.armed.store(true);
+            timers.push(TimerEntry{n.task.next_run, n.self});
+            if (n.phase.load() != kPruned || !n.armed.exchange(false)) return;
+        }
+        if (satisfy(n)) {
+            on_ready(n, 0);
+            ready.push_back(&n);
         }
     }
 
+    // Dispatcher, under mtx. Everything queued since the last call, oldest
+    // first: a producer's tasks arrive in submission order, so a dependency
+    // is always linked before anything that names it.
+    void drain(TimePoint now, std::vector<Node*>& ready, std::vector<UniqueTask>& spent) {
+        for (Node* n = intake.take_all(); n;) {
+            Node* next = n->intake_next;
+            n->queued.store(false, std::memory_order_relaxed);
+            if (!n->registered) {
+                n->registered = true;
+                for (auto dep : n->task.dependencies) {
+                    if (n->phase.load() == kPruned) break;
+                    link(dep, *n);
+                }
+                const auto& t = n->task;
+                if (!t.recurring && t.timeout != Duration::max() && t.timeout < TimePoint::max() - t.next_run)
+                    timers.push(TimerEntry{t.next_run + t.timeout, n->self, true});
+                arm(*n, now, ready);
+            } else if (n->state.load(std::memory_order_acquire) & kFinished) {
+                // Reclaim unless a pin still holds it; the last unpin will.
+                if (n->state.load(std::memory_order_acquire) == kFinished)
+                    spent.push_back(release(*n));
+            } else {
+                arm(*n, now, ready);    // recurring task coming back for its next run
+            }
+            n = next;
+        }
+    }
+
+    // Worker. Releases h's dependents whose last dependency this was; all but
+    // one go straight to the pool, and the last one is returned so the
+    // calling worker can run it inline as a continuation. Closes the waiter
+    // list of a one-shot task, then hands it to the dispatcher for reclamation.
+    //
+    // With critical-path ordering the continuation is the released node that
+    // should start first, and the rest are queued best first, which is the
+    // end thieves take from.
+    //
+    // A task that did not succeed prunes its dependents before releasing
+    // them, so they complete at once instead of running.
+    Node* completed(Node& n, bool recurring) {
+        if (!recurring) n.phase.store(kDone);
+        if (n.admitted) release_slot(n);
+        Node* cont = nullptr;
+        const bool ordered = critical_path.load(std::memory_order_relaxed);
+        const TaskStatus outcome = n.task.status;
+        std::vector<Node*> scratch;
+        released.clear();
+        auto ready = [&](Node& d) {
+            if (outcome != TaskStatus::succeeded && !d.task.always_run) prune(d, outcome, n.task.error, scratch);
+            if (!satisfy(d)) return;
+            if (d.task.node < 0) d.node = n.ran_on;   // follow the data
+            on_ready(d, n.self.id);
+            if (cont && ordered && before(*cont, d)) {
+                released.push_back(&d);
+                return;
+            }
+            if (cont) released.push_back(cont);
+            cont = &d;
+        };
+        for (auto dep : n.task.dependents) ready(nodes[dep.slot()]);
+        if (!recurring) n.task.dependents.clear();
+        Edge* e = n.waiters.exchange(recurring ? nullptr : closed(), std::memory_order_acq_rel);
+        while (e) {
+            ready(*e->node);
+            delete std::exchange(e, e->next);
+        }
+        if (ordered && released.size() > 1)
+            std::stable_sort(released.begin(), released.end(),
+                             [](const Node* a, const Node* b) { return before(*a, *b); });
+        for (Node* d : released) dispatch(*d);
+        // Running inline bypasses the pool's ordering, so only keep the
+        // continuation when nothing queued should start before it, and on
+        // the node it asks for.
+        if (cont && (cont->priority == Priority::low ||
+                     (cont->priority != Priority::high && pool.has_urgent()) ||
+                     (cont->node >= 0 && pool.nodes() > 1 && cont->node != n.ran_on))) {
+            dispatch(*cont);
+            cont = nullptr;
+        }
+        if (cont && !admit(*cont)) cont = nullptr;
+        if (!recurring) {
+            // Last touch: once posted, the dispatcher may reclaim the slot.
+            n.queued.store(true, std::memory_order_relaxed);
+            n.state.fetch_or(kFinished, std::memory_order_acq_rel);
+            if (intake.push(&n)) wake();
+        }
+        return cont;
+    }
+
+    // When recurring t runs next, its run due at t.next_run having just
+    // finished at `now`. Fixed-delay tasks wait an interval from now.
+    // Fixed-rate and cron tasks keep to their grid, and the misfire policy
+    // decides about grid ticks already past: a tick returned in the past
+    // runs at once and becomes the base for the next call.
+    static TimePoint next_tick(const ScheduledTask& t, TimePoint now) {
+        const Recurrence& r = t.recurrence;
+        const int64_t keep = std::max<int64_t>(r.catch_up, 1);
+        if (!t.cron.valid) {
+            const TimePoint slot = t.next_run;
+            if (r.rate == Rate::fixed_delay || t.interval <= Duration::zero() || slot + t.interval > now)
+                return (r.rate == Rate::fixed_delay ? now : slot) + t.interval;
+            const int64_t missed = (now - slot) / t.interval;   // grid ticks in (slot, now]
+            switch (r.misfire) {
+            case Misfire::skip: return slot + (missed + 1) * t.interval;
+            case Misfire::coalesce: return slot + missed * t.interval;
+            case Misfire::catch_up: return slot + std::max<int64_t>(1, missed - keep + 1) * t.interval;
+            }
+        }
+        using SysClock = std::chrono::system_clock;
+        const auto sys_now = SysClock::now();
+        if (r.misfire == Misfire::skip) return to_steady(next_cron_time(t.cron, sys_now));
+        const auto slot = sys_now - std::chrono::duration_cast<SysClock::duration>(now - t.next_run);
+        auto first = next_cron_time(t.cron, slot);
+        if (first > sys_now) return to_steady(first);
+        if (r.misfire == Misfire::coalesce) return now;
+        // The last `keep` firings missed; counting them is bounded so a long
+        // stall on a per-second schedule cannot spin here.
+        int64_t missed = 0;
+        for (auto f = first; f <= sys_now && missed < 100'000; f = next_cron_time(t.cron, f)) ++missed;
+        for (int64_t i = missed - keep; i > 0; --i) first = next_cron_time(t.cron, first);
+        return to_steady(first);
+    }
+
+    // Runs n on the current worker, then keeps going with whatever dependent
+    // it released until the chain runs dry. A dispatched node cannot be
+    // reclaimed before its own completed() call, so no lock is needed to run it.
+    void execute(Node& first) {
+        Node* outer = current;
+        for (Node* n = &first; n;) {
+            current = n;
+            n->ran_on = static_cast<int16_t>(pool.current_node());
+            // Pruned while waiting, or stopped between two runs of a
+            // recurring task: completes without running.
+            uint8_t idle = kIdle;
+            const bool stopped = n->task.recurring && n->task.stop.load();
+            bool runs = false, done = true;
+            if (n->phase.compare_exchange_strong(idle, stopped ? kPruned : kRunning)) {
+                if (stopped) settle(*n, nullptr);
+                else runs = true;
+            } else if (!n->settled) {
+                settle(*n, n->stop_error);
+            }
+            if (runs) {
+#if TASKFLOW_INSTRUMENTATION
+                int64_t start = detail::trace_clock_ns();
+                done = n->task.run();
+                int64_t end = detail::trace_clock_ns();
+                on_run(*n, start, end);
+                if (done && n->cost) n->cost->record(end - start);
+#else
+                int64_t start = n->cost ? detail::trace_clock_ns() : 0;
+                done = n->task.run();
+                if (done && n->cost) n->cost->record(detail::trace_clock_ns() - start);
+#endif
+            }
+            if (!done) break;   // a suspended coroutine finishes it; see finish_detached()
+            bool recurring = runs && n->task.recurring && !n->task.stop.load();
+            Node* next = completed(*n, recurring);
+            if (recurring) {
+                // Reschedule the same task instead of creating a new one
+                TimePoint when = next_tick(n->task, Clock::now());
+                n->task.next_run = when;
+                n->set_deadline();
+                n->task.pending_deps.store(1, std::memory_order_relaxed);
+                n->phase.store(kIdle);   // from here a stop prunes the next run
+                if (when != TimePoint::max()) post(*n);
+            }
+            n = next;
+        }
+        current = outer;
+    }
+
+    // The asynchronous end of a detached task came after run() returned.
+    // Off the pool (I/O completions) the released work is only queued.
+    void finish_detached(Node& n) {
+        n.task.complete();
+        if (Node* next = completed(n, false)) {
+            if (pool.current_worker() >= 0) execute(*next);
+            else pool.submit(next);
+        }
+    }
+
+    void dispatch(Node& n) {
+        if (admit(n)) pool.submit(&n);
+    }
+
+    // True if ready n may start now. Otherwise its group is at a limit: n
+    // waits there for a slot, or goes back to the timer heap until its
+    // token is due. A pruned task only completes, so it takes no slot.
+    bool admit(Node& n) {
+        if (!n.task.group || n.phase.load() == kPruned) return true;
+        TimePoint retry;
+        if (n.task.group->acquire(&n, Clock::now(), retry)) return n.admitted = true;
+        if (retry != TimePoint::max()) defer(n, retry);
+        return false;
+    }
+
+    // Any thread. Re-arms ready n to become ready again at `when`.
+    void defer(Node& n, TimePoint when) {
+        n.task.next_run = when;
+        n.task.pending_deps.store(1, std::memory_order_relaxed);
+        post(n);
+    }
+
+    // Worker, after a run of a grouped task: passes the slot on to the
+    // next task queued for it.
+    void release_slot(Node& n) {
+        n.admitted = false;
+        TimePoint retry;
+        ThreadPool::Work* w = n.task.group->release(Clock::now(), retry);
+        if (!w) return;
+        Node& next = *static_cast<Node*>(w);
+        if (retry == TimePoint::max()) {
+            next.admitted = true;
+            pool.submit(&next);
+        } else {
+            defer(next, retry);
+        }
+    }
+
+    // Any thread, with root kept alive (pinned, or under mtx). Asks root to
+    // stop with `why` and walks its cone: every task in it that has not
+    // started is pruned, its waiters completing now with `why` and `err` (a
+    // TaskCanceled if null), and is then released to finish without running
+    // as soon as its remaining dependencies allow. A running task is only
+    // asked, through its CancelToken; its own outcome decides for its cone.
+    // always_run dependents are left out. False if root has already finished
+    // or been stopped. n.stop_error is written before the phase changes, so
+    // whoever sees kPruned may read it.
+    //
+    // Each pruned node's pending count is held while its dependents are
+    // walked, so it cannot complete and free its edges under the walk. One
+    // whose count is already zero is either queued on its group, and taken
+    // back from there, or on its way to execute(), which prunes what lies
+    // behind it instead.
+    bool prune(Node& root, TaskStatus why, const std::exception_ptr& err, std::vector<Node*>& scratch) {
+        if (root.phase.load() == kDone) return false;
+        bool stopped = false;
+        const size_t base = scratch.size();
+        std::vector<Node*> held, dropped;
+        scratch.push_back(&root);
+        while (scratch.size() > base) {
+            Node& n = *scratch.back();
+            scratch.pop_back();
+            uint8_t none = 0;
+            if (!n.task.stop.compare_exchange_strong(none, static_cast<uint8_t>(why))) continue;
+            stopped = stopped || &n == &root;
+            n.stop_error = err;
+            uint8_t idle = kIdle;
+            if (!n.phase.compare_exchange_strong(idle, kPruned)) continue;
+            if (hold(n)) held.push_back(&n);
+            else if (n.task.group && n.task.group->drop(&n)) dropped.push_back(&n);
+            else continue;
+            settle(n, err);
+            if (n.armed.exchange(false)) satisfy(n);   // its heap entry goes stale
+            auto visit = [&](Node& d) { if (!d.task.always_run) scratch.push_back(&d); };
+            for (auto dep : n.task.dependents)
+                if (Node* d = find(dep)) visit(*d);
+            for (Edge* e = n.waiters.load(std::memory_order_acquire); e && e != closed(); e = e->next)
+                visit(*e->node);
+        }
+        for (Node* n : held)
+            if (satisfy(*n)) dispatch(*n);
+        for (Node* n : dropped) pool.submit(n);
+        return stopped;
+    }
+    bool prune(Node& root, TaskStatus why) {
+        std::vector<Node*> scratch;
+        return prune(root, why, std::make_exception_ptr(TaskCanceled(why)), scratch);
+    }
+
+    // Completes the waiters of pruned n, once: with `err`, or a TaskCanceled
+    // for why it was stopped.
+    static void settle(Node& n, const std::exception_ptr& err) {
+        auto why = static_cast<TaskStatus>(n.task.stop.load());
+        n.task.error = err ? err : std::make_exception_ptr(TaskCanceled(why));
+        n.task.complete(why);
+        n.settled = true;
+    }
+
+    // Adds a pending count unless the node has already been released.
+    static bool hold(Node& n) {
+        int p = n.task.pending_deps.load(std::memory_order_relaxed);
+        while (p > 0)
+            if (n.task.pending_deps.compare_exchange_weak(p, p + 1, std::memory_order_acq_rel)) return true;
+        return false;
+    }
+
     void loop() {
+#if TASKFLOW_HAS_TIMERFD
+        ::prctl(PR_SET_TIMERSLACK, 1UL);   // expire timers on time, not up to 50us late
+#endif
+        std::vector<Node*> ready;
+        std::vector<UniqueTask> spent;
+        std::unique_lock<std::mutex> lk(mtx);
         while (running) {
             auto now = Clock::now();
-            std::vector<size_t> ready;
-            { std::lock_guard<std::mutex> lk(mtx);
-                for (size_t i = 0; i < tasks.size(); ++i) {
-                    auto& t = tasks[i];
-                    if (!t.canceled && t.next_run <= now && t.pending_deps == 0) ready.push_back(i);
+            drain(now, ready, spent);
+            while (!timers.empty() && timers.top().when <= now) {
+                TimerEntry e = timers.top();
+                timers.pop();
+                Node* n = find(e.h);
+                if (!n) continue;
+                if (e.expiry) {
+                    prune(*n, TaskStatus::timed_out);
+                    continue;
                 }
-            }
-            for (auto i : ready) {
-                auto& task = tasks[i];
-                uint64_t task_id = 0;
-                { std::lock_guard<std::mutex> lk(mtx);
-                  for (const auto& [id, idx] : id2idx) {
-                      if (idx == i) { task_id = id; break; }
-                  }
-                }
-                pool.enqueue([this, i, task_id]() {
-                    auto& t = tasks[i];
-                    t.run();
-                    if (t.recurring) {
-                        // Reschedule the same task instead of creating a new one
-                        std::lock_guard<std::mutex> lk(mtx);
-                        t.next_run = Clock::now() + t.interval;
-                        // Create new promise/future for next execution
-                        t.completion = std::promise<std::optional<std::any>>{};
-                    }
-                    completed(task_id);
-                });
-                // Only set next_run to max for non-recurring tasks
-                { std::lock_guard<std::mutex> lk(mtx); 
-                  if (!tasks[i].recurring) {
-                      tasks[i].next_run = TimePoint::max(); 
-                  }
+                if (!n->armed.exchange(false)) continue;   // pruned meanwhile
+                if (satisfy(*n)) {
+                    on_ready(*n, 0);
+                    ready.push_back(n);
                 }
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (!ready.empty() || !spent.empty()) {
+                lk.unlock();
+                // Injection is FIFO: queue the longest remaining paths first.
+                if (ready.size() > 1 && critical_path.load(std::memory_order_relaxed))
+                    std::stable_sort(ready.begin(), ready.end(),
+                                     [](const Node* a, const Node* b) { return before(*a, *b); });
+                for (auto* n : ready) dispatch(*n);
+                ready.clear();
+                spent.clear();
+                lk.lock();
+                continue;
+            }
+
+            sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (intake.empty() && running)
+                sleep(lk, timers.empty() ? TimePoint::max() : timers.top().when);
+            sleeping.store(false, std::memory_order_relaxed);
         }
     }
 };
 
-Scheduler::Scheduler(size_t n) { impl_ = std::make_unique<Impl>(n); }
+Scheduler::Scheduler(size_t n) {
+    PoolOptions pool;
+    pool.threads = std::max<size_t>(n, 1);
+    impl_ = std::make_unique<Impl>(pool);
+}
+Scheduler::Scheduler(const PoolOptions& pool) { impl_ = std::make_unique<Impl>(pool); }
 Scheduler::~Scheduler() { stop(); }
 
 void Scheduler::start() {
@@ -102,16 +900,59 @@ void Scheduler::start() {
 }
 void Scheduler::stop() {
     if (!impl_->running) return;
-    impl_->running = false;
-    impl_->cv.notify_all();
+    { std::lock_guard<std::mutex> lk(impl_->mtx); impl_->running = false; }
+    impl_->interrupt();
     if (impl_->worker.joinable()) impl_->worker.join();
 }
 void Scheduler::wait() { if (impl_->worker.joinable()) impl_->worker.join(); }
 
-TaskHandle Scheduler::create_task(ScheduledTask&& st) { return impl_->add(std::move(st)); }
+TaskHandle Scheduler::create_task(ScheduledTask&& st) {
+    auto& n = impl_->emplace(std::move(st));
+    TaskHandle h = n.self;   // unpinned: n may run and be reclaimed once posted
+    impl_->post(n);
+    return h;
+}
+std::pair<TaskHandle, ScheduledTask*> Scheduler::create_pinned(ScheduledTask&& st) {
+    auto& n = impl_->add(std::move(st), 1);
+    return {n.self, &n.task};
+}
+
+namespace detail {
+ScheduledTask* pin_task(Scheduler& s, TaskHandle h) {
+    std::lock_guard<std::mutex> lk(s.impl_->mtx);
+    auto* n = s.impl_->pin(h);
+    return n ? &n->task : nullptr;
+}
+void unpin_task(Scheduler& s, TaskHandle h) { s.impl_->unpin(h); }
+
+TaskHandle detach_current() {
+    auto* n = Scheduler::Impl::current;
+    n->task.detach_refs.store(2, std::memory_order_relaxed);
+    return n->self;
+}
+
+void complete_detached(Scheduler& s, TaskHandle h) {
+    s.impl_->finish_detached(s.impl_->nodes[h.slot()]);
+}
+
+void resume_after(Scheduler& s, TimePoint when, TaskHandle dep, const TaskOptions& opts,
+                  std::coroutine_handle<> h, std::coroutine_handle<> root, ScheduledTask* task) {
+    std::vector<TaskHandle> deps;
+    if (dep.is_valid()) deps.push_back(dep);
+    // The spawned task keeps the coroutine's group slot until it returns.
+    // Resuming is how the coroutine learns that `dep` failed or was
+    // canceled, so it always runs.
+    TaskOptions o;
+    o.priority = opts.priority;
+    o.deadline = opts.deadline;
+    o.node = opts.node;
+    o.always_run = true;
+    s.schedule_once(when, UniqueTask(Resume(h, root, task)), deps, o);
+}
+}  // namespace detail
 
 TaskHandle Scheduler::schedule_once(const std::string& iso, Task t,
-                                   const std::vector<TaskHandle>& d) {
+                                   const std::vector<TaskHandle>& d, const TaskOptions& o) {
     std::tm tm{}; 
     std::istringstream ss(iso);
     ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
@@ -123,62 +964,209 @@ TaskHandle Scheduler::schedule_once(const std::string& iso, Task t,
     auto duration_from_now = tp - system_now;
     auto steady_target = steady_now + duration_from_now;
     
-    return schedule_once(steady_target, std::move(t), d);
+    return schedule_once(steady_target, std::move(t), d, o);
 }
 TaskHandle Scheduler::schedule_once(TimePoint tp, Task t,
-                                   const std::vector<TaskHandle>& d) {
+                                   const std::vector<TaskHandle>& d, const TaskOptions& o) {
+    return schedule_once(tp, UniqueTask(std::move(t)), d, o);
+}
+TaskHandle Scheduler::schedule_once(TimePoint tp, UniqueTask t,
+                                   const std::vector<TaskHandle>& d, const TaskOptions& o) {
     ScheduledTask st;
-    st.func = t;
+    st.func = std::move(t);
     st.next_run = tp;
     st.dependencies = d;
+    st.apply(o);
     return create_task(std::move(st));
 }
+std::vector<TaskHandle> Scheduler::submit(TaskGraph&& graph, TimePoint start) {
+    ResultCache::bind(graph, nullptr);
+    return impl_->add_graph(graph, start);
+}
+CachedRun Scheduler::submit(TaskGraph&& graph, ResultCache& cache, TimePoint start) {
+    CachedRun run = ResultCache::bind(graph, &cache);
+    run.handles = impl_->add_graph(graph, start);
+    return run;
+}
+TaskFuture<void> Scheduler::submit(Pipeline&& pipeline, const std::vector<TaskHandle>& deps,
+                                   const TaskOptions& opts) {
+    ScheduledTask st;
+    st.func = [this, core = std::move(pipeline.core_)] { core->start(*this); };
+    st.next_run = Clock::now();
+    st.dependencies = deps;
+    st.apply(opts);
+    auto [h, t] = create_pinned(std::move(st));
+    return TaskFuture<void>(*this, h, t);
+}
+void Scheduler::run(CompiledGraph& graph) { graph.run(impl_->pool); }
+void Scheduler::run_n(CompiledGraph& graph, size_t n) {
+    for (size_t i = 0; i < n; ++i) graph.run(impl_->pool);
+}
 TaskHandle Scheduler::schedule_recurring(const std::string& cron, Task t,
-                                        const std::vector<TaskHandle>& d) {
+                                        const std::vector<TaskHandle>& d, const TaskOptions& o) {
     auto s = parse_cron(cron); 
     if (!s.valid) return {};
-    auto nxt = next_cron_time(s);
-    
-    // Convert from system_clock to steady_clock
-    auto system_now = std::chrono::system_clock::now();
-    auto steady_now = Clock::now();
-    auto duration_from_now = nxt - system_now;
-    auto steady_target = steady_now + duration_from_now;
     
     ScheduledTask st;
-    st.func = t;
-    st.next_run = steady_target;
-    st.interval = std::chrono::hours(24);
-    st.recurring = true;
+    st.next_run = to_steady(next_cron_time(s));
     st.cron_expr = cron;
+    st.cron = s;
     st.dependencies = d;
+    set_recurring(st, std::move(t), o);
     return create_task(std::move(st));
 }
 TaskHandle Scheduler::schedule_every(Duration i, Task t,
-                                    const std::vector<TaskHandle>& d) {
+                                    const std::vector<TaskHandle>& d, const TaskOptions& o) {
     ScheduledTask st;
-    st.func = t;
     st.next_run = Clock::now() + i;
     st.interval = i;
-    st.recurring = true;
     st.dependencies = d;
+    set_recurring(st, std::move(t), o);
     return create_task(std::move(st));
 }
+// With overlapping runs the task itself only ticks (see OverlappingRuns),
+// so the group limits the runs rather than the ticks.
+void Scheduler::set_recurring(ScheduledTask& st, Task t, const TaskOptions& o) {
+    st.apply(o);
+    st.recurring = true;
+    st.recurrence = o.recurrence;
+    st.timeout = Duration::max();   // one-shot tasks only
+    if (o.recurrence.max_concurrency > 1 && (st.cron.valid || o.recurrence.rate == Rate::fixed_rate)) {
+        st.func = [this, runs = std::make_shared<OverlappingRuns>(std::move(t), o)] {
+            runs->tick(*this, Impl::current->self);
+        };
+        st.group = nullptr;
+    } else {
+        st.func = std::move(t);
+    }
+}
+void Scheduler::set_priority_aging(Duration step) { impl_->pool.set_aging(step); }
+void Scheduler::set_critical_path(bool enabled) { impl_->critical_path.store(enabled); }
+Duration Scheduler::cost_estimate(const std::string& name) const {
+    std::lock_guard<std::mutex> lk(impl_->cost_mtx);
+    auto it = impl_->costs.find(name);
+    int64_t ns = it == impl_->costs.end() ? 0 : it->second.ns.load(std::memory_order_relaxed);
+    return std::chrono::duration_cast<Duration>(std::chrono::nanoseconds(std::max<int64_t>(ns, 0)));
+}
+void Scheduler::set_cost_estimate(const std::string& name, Duration d) {
+    std::lock_guard<std::mutex> lk(impl_->cost_mtx);
+    impl_->costs[name].ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count(),
+                                std::memory_order_relaxed);
+}
 
 
 
+// One-shot: waits until the task has run. Recurring: waits for its next run.
 void Scheduler::wait_for(TaskHandle h) {
-    auto it = impl_->id2idx.find(h.id);
-    if (it == impl_->id2idx.end()) return;
-    impl_->tasks[it->second].future().wait();
-}
-template<class T>
-T Scheduler::get_result(TaskHandle h) {
-    auto it = impl_->id2idx.find(h.id);
-    if (it == impl_->id2idx.end()) throw std::runtime_error("bad handle");
-    auto f = impl_->tasks[it->second].future().get();
-    if (!f) throw std::runtime_error("no result");
-    return std::any_cast<T>(*f);
+    Impl::Node* n;
+    uint32_t seen;
+    {
+        std::lock_guard<std::mutex> lk(impl_->mtx);
+        n = impl_->pin(h);
+        if (!n) return;     // finished and reclaimed
+        seen = n->task.recurring ? n->task.completions.load() : 0;
+    }
+    n->task.wait_past(seen);
+    impl_->unpin(h);
+}
+bool Scheduler::cancel(TaskHandle h) {
+    Impl::Node* n;
+    {
+        std::lock_guard<std::mutex> lk(impl_->mtx);
+        n = impl_->pin(h);
+        if (!n) return false;   // finished and reclaimed
+    }
+    bool stopped = impl_->prune(*n, TaskStatus::canceled);
+    impl_->unpin(h);
+    return stopped;
+}
+size_t Scheduler::task_count() const { return impl_->nodes.live(); }
+
+SchedulerMetrics Scheduler::metrics() const {
+    SchedulerMetrics m;
+    m.uptime_seconds = static_cast<double>(detail::trace_clock_ns() - impl_->epoch_ns) / 1e9;
+    m.live_tasks = impl_->nodes.live();
+    m.queue_depth = impl_->pool.queued();
+    m.workers = impl_->pool.worker_metrics();
+#if TASKFLOW_INSTRUMENTATION
+    m.enabled = true;
+    for (size_t i = 0; i <= impl_->pool.size(); ++i) {
+        auto& st = impl_->stats[i];
+        m.submitted += st.submitted.get();
+        m.started += st.started.get();
+        m.finished += st.finished.get();
+        detail::TaskStats::fold(st.dependency_wait, m.dependency_wait);
+        detail::TaskStats::fold(st.queue_wait, m.queue_wait);
+        detail::TaskStats::fold(st.run_time, m.run_time);
+    }
+    if (m.uptime_seconds > 0) m.throughput = static_cast<double>(m.finished) / m.uptime_seconds;
+#endif
+    return m;
+}
+
+void Scheduler::start_trace([[maybe_unused]] size_t events_per_worker) {
+#if TASKFLOW_INSTRUMENTATION
+    std::lock_guard<std::mutex> lk(impl_->mtx);
+    if (impl_->rings.empty()) {
+        for (size_t i = 0; i < impl_->pool.size(); ++i)
+            impl_->rings.push_back(std::make_unique<detail::TraceRing>(events_per_worker));
+    }
+    impl_->tracing.store(true, std::memory_order_release);
+#endif
+}
+
+void Scheduler::stop_trace() {
+#if TASKFLOW_INSTRUMENTATION
+    impl_->tracing.store(false, std::memory_order_relaxed);
+#endif
+}
+
+void Scheduler::write_trace(std::ostream& out) const {
+    out << "{\"traceEvents\":[";
+#if TASKFLOW_INSTRUMENTATION
+    struct Run {
+        detail::TraceRing::Record r;
+        size_t tid;
+    };
+    std::vector<Run> runs;
+    {
+        std::lock_guard<std::mutex> lk(impl_->mtx);
+        for (size_t t = 0; t < impl_->rings.size(); ++t)
+            impl_->rings[t]->for_each([&](const detail::TraceRing::Record& r) { runs.push_back({r, t}); });
+    }
+    std::sort(runs.begin(), runs.end(), [](const Run& a, const Run& b) { return a.r.start_ns < b.r.start_ns; });
+    std::unordered_map<uint64_t, const Run*> by_task;
+    for (auto& run : runs) by_task[run.r.task] = &run;
+
+    auto us = [&](int64_t ns) { return static_cast<double>(ns - impl_->epoch_ns) / 1e3; };
+    const char* sep = "";
+    for (size_t t = 0; t < impl_->pool.size(); ++t) {
+        out << sep << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+            << ",\"args\":{\"name\":\"worker " << t << "\"}}";
+        sep = ",";
+    }
+    uint64_t flow = 0;
+    out.precision(3);
+    out << std::fixed;
+    for (auto& run : runs) {
+        out << sep << "\n{\"name\":";
+        write_json_string(out, run.r.name);
+        out << ",\"cat\":\"task\",\"ph\":\"X\",\"pid\":1,\"tid\":" << run.tid
+            << ",\"ts\":" << us(run.r.start_ns) << ",\"dur\":" << static_cast<double>(run.r.end_ns - run.r.start_ns) / 1e3
+            << ",\"args\":{\"task\":" << run.r.task << "}}";
+        sep = ",";
+        auto it = by_task.find(run.r.released_by);
+        if (run.r.released_by == 0 || it == by_task.end()) continue;
+        const Run& from = *it->second;
+        ++flow;
+        out << ",\n{\"name\":\"release\",\"cat\":\"dep\",\"ph\":\"s\",\"id\":" << flow
+            << ",\"pid\":1,\"tid\":" << from.tid << ",\"ts\":" << us(from.r.end_ns) << "}"
+            << ",\n{\"name\":\"release\",\"cat\":\"dep\",\"ph\":\"f\",\"bp\":\"e\",\"id\":" << flow
+            << ",\"pid\":1,\"tid\":" << run.tid << ",\"ts\":" << us(run.r.start_ns) << "}";
+    }
+    out << std::defaultfloat;
+#endif
+    out << "],\"displayTimeUnit\":\"ns\"}\n";
 }
 
 }  // namespace tf
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include <taskflow/task_graph.hpp>
+#include <stdexcept>
+
+namespace tf {
+
+TaskGraph::NodeId TaskGraph::add(UniqueTask fn) {
+    nodes_.push_back(Node{{}, std::move(fn), {}, {}, 0, {}, {}, false});
+    return nodes_.size() - 1;
+}
+
+TaskGraph::NodeId TaskGraph::add(std::string name, UniqueTask fn) {
+    NodeId id = nodes_.size();
+    if (!by_name_.emplace(name, id).second)
+        throw std::invalid_argument("TaskGraph: duplicate node '" + name + "'");
+    nodes_.push_back(Node{std::move(name), std::move(fn), {}, {}, 0, {}, {}, false});
+    return id;
+}
+
+TaskGraph::NodeId TaskGraph::add_cached(std::string name, CacheKey input, CachedTask fn) {
+    NodeId id = add(std::move(name), UniqueTask{});
+    nodes_[id].cached = std::move(fn);
+    nodes_[id].input = input;
+    return id;
+}
+
+void TaskGraph::check(NodeId n) const {
+    if (n >= nodes_.size()) throw std::out_of_range("TaskGraph: bad node id");
+}
+
+void TaskGraph::precede(NodeId from, NodeId to) {
+    check(from);
+    check(to);
+    nodes_[from].successors.push_back(to);
+    ++nodes_[to].in_degree;
+    ++edges_;
+}
+
+void TaskGraph::precede(const std::string& from, const std::string& to) {
+    precede(find(from), find(to));
+}
+
+void TaskGraph::depend_on(NodeId n, TaskHandle external) {
+    check(n);
+    if (external.is_valid()) nodes_[n].external.push_back(external);
+}
+
+TaskGraph::NodeId TaskGraph::find(const std::string& name) const {
+    auto it = by_name_.find(name);
+    if (it == by_name_.end()) throw std::out_of_range("TaskGraph: no node '" + name + "'");
+    return it->second;
+}
+
+std::vector<TaskGraph::NodeId> TaskGraph::topological_order() const {
+    std::vector<uint32_t> indeg(nodes_.size());
+    std::vector<NodeId> order;
+    order.reserve(nodes_.size());
+    for (NodeId i = 0; i < nodes_.size(); ++i) {
+        indeg[i] = nodes_[i].in_degree;
+        if (indeg[i] == 0) order.push_back(i);
+    }
+    // `order` doubles as the BFS queue.
+    for (size_t head = 0; head < order.size(); ++head)
+        for (NodeId s : nodes_[order[head]].successors)
+            if (--indeg[s] == 0) order.push_back(s);
+
+    if (order.size() != nodes_.size()) {
+        NodeId stuck = 0;
+        while (indeg[stuck] == 0) ++stuck;
+        // Walk predecessors-with-remaining-degree backwards until a node repeats:
+        // that node is on a cycle (not just downstream of one).
+        std::vector<NodeId> pred(nodes_.size(), nodes_.size());
+        for (NodeId i = 0; i < nodes_.size(); ++i)
+            if (indeg[i] != 0)
+                for (NodeId s : nodes_[i].successors) pred[s] = i;
+        std::vector<bool> seen(nodes_.size());
+        while (!seen[stuck]) { seen[stuck] = true; stuck = pred[stuck]; }
+        const auto& nm = nodes_[stuck].name;
+        throw std::invalid_argument("TaskGraph: cycle through " +
+                                    (nm.empty() ? "#" + std::to_string(stuck) : "'" + nm + "'"));
+    }
+    return order;
+}
+
+bool TaskGraph::has_cycle() const {
+    try { topological_order(); } catch (const std::invalid_argument&) { return true; }
+    return false;
+}
+
+}  // namespace tf
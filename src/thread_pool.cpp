@@ -1,34 +1,467 @@
 #include <taskflow/thread_pool.hpp>
+#include <algorithm>
+
+#if __has_include(<sched.h>) && defined(__linux__)
+#include <sched.h>
+#define TASKFLOW_HAS_AFFINITY 1
+#else
+#define TASKFLOW_HAS_AFFINITY 0
+#endif
 
 namespace tf {
 
-ThreadPool::ThreadPool(size_t n) {
-    for (size_t i = 0; i < n; ++i) {
-        workers_.emplace_back([this] {
-            while (true) {
-                std::function<void()> task;
-                {
-                    std::unique_lock<std::mutex> lk(mtx_);
-                    cv_.wait(lk, [this]{ return stop_ || !tasks_.empty(); });
-                    if (stop_ && tasks_.empty()) return;
-                    task = std::move(tasks_.front());
-                    tasks_.pop();
-                }
-                try { task(); } catch (...) {}
+namespace {
+thread_local ThreadPool* tls_pool = nullptr;
+thread_local int tls_index = -1;
+
+thread_local int tls_blocking = 0;   // depth of ThreadPool::Blocking scopes
+
+constexpr uint32_t kLocalRounds = 16;   // yield rounds, after spinning, kept to the own node
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Heap box for callables handed to enqueue(); frees itself after running.
+struct BoxedTask : ThreadPool::Work {
+    explicit BoxedTask(UniqueTask&& t) : fn(std::move(t)) {
+        execute = [](ThreadPool::Work* w) {
+            std::unique_ptr<BoxedTask> self(static_cast<BoxedTask*>(w));
+            self->fn();
+        };
+    }
+    UniqueTask fn;
+};
+
+PoolOptions with_threads(size_t n) {
+    PoolOptions o;
+    o.threads = n ? n : 1;
+    return o;
+}
+}  // namespace
+
+ThreadPool::ThreadPool(size_t n) : ThreadPool(with_threads(n)) {}
+
+ThreadPool::ThreadPool(const PoolOptions& opts)
+    : spin_rounds_(opts.spin_rounds), idle_rounds_(opts.spin_rounds + opts.yield_rounds),
+      idle_timeout_(opts.idle_timeout) {
+    // Pinned, worker i takes the i-th (CPU, node) slot with the nodes taking
+    // turns, so a pool smaller than the machine still spans every node.
+    std::vector<std::pair<int, int>> slots;
+    if (opts.pinning != Pinning::none) {
+        topology_ = opts.topology.nodes.empty() ? Topology::detect() : opts.topology;
+        for (size_t k = 0; slots.size() < topology_.cpus(); ++k)
+            for (size_t i = 0; i < topology_.nodes.size(); ++i)
+                if (k < topology_.nodes[i].cpus.size())
+                    slots.emplace_back(topology_.nodes[i].cpus[k], static_cast<int>(i));
+    }
+    size_t n = opts.threads;
+    if (n == 0) n = slots.empty() ? std::max(1u, std::thread::hardware_concurrency()) : slots.size();
+    core_ = n;
+    // Spare slots exist from the start, so the victim lists never change.
+    const size_t slots_n = std::max(n, opts.max_threads);
+    for (size_t i = 0; i < std::max<size_t>(1, topology_.nodes.size()); ++i)
+        node_queues_.push_back(std::make_unique<NodeQueue>());
+    for (size_t i = 0; i < slots_n; ++i) {
+        auto w = std::make_unique<Worker>();
+        w->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+        if (!slots.empty()) {
+            auto [cpu, node] = slots[i % slots.size()];
+            w->node = node;
+            w->cpus = opts.pinning == Pinning::core ? std::vector<int>{cpu} : topology_.nodes[node].cpus;
+        }
+        workers_.push_back(std::move(w));
+    }
+    for (size_t i = 0; i < slots_n; ++i)
+        for (size_t v = 0; v < slots_n; ++v)
+            if (v != i) (workers_[v]->node == workers_[i]->node ? workers_[i]->near : workers_[i]->far).push_back(v);
+    // Start threads only after every deque exists: workers steal from each other.
+    for (size_t i = 0; i < n; ++i) start(i);
+}
+
+ThreadPool::~ThreadPool() { shutdown(); }
+
+void ThreadPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lk(spawn_mtx_);
+        closed_ = true;
+    }
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        stop_ = true;
+    }
+    for (auto& nq : node_queues_) nq->parked.notify_all();
+    for (auto& w : workers_) if (w->thread.joinable()) w->thread.join();
+}
+
+void ThreadPool::start(size_t id) {
+    workers_[id]->live.store(true, std::memory_order_relaxed);
+    live_.fetch_add(1, std::memory_order_relaxed);
+    workers_[id]->thread = std::thread([this, id] { run(id); });
+}
+
+// A slot whose spare has retired is reused; its thread is on its way out
+// and is joined first.
+void ThreadPool::grow() {
+    std::lock_guard<std::mutex> lk(spawn_mtx_);
+    if (closed_ || live_.load() - blocked_.load() >= core_) return;
+    for (size_t i = core_; i < workers_.size(); ++i) {
+        auto& w = *workers_[i];
+        if (w.live.load(std::memory_order_relaxed)) continue;
+        if (w.thread.joinable()) w.thread.join();
+        start(i);
+        return;
+    }
+}
+
+bool ThreadPool::retire(size_t id) {
+    std::lock_guard<std::mutex> lk(spawn_mtx_);
+    if (has_work() || live_.load() - blocked_.load() <= core_) return false;
+    workers_[id]->live.store(false, std::memory_order_relaxed);
+    live_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+ThreadPool::Blocking::Blocking() : pool_(nullptr) {
+    if (tls_blocking++ != 0 || !tls_pool || tls_pool->workers_.size() == tls_pool->core_) return;
+    pool_ = tls_pool;
+    pool_->blocked_.fetch_add(1);
+    pool_->grow();
+}
+
+ThreadPool::Blocking::~Blocking() {
+    --tls_blocking;
+    if (pool_) pool_->blocked_.fetch_sub(1);
+}
+
+int ThreadPool::current_worker() const { return tls_pool == this ? tls_index : -1; }
+int ThreadPool::current_node() const { return tls_pool == this ? workers_[tls_index]->node : -1; }
+ThreadPool* ThreadPool::current() { return tls_pool; }
+
+bool ThreadPool::run_one() {
+    int self = current_worker();
+    if (self < 0) return false;
+    Work* job = take(static_cast<size_t>(self));
+    if (!job) return false;
+    run_job(static_cast<size_t>(self), job);
+    return true;
+}
+
+size_t ThreadPool::queued() const {
+    size_t n = injected_.load(std::memory_order_relaxed) + node_queued_.load(std::memory_order_relaxed);
+    for (auto& c : prio_count_) n += c.load(std::memory_order_relaxed);
+    for (auto& w : workers_) n += w->deque.size();
+    return n;
+}
+
+std::vector<WorkerMetrics> ThreadPool::worker_metrics() const {
+    std::vector<WorkerMetrics> out(workers_.size());
+#if TASKFLOW_INSTRUMENTATION
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        auto& st = workers_[i]->stats;
+        out[i] = {st.jobs.get(), st.steals.get(), st.busy_ns.get()};
+    }
+#endif
+    return out;
+}
+
+void ThreadPool::run_job(size_t id, Work* job) {
+#if TASKFLOW_INSTRUMENTATION
+    int64_t t0 = detail::trace_clock_ns();
+#endif
+    try { job->execute(job); } catch (...) {}
+#if TASKFLOW_INSTRUMENTATION
+    auto& st = workers_[id]->stats;
+    st.jobs.add(1);
+    st.busy_ns.add(static_cast<uint64_t>(detail::trace_clock_ns() - t0));
+#else
+    (void)id;
+#endif
+}
+
+void ThreadPool::enqueue(UniqueTask task) {
+    auto* box = new BoxedTask(std::move(task));
+    if (!push(box)) delete box;
+}
+
+void ThreadPool::enqueue(UniqueTask task, Priority priority, TimePoint deadline) {
+    auto* box = new BoxedTask(std::move(task));
+    box->priority = priority;
+    box->deadline = deadline;
+    if (!push(box)) delete box;
+}
+
+bool ThreadPool::submit(Work* w) { return push(w); }
+
+// Work spawned by a running task is still accepted while the pool drains;
+// outside submissions are refused once stop_ is set.
+bool ThreadPool::push(Work* job) {
+    if (job->prioritized()) return push_prioritized(job);
+    int self = current_worker();
+    if (job->node >= 0 && static_cast<size_t>(job->node) < nodes() && nodes() > 1 &&
+        (self < 0 || workers_[self]->node != job->node))
+        return push_node(job);
+    if (self >= 0) {
+        workers_[self]->deque.push(job);
+    } else {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (stop_) return false;
+        injection_.push_back(job);
+        injected_.fetch_add(1, std::memory_order_relaxed);
+    }
+    wake_one(self >= 0 ? workers_[self]->node : -1);
+    return true;
+}
+
+bool ThreadPool::push_node(Work* job) {
+    const int node = job->node;   // job may be gone once the lock is released
+    {
+        std::lock_guard<std::mutex> lk(mtx_);
+        if (stop_ && current_worker() < 0) return false;
+        auto& nq = *node_queues_[node];
+        nq.q.push_back(job);
+        nq.size.fetch_add(1, std::memory_order_relaxed);
+        node_queued_.fetch_add(1, std::memory_order_relaxed);
+    }
+    wake_one(node);
+    return true;
+}
+
+bool ThreadPool::push_prioritized(Work* job) {
+    // Outside pushes hold mtx_ across the insert, like the injection path,
+    // so none can land after the workers have drained and exited.
+    std::unique_lock<std::mutex> outer(mtx_, std::defer_lock);
+    if (current_worker() < 0) {
+        outer.lock();
+        if (stop_) return false;
+    }
+    int64_t now = detail::trace_clock_ns();
+    int64_t key = job->deadline == TimePoint::max()
+        ? now + aging_ns_.load(std::memory_order_relaxed)
+        : std::chrono::duration_cast<std::chrono::nanoseconds>(job->deadline.time_since_epoch()).count();
+    size_t c = std::min<size_t>(static_cast<size_t>(job->priority), kClasses - 1);
+    {
+        std::lock_guard<std::mutex> lk(prio_mtx_);
+        prio_[c].push_back({key, prio_seq_++, now, job});
+        std::push_heap(prio_[c].begin(), prio_[c].end(), std::greater<>{});
+        prio_count_[c].fetch_add(1, std::memory_order_relaxed);
+    }
+    if (outer.owns_lock()) outer.unlock();
+    wake_one();
+    return true;
+}
+
+// Each class is judged by its most urgent entry, promoted one class per aging
+// step waited. Lowest effective class wins; ties go to the original class.
+ThreadPool::Work* ThreadPool::take_prioritized(bool urgent_only) {
+    size_t total = 0;
+    for (auto& c : prio_count_) total += c.load(std::memory_order_relaxed);
+    if (total == 0) return nullptr;
+    std::lock_guard<std::mutex> lk(prio_mtx_);
+    int64_t now = detail::trace_clock_ns();
+    int64_t step = aging_ns_.load(std::memory_order_relaxed);
+    size_t best = kClasses, best_eff = kClasses;
+    for (size_t c = 0; c < kClasses; ++c) {
+        if (prio_[c].empty()) continue;
+        size_t promoted = static_cast<size_t>(std::max<int64_t>(0, now - prio_[c].front().queued_ns) / step);
+        size_t eff = c - std::min(c, promoted);
+        if (eff < best_eff) { best = c; best_eff = eff; }
+    }
+    if (best == kClasses) return nullptr;
+    // Un-aged normal work competes fairly with the deques; low waits for them.
+    if (urgent_only && best_eff > static_cast<size_t>(Priority::normal)) return nullptr;
+    auto& h = prio_[best];
+    std::pop_heap(h.begin(), h.end(), std::greater<>{});
+    Work* w = h.back().work;
+    h.pop_back();
+    prio_count_[best].fetch_sub(1, std::memory_order_relaxed);
+    return w;
+}
+
+// Pairs with the parking sequence in run(): either the worker sees the new
+// job in has_work(), or we see it registered and notify. Nobody is woken
+// while a worker that can take the job is searching or about to: it either
+// finds the job or sees it before parking. Notified workers not yet up do
+// not count as parked, so back-to-back pushes wake as many workers.
+void ThreadPool::wake_one(int node) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) == 0) return;
+    if (node >= 0 ? attended(*node_queues_[node])
+                  : std::any_of(node_queues_.begin(), node_queues_.end(),
+                                [this](const auto& nq) { return attended(*nq); }))
+        return;
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto idle = [](const NodeQueue& nq) { return nq.parked.waiters() > nq.waking.load(std::memory_order_relaxed); };
+    NodeQueue* target = node >= 0 && idle(*node_queues_[node]) ? node_queues_[node].get() : nullptr;
+    for (size_t i = 0; !target && i < node_queues_.size(); ++i)
+        if (idle(*node_queues_[i])) target = node_queues_[i].get();
+    if (!target) return;
+    target->waking.fetch_add(1);
+    target->parked.notify_one();
+}
+
+bool ThreadPool::has_work() const {
+    if (injected_.load(std::memory_order_relaxed) != 0) return true;
+    if (node_queued_.load(std::memory_order_relaxed) != 0) return true;
+    for (auto& c : prio_count_) if (c.load(std::memory_order_relaxed) != 0) return true;
+    for (auto& w : workers_) if (!w->deque.empty()) return true;
+    return false;
+}
+
+ThreadPool::Work* ThreadPool::take(size_t id, bool remote) {
+    if (Work* j = take_prioritized(true)) return j;
+    if (auto j = workers_[id]->deque.pop()) return *j;
+    if (Work* j = take_queued(workers_[id]->node, false)) return j;
+    if (Work* j = steal(id, remote)) return j;
+    if (remote)
+        if (Work* j = take_queued(workers_[id]->node, true)) return j;
+    return take_prioritized(false);
+}
+
+// A node with a worker looking for work, or about to, takes care of its own.
+bool ThreadPool::attended(const NodeQueue& nq) const {
+    return nq.searching.load(std::memory_order_relaxed) != 0 || nq.waking.load(std::memory_order_relaxed) != 0;
+}
+
+// The node's own queue, then the injection queue; with `remote`, the other
+// nodes' unattended queues instead.
+ThreadPool::Work* ThreadPool::take_queued(int node, bool remote) {
+    auto& own = *node_queues_[node];
+    const size_t own_size = own.size.load(std::memory_order_relaxed);
+    if (remote ? node_queued_.load(std::memory_order_relaxed) == own_size
+               : own_size == 0 && injected_.load(std::memory_order_relaxed) == 0)
+        return nullptr;
+    std::lock_guard<std::mutex> lk(mtx_);
+    auto pop = [this](NodeQueue& nq) {
+        Work* j = nq.q.front();
+        nq.q.pop_front();
+        nq.size.fetch_sub(1, std::memory_order_relaxed);
+        node_queued_.fetch_sub(1, std::memory_order_relaxed);
+        return j;
+    };
+    if (remote) {
+        for (auto& nq : node_queues_)
+            if (nq.get() != &own && !nq->q.empty() && !attended(*nq)) return pop(*nq);
+        return nullptr;
+    }
+    if (!own.q.empty()) return pop(own);
+    if (!injection_.empty()) {
+        Work* j = injection_.front();
+        injection_.pop_front();
+        injected_.fetch_sub(1, std::memory_order_relaxed);
+        return j;
+    }
+    return nullptr;
+}
+
+// Victims on the worker's own node first; others only with `remote`, and
+// only on nodes that are not attended().
+ThreadPool::Work* ThreadPool::steal(size_t id, bool remote) {
+    Worker& self = *workers_[id];
+    // xorshift64: pick a random starting victim so thieves spread out.
+    uint64_t& x = self.rng;
+    x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+    for (const auto* victims : {&self.near, &self.far}) {
+        if (victims == &self.far && !remote) break;
+        const size_t n = victims->size();
+        for (size_t k = 0; k < n; ++k) {
+            size_t v = (*victims)[(x + k) % n];
+            if (victims == &self.far && attended(*node_queues_[workers_[v]->node])) continue;
+            if (auto j = workers_[v]->deque.steal()) {
+#if TASKFLOW_INSTRUMENTATION
+                self.stats.steals.add(1);
+#endif
+                return *j;
             }
-        });
+        }
     }
+    return nullptr;
 }
 
-ThreadPool::~ThreadPool() {
-    { std::lock_guard<std::mutex> lk(mtx_); stop_ = true; }
-    cv_.notify_all();
-    for (auto& w : workers_) if (w.joinable()) w.join();
+// Best effort: a worker the OS will not pin runs where it is put.
+void ThreadPool::pin(size_t id) {
+#if TASKFLOW_HAS_AFFINITY
+    const auto& cpus = workers_[id]->cpus;
+    if (cpus.empty()) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus)
+        if (c < CPU_SETSIZE) CPU_SET(c, &set);
+    ::sched_setaffinity(0, sizeof set, &set);
+#else
+    (void)id;
+#endif
 }
 
-void ThreadPool::enqueue(std::function<void()> task) {
-    { std::lock_guard<std::mutex> lk(mtx_); if (stop_) return; tasks_.push(std::move(task)); }
-    cv_.notify_one();
+void ThreadPool::run(size_t id) {
+    pin(id);
+    tls_pool = this;
+    tls_index = static_cast<int>(id);
+    const int node = workers_[id]->node;
+    auto& home = *node_queues_[node];
+    const bool spare = id >= core_;
+    // Remote nodes wait out the spin phase and kLocalRounds yields (at most
+    // half of them), so a short pause cannot pull work off its node; the
+    // last round before parking always looks everywhere.
+    const uint32_t yield_rounds = idle_rounds_ - spin_rounds_;
+    const uint32_t local_rounds = idle_rounds_ == 0 ? 0
+        : std::min(spin_rounds_ + std::min(kLocalRounds, yield_rounds / 2), idle_rounds_ - 1);
+    // Counted in home.searching from waking up (or first coming up empty)
+    // until finding a job or parking. Returns whether this was the last one.
+    bool searching = false;
+    auto search = [&](bool on) {
+        if (on == searching) return false;
+        searching = on;
+        if (on) {
+            home.searching.fetch_add(1);
+            return false;
+        }
+        return home.searching.fetch_sub(1) == 1;
+    };
+    while (true) {
+        Work* job = take(id, false);
+        if (!job) {
+            search(true);
+            for (uint32_t r = 0; !job && r < idle_rounds_; ++r) {
+                if (r < spin_rounds_) cpu_relax();
+                else std::this_thread::yield();
+                job = take(id, r >= local_rounds);
+            }
+        }
+        if (job) {
+            // The last searcher to find work hands the search on, in case
+            // more came in that wake_one() left to it.
+            if (search(false)) wake_one(node);
+            run_job(id, job);
+            continue;
+        }
+
+        EventCount::Key key;
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            key = home.parked.prepare_wait();
+            sleeping_.fetch_add(1, std::memory_order_seq_cst);
+            search(false);   // parked now, so wake_one() can find it
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        bool woken = true;
+        if (stop_ || has_work()) home.parked.cancel_wait();
+        else woken = home.parked.wait(key, spare ? idle_timeout_ : std::chrono::nanoseconds::max());
+        search(true);   // before giving up the waking mark
+        {
+            std::lock_guard<std::mutex> lk(mtx_);
+            if (home.waking.load(std::memory_order_relaxed)) home.waking.fetch_sub(1);
+            sleeping_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        if ((stop_ && !has_work()) || (!woken && retire(id))) {
+            search(false);
+            return;
+        }
+    }
 }
 
-}  // namespace tf
\ No newline at end of file
+}  // namespace tf
@@ -0,0 +1,97 @@
+#include <taskflow/topology.hpp>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if __has_include(<sched.h>) && defined(__linux__)
+#include <sched.h>
+#define TASKFLOW_HAS_AFFINITY 1
+#else
+#define TASKFLOW_HAS_AFFINITY 0
+#endif
+
+namespace tf {
+
+namespace {
+// CPUs the calling thread may run on.
+std::vector<int> allowed_cpus() {
+    std::vector<int> out;
+#if TASKFLOW_HAS_AFFINITY
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (::sched_getaffinity(0, sizeof set, &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &set)) out.push_back(c);
+        return out;
+    }
+#endif
+    const int n = std::max(1u, std::thread::hardware_concurrency());
+    for (int c = 0; c < n; ++c) out.push_back(c);
+    return out;
+}
+}  // namespace
+
+size_t Topology::cpus() const {
+    size_t n = 0;
+    for (auto& node : nodes) n += node.cpus.size();
+    return n;
+}
+
+int Topology::node_of(int cpu) const {
+    for (size_t i = 0; i < nodes.size(); ++i)
+        if (std::binary_search(nodes[i].cpus.begin(), nodes[i].cpus.end(), cpu)) return static_cast<int>(i);
+    return -1;
+}
+
+std::vector<int> Topology::parse_cpulist(const std::string& s) {
+    std::vector<int> out;
+    std::istringstream in(s);
+    std::string part;
+    while (std::getline(in, part, ',')) {
+        int lo, hi;
+        char dash;
+        std::istringstream p(part);
+        if (!(p >> lo) || lo < 0) continue;
+        hi = lo;
+        if (p >> dash && (dash != '-' || !(p >> hi) || hi < lo)) continue;
+        for (int c = lo; c <= hi; ++c) out.push_back(c);
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+    return out;
+}
+
+Topology Topology::read(const std::filesystem::path& dir) {
+    Topology t;
+    std::error_code ec;
+    for (auto& e : std::filesystem::directory_iterator(dir, ec)) {
+        const std::string name = e.path().filename().string();
+        if (name.size() < 5 || name.compare(0, 4, "node") != 0 ||
+            !std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; }))
+            continue;
+        std::ifstream in(e.path() / "cpulist");
+        std::string list;
+        if (!std::getline(in, list)) continue;
+        Node node{std::stoi(name.substr(4)), parse_cpulist(list)};
+        if (!node.cpus.empty()) t.nodes.push_back(std::move(node));
+    }
+    std::sort(t.nodes.begin(), t.nodes.end(), [](const Node& a, const Node& b) { return a.id < b.id; });
+    return t;
+}
+
+Topology Topology::detect() {
+    const std::vector<int> allowed = allowed_cpus();
+    Topology t = read("/sys/devices/system/node");
+    for (auto& node : t.nodes) {
+        std::vector<int> keep;
+        std::set_intersection(node.cpus.begin(), node.cpus.end(), allowed.begin(), allowed.end(),
+                              std::back_inserter(keep));
+        node.cpus = std::move(keep);
+    }
+    std::erase_if(t.nodes, [](const Node& n) { return n.cpus.empty(); });
+    if (t.nodes.empty()) t.nodes.push_back({0, allowed});
+    return t;
+}
+
+}  // namespace tf
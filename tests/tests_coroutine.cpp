@@ -0,0 +1,133 @@
+#include <taskflow/scheduler.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+class CoroutineTest : public ::testing::Test {
+protected:
+    void SetUp() override { scheduler.start(); }
+    void TearDown() override { scheduler.stop(); }
+
+    tf::Scheduler scheduler{2};
+};
+
+TEST_F(CoroutineTest, AwaitsFuturesAndHandles) {
+    std::atomic<bool> side{false};
+    auto value = scheduler.schedule_once(tf::Clock::now() + 10ms, [] { return 21; });
+    auto plain = scheduler.schedule_once(tf::Clock::now() + 20ms, [&] { side = true; });
+    auto co = [&]() -> tf::Co<int> {
+        int x = co_await value;
+        co_await plain;
+        EXPECT_TRUE(side.load());
+        co_return x * 2;
+    };
+    auto f = scheduler.spawn(co());
+    static_assert(std::is_same_v<decltype(f), tf::TaskFuture<int>>);
+    EXPECT_EQ(f.get(), 42);
+}
+
+TEST_F(CoroutineTest, SleepAndNestedCoroutines) {
+    auto child = [this](int v) -> tf::Co<int> {
+        co_await scheduler.sleep(5ms);
+        co_return v;
+    };
+    auto parent = [&]() -> tf::Co<int> {
+        int sum = 0;
+        for (int i = 1; i <= 3; ++i) sum += co_await child(i);
+        co_return sum;
+    };
+    auto t0 = tf::Clock::now();
+    EXPECT_EQ(scheduler.spawn(parent()).get(), 6);
+    EXPECT_GE(tf::Clock::now() - t0, 15ms);
+}
+
+TEST_F(CoroutineTest, DependentsWaitForTheWholeCoroutine) {
+    std::atomic<int> step{0};
+    auto co = [&]() -> tf::Co<> {
+        co_await scheduler.sleep(20ms);
+        step = 1;
+    };
+    auto h = scheduler.spawn(co());
+    auto after = scheduler.schedule_once(tf::Clock::now(), [&] { EXPECT_EQ(step.load(), 1); step = 2; }, {h});
+    scheduler.wait_for(after);
+    EXPECT_EQ(step.load(), 2);
+}
+
+TEST_F(CoroutineTest, ExceptionsPropagate) {
+    auto failing = [this]() -> tf::Co<int> {
+        co_await scheduler.sleep(1ms);
+        throw std::runtime_error("child failed");
+    };
+    auto caught = [&]() -> tf::Co<bool> {
+        try { co_await failing(); }
+        catch (const std::runtime_error&) { co_return true; }
+        co_return false;
+    };
+    EXPECT_TRUE(scheduler.spawn(caught()).get());
+    EXPECT_THROW(scheduler.spawn(failing()).get(), std::runtime_error);
+}
+
+// The body resumes in a task of its own after a sleep; the token it reads
+// there must still be the spawned task's.
+TEST_F(CoroutineTest, CancelReachesASuspendedCoroutine) {
+    std::atomic<bool> asleep{false}, requested{false};
+    auto co = [&]() -> tf::Co<int> {
+        asleep = true;
+        co_await scheduler.sleep(50ms);
+        auto token = tf::CancelToken::current();
+        requested = token.requested();
+        token.throw_if_requested();
+        co_return 1;
+    };
+    auto f = scheduler.spawn(co());
+    while (!asleep) std::this_thread::sleep_for(1ms);
+    EXPECT_TRUE(scheduler.cancel(f.handle()));
+    EXPECT_THROW(f.get(), tf::TaskCanceled);
+    EXPECT_TRUE(requested.load());
+    EXPECT_EQ(f.status(), tf::TaskStatus::canceled);
+}
+
+// Thousands of workflows sleeping at once on two threads: a blocking wait
+// per workflow would take 2000 * 20ms / 2.
+TEST_F(CoroutineTest, ManyWorkflowsShareFewThreads) {
+    constexpr int kFlows = 2000;
+    std::atomic<int> done{0};
+    auto flow = [&](int i) -> tf::Co<int> {
+        co_await scheduler.sleep(20ms);
+        auto inner = scheduler.schedule_once(tf::Clock::now(), [i] { return i; });
+        int v = co_await inner;
+        done.fetch_add(1);
+        co_return v;
+    };
+    auto t0 = tf::Clock::now();
+    std::vector<tf::TaskFuture<int>> fs;
+    for (int i = 0; i < kFlows; ++i) fs.push_back(scheduler.spawn(flow(i)));
+    long long sum = 0;
+    for (auto& f : fs) sum += f.get();
+    EXPECT_EQ(done.load(), kFlows);
+    EXPECT_EQ(sum, 1LL * kFlows * (kFlows - 1) / 2);
+    EXPECT_LT(tf::Clock::now() - t0, 2s);
+    fs.clear();
+    for (int i = 0; i < 200 && scheduler.task_count() != 0; ++i) std::this_thread::sleep_for(1ms);
+    EXPECT_EQ(scheduler.task_count(), 0u);
+}
+
+TEST(CoroutineShutdownTest, SuspendedCoroutinesAreFreed) {
+    auto alive = std::make_shared<int>(0);
+    {
+        tf::Scheduler s(1);
+        s.start();
+        auto co = [&s](std::shared_ptr<int> keep) -> tf::Co<> {
+            co_await s.sleep(1h);
+            ++*keep;
+        };
+        s.spawn(co(alive));
+        std::this_thread::sleep_for(10ms);
+        s.stop();
+    }
+    EXPECT_EQ(alive.use_count(), 1);
+}
@@ -0,0 +1,153 @@
+#include <taskflow/scheduler.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+// All expectations are in UTC so they do not depend on the host's zone.
+class CronTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        setenv("TZ", "UTC", 1);
+        tzset();
+    }
+
+    static std::chrono::system_clock::time_point at(int y, int mon, int d, int h = 0, int mi = 0, int s = 0) {
+        std::tm tm{};
+        tm.tm_year = y - 1900; tm.tm_mon = mon - 1; tm.tm_mday = d;
+        tm.tm_hour = h; tm.tm_min = mi; tm.tm_sec = s;
+        return std::chrono::system_clock::from_time_t(timegm(&tm));
+    }
+
+    static std::chrono::system_clock::time_point next(const std::string& expr,
+                                                      std::chrono::system_clock::time_point from) {
+        auto s = tf::parse_cron(expr);
+        EXPECT_TRUE(s.valid) << expr;
+        return tf::next_cron_time(s, from);
+    }
+};
+
+TEST_F(CronTest, ParsesFields) {
+    auto s = tf::parse_cron("0,30 9-17/4 * JAN-mar mon-FRI");
+    ASSERT_TRUE(s.valid);
+    EXPECT_EQ(s.seconds, 1u);
+    EXPECT_EQ(s.minutes, (1ull << 0) | (1ull << 30));
+    EXPECT_EQ(s.hours, (1u << 9) | (1u << 13) | (1u << 17));
+    EXPECT_EQ(s.months, (1u << 1) | (1u << 2) | (1u << 3));
+    EXPECT_EQ(s.days_of_week, 0b0111110);
+    EXPECT_FALSE(s.dom_restricted);
+    EXPECT_TRUE(s.dow_restricted);
+
+    EXPECT_EQ(tf::parse_cron("0 0 * * 7").days_of_week, 1u);
+    EXPECT_EQ(tf::parse_cron("0 5/20 * * * *").minutes, (1ull << 5) | (1ull << 25) | (1ull << 45));
+    EXPECT_TRUE(tf::parse_cron("  0   12  *  *  ?  ").valid);
+    EXPECT_FALSE(tf::parse_cron("0 9 ? * MON").dom_restricted);
+}
+
+TEST_F(CronTest, RejectsInvalid) {
+    for (const char* e : {"", "* * * *", "60 * * * *", "* 24 * * *", "* * 0 * *",
+                          "* * * 13 *", "* * * * 8", "*/0 * * * *", "5-1 * * * *",
+                          "* * * FOO *", "a b c d e", "1,,2 * * * *", "@never",
+                          "* * * * * * *", "1, * * * *", ",1 * * * *", "* * 1,2, * *",
+                          "? * * * *", "* ? * * *", "* * * ? *", "? * * * * *", "* * ?/2 * *",
+                          "* * 1,? * *"})
+        EXPECT_FALSE(tf::parse_cron(e).valid) << '"' << e << '"';
+}
+
+TEST_F(CronTest, Macros) {
+    EXPECT_EQ(next("@hourly", at(2024, 3, 10, 5, 17)), at(2024, 3, 10, 6, 0));
+    EXPECT_EQ(next("@daily", at(2024, 3, 10, 5, 17)), at(2024, 3, 11));
+    EXPECT_EQ(next("@weekly", at(2024, 3, 10, 5, 17)), at(2024, 3, 17));   // next Sunday
+    EXPECT_EQ(next("@monthly", at(2024, 12, 31, 23)), at(2025, 1, 1));
+    EXPECT_EQ(next("@yearly", at(2024, 1, 1)), at(2025, 1, 1));
+}
+
+TEST_F(CronTest, StrictlyAfterFrom) {
+    EXPECT_EQ(next("*/15 * * * *", at(2024, 1, 1, 0, 15)), at(2024, 1, 1, 0, 30));
+    EXPECT_EQ(next("*/15 * * * *", at(2024, 1, 1, 0, 14, 59)), at(2024, 1, 1, 0, 15));
+    EXPECT_EQ(next("* * * * *", at(2024, 1, 1, 23, 59)), at(2024, 1, 2));
+}
+
+TEST_F(CronTest, Seconds) {
+    EXPECT_EQ(next("*/10 * * * * *", at(2024, 1, 1, 0, 0, 7)), at(2024, 1, 1, 0, 0, 10));
+    EXPECT_EQ(next("30 0 12 * * *", at(2024, 1, 1, 12, 0, 30)), at(2024, 1, 2, 12, 0, 30));
+}
+
+TEST_F(CronTest, RollsOverFields) {
+    EXPECT_EQ(next("0 9 * * MON-FRI", at(2024, 3, 8, 10)), at(2024, 3, 11, 9));   // Fri -> Mon
+    EXPECT_EQ(next("0 0 31 * *", at(2024, 4, 1)), at(2024, 5, 31));            // April has 30
+    EXPECT_EQ(next("0 0 1 JAN *", at(2024, 6, 1)), at(2025, 1, 1));
+}
+
+TEST_F(CronTest, DayOfMonthOrDayOfWeek) {
+    // Both restricted: the 13th or any Friday.
+    auto s = "0 0 13 * FRI";
+    EXPECT_EQ(next(s, at(2024, 9, 1)), at(2024, 9, 6));    // Friday the 6th
+    EXPECT_EQ(next(s, at(2024, 9, 10)), at(2024, 9, 13));  // the 13th
+    // Only dow restricted: every Friday regardless of the 13th.
+    EXPECT_EQ(next("0 0 * * FRI", at(2024, 9, 10)), at(2024, 9, 13));
+    EXPECT_EQ(next("0 0 * * FRI", at(2024, 9, 11)), at(2024, 9, 13));
+    // A stepped star counts as unrestricted, so both fields must match:
+    // odd days that are Fridays, not odd days or Fridays.
+    EXPECT_FALSE(tf::parse_cron("0 0 */2 * FRI").dom_restricted);
+    EXPECT_EQ(next("0 0 */2 * FRI", at(2024, 9, 1)), at(2024, 9, 13));
+    EXPECT_EQ(next("0 0 */2 * FRI", at(2024, 9, 13)), at(2024, 9, 27));
+    // The 13th falling on Sun/Tue/Thu/Sat.
+    EXPECT_FALSE(tf::parse_cron("0 0 13 * */2").dow_restricted);
+    EXPECT_EQ(next("0 0 13 * */2", at(2024, 9, 1)), at(2024, 10, 13));
+}
+
+TEST_F(CronTest, LeapDay) {
+    EXPECT_EQ(next("0 0 29 2 *", at(2024, 3, 1)), at(2028, 2, 29));
+    EXPECT_EQ(next("0 0 29 2 *", at(2096, 3, 1)), at(2104, 2, 29));   // 2100 is not a leap year
+}
+
+TEST_F(CronTest, NeverFires) {
+    auto s = tf::parse_cron("0 0 30 2 *");
+    ASSERT_TRUE(s.valid);
+    EXPECT_EQ(tf::next_cron_time(s, at(2024, 1, 1)), std::chrono::system_clock::time_point::max());
+}
+
+TEST_F(CronTest, MatchesAndBulkAgree) {
+    std::vector<tf::CronSchedule> v{tf::parse_cron("*/7 3-5 * * *"), tf::parse_cron("0 0 L * *"),
+                                    tf::parse_cron("15 10 1,15 * 1")};
+    std::vector<std::chrono::system_clock::time_point> out;
+    auto from = at(2024, 2, 27, 4, 59);
+    tf::next_cron_times(v, from, out);
+    ASSERT_EQ(out.size(), 3u);
+    EXPECT_EQ(out[0], at(2024, 2, 27, 5, 0));
+    EXPECT_EQ(out[1], std::chrono::system_clock::time_point::max());   // `L` is unsupported
+    EXPECT_EQ(out[2], tf::next_cron_time(v[2], from));
+
+    std::time_t t = std::chrono::system_clock::to_time_t(out[2]);
+    std::tm tm;
+    gmtime_r(&t, &tm);
+    EXPECT_TRUE(tf::cron_matches(v[2], tm));
+    tm.tm_min += 1;
+    EXPECT_FALSE(tf::cron_matches(v[2], tm));
+}
+
+TEST_F(CronTest, DaylightSavingTransition) {
+    setenv("TZ", "America/New_York", 1);
+    tzset();
+    // 2024-03-10: clocks jump from 02:00 EST to 03:00 EDT. 09:00 local is
+    // 13:00 UTC after the jump; the skipped 02:30 fires an hour late rather
+    // than not at all.
+    EXPECT_EQ(next("0 9 * * *", at(2024, 3, 10, 5)), at(2024, 3, 10, 13));
+    EXPECT_EQ(next("30 2 * * *", at(2024, 3, 10, 5)), at(2024, 3, 10, 7, 30));
+    EXPECT_EQ(next("30 2 * * *", at(2024, 3, 10, 8)), at(2024, 3, 11, 6, 30));
+}
+
+TEST_F(CronTest, SchedulerReschedulesFromCron) {
+    std::atomic<int> runs{0};
+    tf::Scheduler s;
+    s.start();
+    auto h = s.schedule_recurring("* * * * * *", [&]{ ++runs; });
+    ASSERT_TRUE(h.is_valid());
+    s.wait_for(h);
+    s.wait_for(h);
+    s.stop();
+    EXPECT_GE(runs.load(), 2);
+    EXPECT_FALSE(s.schedule_recurring("not a cron", []{}).is_valid());
+}
@@ -1,6 +1,9 @@
 #include <taskflow/scheduler.hpp>
 #include <gtest/gtest.h>
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <string>
 
@@ -50,7 +53,7 @@ TEST_F(DAGTest, ChainedDependencies) {
 
     scheduler->wait_for(t3);
     
-    ASSERT_EQ(execution_order.size(), 3);
+    ASSERT_EQ(execution_order.size(), 3u);
     EXPECT_EQ(execution_order[0], 1);
     EXPECT_EQ(execution_order[1], 2);
     EXPECT_EQ(execution_order[2], 3);
@@ -98,4 +101,334 @@ TEST_F(DAGTest, RecurringTasks) {
     // Allow some variance for CI timing but not exponential growth
     EXPECT_GE(counter.load(), 2); // Should have run at least 2 times
     EXPECT_LE(counter.load(), 6); // But not more than 6 times (with timing variance)
-}
\ No newline at end of file
+}
+
+TEST_F(DAGTest, TimersFireInDeadlineOrder) {
+    std::vector<int> execution_order;
+    std::mutex order_mtx;
+
+    auto add_to_order = [&](int id) {
+        std::lock_guard<std::mutex> lk(order_mtx);
+        execution_order.push_back(id);
+    };
+
+    // Submitted latest-first; the earlier deadline must wake the dispatcher early.
+    auto now = tf::Clock::now();
+    auto t3 = scheduler->schedule_once(now + 60ms, [&]{ add_to_order(3); });
+    auto t2 = scheduler->schedule_once(now + 40ms, [&]{ add_to_order(2); });
+    auto t1 = scheduler->schedule_once(now + 20ms, [&]{ add_to_order(1); });
+
+    for (auto t : {t1, t2, t3}) scheduler->wait_for(t);
+    
+    ASSERT_EQ(execution_order.size(), 3u);
+    EXPECT_EQ(execution_order[0], 1);
+    EXPECT_EQ(execution_order[1], 2);
+    EXPECT_EQ(execution_order[2], 3);
+}
+
+TEST_F(DAGTest, DispatchLatency) {
+    std::atomic<tf::TimePoint::rep> started{0};
+    auto deadline = tf::Clock::now() + 20ms;
+
+    auto t = scheduler->schedule_once(deadline, [&]{
+        started = tf::Clock::now().time_since_epoch().count();
+    });
+
+    scheduler->wait_for(t);
+    auto late = tf::TimePoint(tf::Duration(started.load())) - deadline;
+    EXPECT_GE(late.count(), 0);
+    EXPECT_LT(late, 5ms); // no polling interval to wait out
+}
+
+TEST_F(DAGTest, DeepChainReleasesDependents) {
+    std::atomic<int> counter{0};
+    auto begin = tf::Clock::now();
+
+    tf::TaskHandle prev{};
+    for (int i = 0; i < 1000; ++i) {
+        std::vector<tf::TaskHandle> deps;
+        if (prev.is_valid()) deps.push_back(prev);
+        prev = scheduler->schedule_once(tf::Clock::now(), [&, i]{
+            EXPECT_EQ(counter.load(), i);
+            counter++;
+        }, deps);
+    }
+
+    scheduler->wait_for(prev);
+    EXPECT_EQ(counter.load(), 1000);
+    EXPECT_LT(tf::Clock::now() - begin, 1s); // dependents never wait for a poll
+}
+
+TEST_F(DAGTest, FinishedTasksAreReclaimed) {
+    auto drain = [&] {
+        for (int i = 0; i < 200 && scheduler->task_count() != 0; ++i)
+            std::this_thread::sleep_for(1ms);
+    };
+
+    std::atomic<int> counter{0};
+    std::vector<tf::TaskHandle> first;
+    for (int i = 0; i < 1000; ++i)
+        first.push_back(scheduler->schedule_once(tf::Clock::now(), [&]{ counter++; }));
+    for (auto h : first) scheduler->wait_for(h);
+    drain();
+    EXPECT_EQ(scheduler->task_count(), 0u);
+
+    // Slots are recycled under a new generation; old handles are stale and
+    // count as finished.
+    auto fresh = scheduler->schedule_once(tf::Clock::now() + 50ms, [&]{ counter++; }, {first[0]});
+    EXPECT_LT(fresh.slot(), 1000u);
+    for (auto h : first) EXPECT_FALSE(h == fresh);
+    scheduler->wait_for(first[0]); // returns immediately
+    scheduler->wait_for(fresh);
+    EXPECT_EQ(counter.load(), 1001);
+
+    drain();
+    EXPECT_EQ(scheduler->task_count(), 0u);
+}
+
+TEST_F(DAGTest, ConcurrentProducers) {
+    constexpr int kProducers = 8, kPerProducer = 2000;
+    std::atomic<int> ran{0};
+    std::atomic<bool> order_ok{true};
+    auto root = scheduler->schedule_once(tf::Clock::now() + 20ms, [&]{ ran++; });
+    std::vector<tf::TaskHandle> tails(kProducers);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p] {
+            // Each producer builds its own chain, rooted on a shared task
+            // submitted by another thread.
+            auto step = std::make_shared<std::atomic<int>>(0);
+            tf::TaskHandle prev = root;
+            for (int i = 0; i < kPerProducer; ++i) {
+                prev = scheduler->schedule_once(tf::Clock::now(), [&, step, i] {
+                    if (step->exchange(i + 1) != i) order_ok = false;
+                    ran++;
+                }, {prev});
+            }
+            tails[p] = prev;
+        });
+    }
+    for (auto& t : producers) t.join();
+    for (auto h : tails) scheduler->wait_for(h);
+    EXPECT_EQ(ran.load(), 1 + kProducers * kPerProducer);
+    EXPECT_TRUE(order_ok.load());
+    for (int i = 0; i < 200 && scheduler->task_count() != 0; ++i)
+        std::this_thread::sleep_for(1ms);
+    EXPECT_EQ(scheduler->task_count(), 0u);
+}
+
+TEST_F(DAGTest, TypedResults) {
+    auto a = scheduler->schedule_once(tf::Clock::now(), []{ return 20; });
+    auto b = scheduler->schedule_once(tf::Clock::now(), []{ return std::string(100, 'x'); }); // boxed
+    static_assert(std::is_same_v<decltype(a), tf::TaskFuture<int>>);
+
+    auto sum = scheduler->then([](const int& x, const std::string& s) {
+        return x + static_cast<int>(s.size());
+    }, a, b);
+    EXPECT_EQ(sum.get(), 120);
+    EXPECT_EQ(a.get(), 20);
+    EXPECT_EQ(scheduler->get_result<int>(sum), 120);
+    EXPECT_THROW(scheduler->get_result<double>(sum), std::logic_error);
+}
+
+TEST_F(DAGTest, ResultExceptionsPropagateDownstream) {
+    auto bad = scheduler->schedule_once(tf::Clock::now(), []() -> int {
+        throw std::runtime_error("upstream failed");
+    });
+    auto next = scheduler->then([](const int& x) { return x + 1; }, bad);
+    EXPECT_THROW(next.get(), std::runtime_error);
+    EXPECT_THROW(bad.get(), std::runtime_error);
+}
+
+TEST_F(DAGTest, FutureKeepsSlotUntilReleased) {
+    {
+        auto f = scheduler->schedule_once(tf::Clock::now(), []{ return 7; });
+        f.wait();
+        std::this_thread::sleep_for(10ms);
+        EXPECT_EQ(scheduler->task_count(), 1u); // pinned by f
+        EXPECT_EQ(f.get(), 7);
+    }
+    EXPECT_EQ(scheduler->task_count(), 0u);
+}
+
+TEST_F(DAGTest, CancelPrunesDownstreamCone) {
+    std::atomic<int> ran{0};
+    auto root = scheduler->schedule_once(tf::Clock::now() + 1h, [&] { ++ran; return 1; });
+    auto mid = scheduler->then([&](const int& x) { ++ran; return x + 1; }, root);
+    auto leaf = scheduler->then([&](const int& x) { ++ran; return x + 1; }, mid);
+    std::atomic<bool> cleaned{false};
+    tf::TaskOptions always;
+    always.always_run = true;
+    auto cleanup = scheduler->schedule_once(tf::Clock::now(), [&] { cleaned = true; }, {mid}, always);
+
+    EXPECT_TRUE(scheduler->cancel(root));
+    EXPECT_FALSE(scheduler->cancel(root));
+    EXPECT_EQ(root.status(), tf::TaskStatus::canceled);   // waiters complete without the hour
+    mid.wait();
+    EXPECT_EQ(mid.status(), tf::TaskStatus::canceled);
+    EXPECT_THROW(leaf.get(), tf::TaskCanceled);
+    scheduler->wait_for(cleanup);
+    EXPECT_TRUE(cleaned.load());
+    EXPECT_EQ(ran.load(), 0);
+}
+
+TEST_F(DAGTest, FailurePrunesDependents) {
+    std::atomic<int> ran{0};
+    auto bad = scheduler->schedule_once(tf::Clock::now(), [] { throw std::runtime_error("extract failed"); });
+    auto load = scheduler->schedule_once(tf::Clock::now(), [&] { ++ran; }, {bad});
+    auto report = scheduler->schedule_once(tf::Clock::now(), [&] { ++ran; return 0; }, {load});
+    EXPECT_THROW(report.get(), std::runtime_error);   // the upstream's exception
+    EXPECT_EQ(report.status(), tf::TaskStatus::failed);
+    EXPECT_EQ(ran.load(), 0);
+}
+
+TEST_F(DAGTest, DependentOfFinishedFailureIsPruned) {
+    auto bad = scheduler->schedule_once(tf::Clock::now(), [] { throw std::runtime_error("extract failed"); return 1; });
+    bad.wait();   // finished, and kept in its slot by the future
+    std::atomic<bool> ran{false};
+    auto late = scheduler->then([&](const int& x) { ran = true; return x; }, bad);
+    EXPECT_THROW(late.get(), std::runtime_error);
+    EXPECT_EQ(late.status(), tf::TaskStatus::failed);
+    EXPECT_FALSE(ran.load());
+}
+
+TEST_F(DAGTest, TimeoutPrunesWaitingTask) {
+    std::atomic<bool> open{false};
+    auto gate = scheduler->schedule_once(tf::Clock::now(), [&] { while (!open) std::this_thread::sleep_for(1ms); });
+    tf::TaskOptions opts;
+    opts.timeout = 20ms;
+    auto late = scheduler->schedule_once(tf::Clock::now(), [] { return 1; }, {gate}, opts);
+    auto after = scheduler->then([](const int& x) { return x; }, late);
+    EXPECT_THROW(after.get(), tf::TaskCanceled);   // while gate is still running
+    EXPECT_EQ(late.status(), tf::TaskStatus::timed_out);
+    EXPECT_EQ(after.status(), tf::TaskStatus::timed_out);
+    open = true;
+    scheduler->wait_for(gate);
+}
+
+TEST_F(DAGTest, RunningTaskStopsThroughToken) {
+    std::atomic<bool> started{false};
+    auto job = scheduler->schedule_once(tf::Clock::now(), [&] {
+        auto token = tf::CancelToken::current();
+        started = true;
+        for (auto until = tf::Clock::now() + 5s; tf::Clock::now() < until;) {
+            token.throw_if_requested();
+            std::this_thread::sleep_for(1ms);
+        }
+        return 1;
+    });
+    auto next = scheduler->then([](const int& x) { return x; }, job);
+    while (!started) std::this_thread::sleep_for(1ms);
+    EXPECT_TRUE(scheduler->cancel(job));
+    EXPECT_THROW(job.get(), tf::TaskCanceled);
+    EXPECT_EQ(job.status(), tf::TaskStatus::canceled);
+    next.wait();
+    EXPECT_EQ(next.status(), tf::TaskStatus::canceled);
+}
+
+TEST_F(DAGTest, CanceledRecurringTaskStops) {
+    std::atomic<int> runs{0};
+    auto h = scheduler->schedule_every(5ms, [&] { ++runs; });
+    while (runs < 2) std::this_thread::sleep_for(1ms);
+    EXPECT_TRUE(scheduler->cancel(h));
+    std::this_thread::sleep_for(30ms);
+    int seen = runs;
+    std::this_thread::sleep_for(30ms);
+    EXPECT_EQ(runs.load(), seen);
+    EXPECT_EQ(scheduler->task_count(), 0u);
+}
+
+TEST(SchedulerPriorityTest, HighPriorityOvertakesBacklog) {
+    tf::Scheduler s(1);
+    s.start();
+    std::atomic<bool> started{false}, open{false};
+    s.schedule_once(tf::Clock::now(), [&] {
+        started = true;
+        while (!open) std::this_thread::yield();
+    });
+    while (!started) std::this_thread::yield();
+
+    std::mutex mtx;
+    std::vector<char> order;
+    auto rec = [&](char c) { return [&, c] { std::lock_guard<std::mutex> lk(mtx); order.push_back(c); }; };
+    auto opts = [](tf::Priority p, tf::Duration deadline = tf::Duration::max()) {
+        tf::TaskOptions o;
+        o.priority = p;
+        o.deadline = deadline;
+        return o;
+    };
+    for (int i = 0; i < 50; ++i) s.schedule_once(tf::Clock::now(), rec('L'), {}, opts(tf::Priority::low));
+    for (int i = 0; i < 50; ++i) s.schedule_once(tf::Clock::now(), rec('N'));
+    s.schedule_once(tf::Clock::now(), rec('b'), {}, opts(tf::Priority::high, 2s));
+    auto last = s.schedule_once(tf::Clock::now(), rec('a'), {}, opts(tf::Priority::high, 1s));
+    std::this_thread::sleep_for(20ms);   // let the dispatcher hand everything to the pool
+    open = true;
+    s.wait_for(last);
+    while (s.task_count() != 0) std::this_thread::sleep_for(1ms);
+    s.stop();
+
+    ASSERT_EQ(order.size(), 102u);
+    EXPECT_EQ(order[0], 'a');
+    EXPECT_EQ(order[1], 'b');
+    for (size_t i = 2; i < 52; ++i) EXPECT_EQ(order[i], 'N') << i;
+    for (size_t i = 52; i < 102; ++i) EXPECT_EQ(order[i], 'L') << i;
+}
+namespace {
+// Five one-node leaves ahead of a three-node chain in index order, on one
+// worker; returns the names in the order they ran.
+std::vector<std::string> run_leaves_and_chain(tf::Scheduler& s) {
+    std::mutex mtx;
+    std::vector<std::string> order;
+    auto rec = [&](std::string name) {
+        return [&, name] { std::lock_guard<std::mutex> lk(mtx); order.push_back(name); };
+    };
+    tf::TaskGraph g;
+    for (int i = 0; i < 5; ++i) g.add("leaf" + std::to_string(i), rec("leaf" + std::to_string(i)));
+    auto c0 = g.add("c0", rec("c0"));
+    auto c1 = g.add("c1", rec("c1"));
+    auto c2 = g.add("c2", rec("c2"));
+    g.precede(c0, c1);
+    g.precede(c1, c2);
+    auto hs = s.submit(std::move(g));
+    for (auto h : hs) s.wait_for(h);
+    return order;
+}
+}  // namespace
+
+TEST(CriticalPathTest, LongestPathStartsFirst) {
+    tf::Scheduler s(1);
+    s.start();
+    // No history yet: ranked by path length, so the chain goes first.
+    auto order = run_leaves_and_chain(s);
+    ASSERT_EQ(order.size(), 8u);
+    EXPECT_EQ(order[0], "c0");
+    EXPECT_EQ(order[1], "c1");
+
+    // One leaf known to cost more than the whole chain overtakes it.
+    for (const char* c : {"c0", "c1", "c2"}) s.set_cost_estimate(c, 1ms);
+    for (int i = 0; i < 5; ++i) s.set_cost_estimate("leaf" + std::to_string(i), i == 3 ? 10ms : 1ms);
+    order = run_leaves_and_chain(s);
+    EXPECT_EQ(order[0], "leaf3");
+    EXPECT_EQ(order[1], "c0");
+
+    s.set_critical_path(false);
+    order = run_leaves_and_chain(s);
+    EXPECT_EQ(order[0], "leaf0");
+    s.stop();
+}
+
+TEST(CriticalPathTest, LearnsCostPerName) {
+    tf::Scheduler s(2);
+    s.start();
+    EXPECT_EQ(s.cost_estimate("slow"), tf::Duration::zero());
+    for (int run = 0; run < 3; ++run) {
+        tf::TaskGraph g;
+        auto a = g.add("slow", [] { std::this_thread::sleep_for(5ms); });
+        auto b = g.add("fast", [] {});
+        g.precede(a, b);
+        s.wait_for(s.submit(std::move(g))[b]);
+    }
+    EXPECT_GE(s.cost_estimate("slow"), 4ms);
+    EXPECT_LT(s.cost_estimate("fast"), 4ms);
+    s.stop();
+}
@@ -0,0 +1,159 @@
+#include <taskflow/scheduler.hpp>
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <fcntl.h>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+// Scratch file, removed on destruction.
+struct TempFile {
+    TempFile() {
+        char path[] = "/tmp/taskflow_io_XXXXXX";
+        fd = ::mkstemp(path);
+        name = path;
+    }
+    ~TempFile() {
+        ::close(fd);
+        ::unlink(name.c_str());
+    }
+    int fd;
+    std::string name;
+};
+
+std::vector<std::byte> pattern(size_t n, unsigned seed) {
+    std::vector<std::byte> v(n);
+    for (size_t i = 0; i < n; ++i) v[i] = static_cast<std::byte>((i * 131 + seed) & 0xff);
+    return v;
+}
+}  // namespace
+
+// Every test runs against both backends; io_uring falls back to threads
+// where the kernel refuses a ring.
+class IoTest : public ::testing::TestWithParam<tf::IoBackend> {
+protected:
+    void SetUp() override { scheduler.start(); }
+    void TearDown() override { scheduler.stop(); }
+
+    tf::Scheduler scheduler{2};
+};
+
+TEST_P(IoTest, WriteSyncReadAsDag) {
+    tf::IoExecutor io(scheduler, GetParam());
+    TempFile file;
+    auto data = pattern(1 << 20, 7);
+    std::vector<std::byte> back(data.size());
+
+    auto w = io.write(file.fd, data, 0);
+    auto sync = io.fsync(file.fd, {w.handle()});
+    auto r = io.read(file.fd, back, 0, {sync.handle()});
+    auto check = scheduler.schedule_once(tf::Clock::now(), [&] { return back == data; }, {r.handle()});
+
+    EXPECT_EQ(w.get(), data.size());
+    sync.get();
+    EXPECT_EQ(r.get(), data.size());
+    EXPECT_TRUE(check.get());
+}
+
+TEST_P(IoTest, CoroutineCopiesInChunks) {
+    tf::IoExecutor io(scheduler, GetParam());
+    TempFile src, dst;
+    auto data = pattern(300'000, 3);
+    ASSERT_EQ(::pwrite(src.fd, data.data(), data.size(), 0), static_cast<ssize_t>(data.size()));
+
+    auto copy = [&]() -> tf::Co<size_t> {
+        std::vector<std::byte> buf(64 * 1024);
+        uint64_t off = 0;
+        while (true) {
+            size_t n = co_await io.async_read(src.fd, buf, off);   // short at end of file
+            if (n == 0) break;
+            for (size_t i = 0; i < n; ++i) buf[i] = ~buf[i];
+            co_await io.async_write(dst.fd, std::span(buf).first(n), off);
+            off += n;
+        }
+        co_await io.async_fsync(dst.fd);
+        co_return off;
+    };
+    EXPECT_EQ(scheduler.spawn(copy()).get(), data.size());
+
+    std::vector<std::byte> out(data.size());
+    ASSERT_EQ(::pread(dst.fd, out.data(), out.size(), 0), static_cast<ssize_t>(out.size()));
+    for (size_t i = 0; i < data.size(); ++i) ASSERT_EQ(out[i], ~data[i]) << "at " << i;
+}
+
+TEST_P(IoTest, MoreRequestsThanQueueDepth) {
+    tf::IoExecutor io(scheduler, GetParam(), 4, 2);
+    TempFile file;
+    constexpr size_t kBlocks = 500, kBlock = 512;
+    auto data = pattern(kBlocks * kBlock, 11);
+    ASSERT_EQ(::pwrite(file.fd, data.data(), data.size(), 0), static_cast<ssize_t>(data.size()));
+
+    std::vector<std::byte> back(data.size());
+    std::vector<tf::TaskFuture<size_t>> reads;
+    for (size_t b = 0; b < kBlocks; ++b)
+        reads.push_back(io.read(file.fd, std::span(back).subspan(b * kBlock, kBlock), b * kBlock));
+    size_t total = 0;
+    for (auto& r : reads) total += r.get();
+    EXPECT_EQ(total, data.size());
+    EXPECT_EQ(back, data);
+}
+
+TEST_P(IoTest, ErrorsBecomeSystemErrors) {
+    tf::IoExecutor io(scheduler, GetParam());
+    std::byte buf[16];
+    auto r = io.read(-1, buf, 0);
+    try {
+        r.get();
+        FAIL() << "expected std::system_error";
+    } catch (const std::system_error& e) {
+        EXPECT_EQ(e.code().value(), EBADF);
+    }
+    // Dependents of a failed request fail with its error; always_run ones still run.
+    auto after = scheduler.schedule_once(tf::Clock::now(), [] { return 1; }, {r.handle()});
+    EXPECT_THROW(after.get(), std::system_error);
+    tf::TaskOptions cleanup;
+    cleanup.always_run = true;
+    auto anyway = scheduler.schedule_once(tf::Clock::now(), [] { return 1; }, {r.handle()}, cleanup);
+    EXPECT_EQ(anyway.get(), 1);
+    EXPECT_THROW(io.fsync(-1).get(), std::system_error);
+
+    auto co = [&]() -> tf::Co<int> {
+        try {
+            co_await io.async_read(-1, buf, 0);
+        } catch (const std::system_error& e) {
+            co_return e.code().value();
+        }
+        co_return 0;
+    };
+    EXPECT_EQ(scheduler.spawn(co()).get(), EBADF);
+}
+
+TEST_P(IoTest, TaskRequestsAwaitableToo) {
+    tf::IoExecutor io(scheduler, GetParam());
+    TempFile file;
+    auto data = pattern(4096, 5);
+    auto co = [&]() -> tf::Co<bool> {
+        size_t n = co_await io.write(file.fd, data, 0);
+        std::vector<std::byte> back(n);
+        co_await io.read(file.fd, back, 0);
+        co_return back == data;
+    };
+    EXPECT_TRUE(scheduler.spawn(co()).get());
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, IoTest,
+                         ::testing::Values(tf::IoBackend::io_uring, tf::IoBackend::threads),
+                         [](const auto& info) {
+                             return info.param == tf::IoBackend::io_uring ? "io_uring" : "threads";
+                         });
+
+TEST(IoExecutorTest, ReportsBackend) {
+    tf::Scheduler s(1);
+    tf::IoExecutor threads(s, tf::IoBackend::threads);
+    EXPECT_EQ(threads.backend(), tf::IoBackend::threads);
+    tf::IoExecutor ring(s);   // io_uring unless the kernel says no
+    EXPECT_TRUE(ring.backend() == tf::IoBackend::io_uring || ring.backend() == tf::IoBackend::threads);
+}
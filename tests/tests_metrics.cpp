@@ -0,0 +1,92 @@
+#include <taskflow/scheduler.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+#include <string>
+
+using namespace std::chrono_literals;
+
+class MetricsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scheduler = std::make_unique<tf::Scheduler>(2);
+        scheduler->start();
+    }
+    void TearDown() override { scheduler->stop(); }
+
+    std::unique_ptr<tf::Scheduler> scheduler;
+};
+
+TEST(LatencyHistogramTest, Percentiles) {
+    tf::LatencyHistogram h;
+    EXPECT_EQ(h.percentile(0.5), 0u);
+    h.counts[tf::LatencyHistogram::bucket(100)] += 90;      // [64, 128)
+    h.counts[tf::LatencyHistogram::bucket(5000)] += 10;     // [4096, 8192)
+    EXPECT_EQ(h.count(), 100u);
+    EXPECT_EQ(h.percentile(0.5), 127u);
+    EXPECT_EQ(h.percentile(0.99), 8191u);
+    EXPECT_EQ(tf::LatencyHistogram::bucket(0), 0);
+    EXPECT_EQ(tf::LatencyHistogram::bucket(1), 0);
+}
+
+TEST_F(MetricsTest, SnapshotCountsTasks) {
+    std::vector<tf::TaskHandle> hs;
+    for (int i = 0; i < 50; ++i) hs.push_back(scheduler->schedule_once(tf::Clock::now(), []{}));
+    auto last = scheduler->schedule_once(tf::Clock::now() + 5ms, []{ std::this_thread::sleep_for(1ms); }, hs);
+    scheduler->wait_for(last);
+
+    // Run stats land just after the task body returns, so give the last one a
+    // moment. (Without instrumentation finished stays 0 and this returns at once.)
+    auto m = scheduler->metrics();
+    for (int i = 0; i < 100 && m.enabled && m.finished < 51; ++i) {
+        std::this_thread::sleep_for(1ms);
+        m = scheduler->metrics();
+    }
+    EXPECT_EQ(m.workers.size(), 2u);
+    EXPECT_GT(m.uptime_seconds, 0.0);
+#if TASKFLOW_INSTRUMENTATION
+    EXPECT_TRUE(m.enabled);
+    EXPECT_EQ(m.submitted, 51u);
+    EXPECT_EQ(m.finished, 51u);
+    EXPECT_EQ(m.run_time.count(), 51u);
+    EXPECT_GE(m.run_time.percentile(1.0), 1000000u);   // the 1ms task
+    uint64_t jobs = 0;
+    for (auto& w : m.workers) jobs += w.jobs;
+    EXPECT_GT(jobs, 0u);
+    EXPECT_GT(m.throughput, 0.0);
+#else
+    EXPECT_FALSE(m.enabled);
+    EXPECT_EQ(m.finished, 0u);
+    EXPECT_EQ(m.run_time.count(), 0u);
+#endif
+}
+
+TEST_F(MetricsTest, ChromeTrace) {
+    scheduler->start_trace(128);
+    tf::TaskGraph g;
+    g.add("load \"raw\"", []{});
+    g.add("parse", []{});
+    g.precede("load \"raw\"", "parse");
+    auto hs = scheduler->submit(std::move(g));
+    scheduler->wait_for(hs[1]);
+    for (int i = 0; i < 100; ++i) {   // see SnapshotCountsTasks
+        auto m = scheduler->metrics();
+        if (!m.enabled || m.finished >= 2) break;
+        std::this_thread::sleep_for(1ms);
+    }
+    scheduler->stop_trace();
+
+    std::ostringstream os;
+    scheduler->write_trace(os);
+    std::string json = os.str();
+    EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"displayTimeUnit\""), std::string::npos);
+#if TASKFLOW_INSTRUMENTATION
+    EXPECT_NE(json.find("\"name\":\"load \\\"raw\\\"\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"parse\""), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"s\""), std::string::npos);   // flow from load to parse
+    EXPECT_NE(json.find("\"ph\":\"f\""), std::string::npos);
+#else
+    EXPECT_EQ(json.find("\"ph\":\"X\""), std::string::npos);
+#endif
+}
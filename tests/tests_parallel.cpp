@@ -0,0 +1,91 @@
+#include <taskflow/scheduler.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+TEST(ParallelTest, ForVisitsEveryIndexOnce) {
+    tf::ThreadPool pool(4);
+    std::vector<int> hits(1'000'003, 0);
+    tf::parallel_for(pool, size_t{0}, hits.size(), [&](size_t i) { ++hits[i]; });
+    EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), static_cast<long>(hits.size()));
+
+    // Elements, small ranges, empty ranges, explicit grain.
+    std::vector<int> v(37, 1);
+    tf::parallel_for(pool, v.begin(), v.end(), [](int& x) { x *= 3; }, 4);
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0), 111);
+    tf::parallel_for(pool, 5, 5, [](int) { FAIL(); });
+}
+
+TEST(ParallelTest, ReduceMatchesSerialAndKeepsOrder) {
+    tf::ThreadPool pool(4);
+    std::vector<long long> v(10'000'000);
+    std::iota(v.begin(), v.end(), 1);
+    EXPECT_EQ(tf::parallel_reduce(pool, v.begin(), v.end(), 100LL, std::plus<>{}),
+              100 + 10'000'000LL * 10'000'001 / 2);
+
+    // Associative but not commutative: pieces must be joined left to right.
+    std::vector<std::string> words;
+    for (int i = 0; i < 5000; ++i) words.push_back(std::to_string(i % 10));
+    std::string serial = std::accumulate(words.begin(), words.end(), std::string(">"));
+    EXPECT_EQ(tf::parallel_reduce(pool, words.begin(), words.end(), std::string(">"), std::plus<>{}, 16),
+              serial);
+}
+
+TEST(ParallelTest, BodyExceptionsAreRethrown) {
+    tf::ThreadPool pool(4);
+    std::atomic<int> ran{0};
+    EXPECT_THROW(tf::parallel_for(pool, 0, 100000, [&](int i) {
+        ran++;
+        if (i == 5000) throw std::runtime_error("bad record");
+    }), std::runtime_error);
+    EXPECT_LE(ran.load(), 100000);
+}
+
+TEST(ParallelTest, ShutDownPoolRunsOnCaller) {
+    tf::ThreadPool pool(2);
+    pool.shutdown();
+    std::vector<int> v(10'000, 1);
+    tf::parallel_for(pool, v.begin(), v.end(), [](int& x) { x *= 2; }, 64);
+    EXPECT_EQ(tf::parallel_reduce(pool, v.begin(), v.end(), 0, std::plus<>{}, 64), 20'000);
+}
+
+TEST(ParallelTest, StagesAsDagNodes) {
+    tf::Scheduler s(4);
+    s.start();
+    std::vector<int> data(1 << 20);   // stages capture iterators: size it up front
+    auto load = s.schedule_once(tf::Clock::now() + 5ms, [&] { std::fill(data.begin(), data.end(), 2); });
+    auto scale = s.parallel_for(data.begin(), data.end(), [](int& x) { x *= 5; }, {load});
+    auto total = s.parallel_reduce(data.begin(), data.end(), 0LL, std::plus<>{}, {scale});
+    // Map-and-join form inside an ordinary task: runs on the pool too.
+    auto evens = s.schedule_once(tf::Clock::now(), [&] {
+        return tf::parallel_reduce(size_t{0}, data.size(), 0LL,
+            [&](long long acc, size_t i) { return acc + (i % 2 == 0 ? data[i] : 0); },
+            std::plus<>{});
+    }, {scale});
+    EXPECT_EQ(total.get(), 10LL << 20);
+    EXPECT_EQ(evens.get(), 5LL << 20);
+    s.stop();
+}
+
+TEST(ParallelTest, NestedInsideTaskGraph) {
+    tf::Scheduler s(4);
+    s.start();
+    std::vector<std::atomic<int>> cells(4096);
+    tf::TaskGraph g;
+    auto a = g.add([&] { tf::parallel_for(cells, [](std::atomic<int>& c) { c += 1; }); });
+    auto b = g.add([&] {
+        tf::parallel_for(size_t{0}, cells.size(), [&](size_t i) { cells[i] += static_cast<int>(i); });
+    });
+    g.precede(a, b);
+    auto hs = s.submit(std::move(g));
+    s.wait_for(hs[b]);
+    for (size_t i = 0; i < cells.size(); ++i) EXPECT_EQ(cells[i].load(), 1 + static_cast<int>(i));
+    s.stop();
+}
@@ -0,0 +1,130 @@
+#include <taskflow/scheduler.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+// Source yielding 0, 1, ..., n - 1.
+auto counter(int n) {
+    return [i = 0, n]() mutable -> std::optional<int> {
+        if (i == n) return std::nullopt;
+        return i++;
+    };
+}
+}  // namespace
+
+TEST(PipelineTest, InOrderSinkAfterParallelStage) {
+    tf::Scheduler s(4);
+    s.start();
+    std::vector<std::string> out;
+    auto p = tf::make_pipeline(8, counter(2000),
+        tf::stage(tf::StageMode::parallel, [](int x) {
+            if (x % 7 == 0) std::this_thread::sleep_for(50us);   // scramble completion order
+            return x * 2;
+        }),
+        tf::stage(tf::StageMode::parallel, [](int x) { return std::to_string(x); }),
+        tf::stage(tf::StageMode::serial_in_order, [&](std::string v) { out.push_back(std::move(v)); }));
+    EXPECT_EQ(p.stage_count(), 4u);
+    s.submit(std::move(p)).get();
+    ASSERT_EQ(out.size(), 2000u);
+    for (int i = 0; i < 2000; ++i) EXPECT_EQ(out[i], std::to_string(i * 2));
+    s.stop();
+}
+
+TEST(PipelineTest, OutOfOrderStageSeesEveryItem) {
+    tf::Scheduler s(4);
+    s.start();
+    std::vector<int> seen;
+    auto f = s.submit(tf::make_pipeline(16, counter(5000),
+        tf::stage(tf::StageMode::parallel, [](int x) { return x + 1; }),
+        tf::stage(tf::StageMode::serial_out_of_order, [&](int x) { seen.push_back(x); })));
+    f.get();
+    std::sort(seen.begin(), seen.end());
+    ASSERT_EQ(seen.size(), 5000u);
+    for (int i = 0; i < 5000; ++i) EXPECT_EQ(seen[i], i + 1);
+    s.stop();
+}
+
+TEST(PipelineTest, SlowSinkBoundsLiveItems) {
+    tf::Scheduler s(4);
+    s.start();
+    std::atomic<int> live{0}, peak{0};
+    int last = -1;
+    bool ordered = true;
+    auto p = tf::make_pipeline(4,
+        [&, i = 0]() mutable -> std::optional<int> {
+            if (i == 200) return std::nullopt;
+            int now = ++live;
+            int top = peak.load();
+            while (now > top && !peak.compare_exchange_weak(top, now)) {}
+            return i++;
+        },
+        tf::stage(tf::StageMode::parallel, [](int x) { return x; }),
+        tf::stage(tf::StageMode::serial_in_order, [&](int x) {
+            std::this_thread::sleep_for(100us);
+            ordered = ordered && x == last + 1;
+            last = x;
+            --live;
+        }));
+    s.submit(std::move(p)).get();
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(last, 199);
+    EXPECT_GE(peak.load(), 1);
+    EXPECT_LE(peak.load(), 4);
+    s.stop();
+}
+
+TEST(PipelineTest, StageExceptionStopsPipeline) {
+    tf::Scheduler s(4);
+    s.start();
+    std::atomic<int> produced{0}, sunk{0};
+    auto p = tf::make_pipeline(8,
+        [&, i = 0]() mutable -> std::optional<int> {
+            if (i == 1'000'000) return std::nullopt;
+            produced++;
+            return i++;
+        },
+        tf::stage(tf::StageMode::parallel, [](int x) {
+            if (x == 100) throw std::runtime_error("bad record");
+            return x;
+        }),
+        tf::stage(tf::StageMode::serial_in_order, [&](int) { sunk++; }));
+    auto f = s.submit(std::move(p));
+    EXPECT_THROW(f.get(), std::runtime_error);
+    EXPECT_LT(produced.load(), 1'000'000);
+    EXPECT_LE(sunk.load(), 100);
+
+    // A throwing source stops it the same way; an empty one just finishes.
+    auto g = s.submit(tf::make_pipeline(2, []() -> std::optional<int> { throw std::logic_error("no input"); },
+                                        tf::stage(tf::StageMode::parallel, [](int) {})));
+    EXPECT_THROW(g.get(), std::logic_error);
+    s.submit(tf::make_pipeline(2, counter(0), tf::stage(tf::StageMode::serial_in_order, [](int) { FAIL(); }))).get();
+    s.stop();
+}
+
+TEST(PipelineTest, RunsAsDagNode) {
+    tf::Scheduler s(4);
+    s.start();
+    std::vector<int> input;
+    long long total = 0;
+    auto load = s.schedule_once(tf::Clock::now() + 5ms, [&] {
+        for (int i = 1; i <= 1000; ++i) input.push_back(i);
+    });
+    auto stream = s.submit(tf::make_pipeline(8,
+        [&, i = size_t{0}]() mutable -> std::optional<int> {
+            if (i == input.size()) return std::nullopt;
+            return input[i++];
+        },
+        tf::stage(tf::StageMode::parallel, [](int x) { return static_cast<long long>(x) * x; }),
+        tf::stage(tf::StageMode::serial_out_of_order, [&](long long x) { total += x; })), {load});
+    auto report = s.schedule_once(tf::Clock::now(), [&] { return total; }, {stream.handle()});
+    EXPECT_EQ(report.get(), 1000LL * 1001 * 2001 / 6);
+    s.stop();
+}
@@ -0,0 +1,186 @@
+#include <taskflow/scheduler.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+// Start times of a recurring task's runs, and when each was due.
+struct Runs {
+    void mark() {
+        std::lock_guard<std::mutex> lk(mtx);
+        starts.push_back(tf::Clock::now());
+        due.push_back(tf::ScheduledTask::current()->next_run);
+    }
+    std::vector<tf::TimePoint> get() {
+        std::lock_guard<std::mutex> lk(mtx);
+        return starts;
+    }
+    std::vector<tf::TimePoint> slots() {
+        std::lock_guard<std::mutex> lk(mtx);
+        return due;
+    }
+    size_t size() { return get().size(); }
+    void wait(size_t n) {
+        for (int i = 0; i < 5000 && size() < n; ++i) std::this_thread::sleep_for(1ms);
+    }
+
+    std::mutex mtx;
+    std::vector<tf::TimePoint> starts, due;
+};
+
+tf::TaskOptions recurring(tf::Rate rate, tf::Misfire misfire = tf::Misfire::skip, uint32_t catch_up = 1,
+                          uint32_t max_concurrency = 1) {
+    tf::TaskOptions o;
+    o.recurrence = {rate, misfire, catch_up, max_concurrency};
+    return o;
+}
+}  // namespace
+
+TEST(RecurrenceTest, FixedRateStaysOnItsGrid) {
+    Runs rate, delay;
+    tf::Scheduler s(2);
+    s.start();
+    const auto t0 = tf::Clock::now();
+    s.schedule_every(20ms, [&] { rate.mark(); std::this_thread::sleep_for(8ms); },
+                     {}, recurring(tf::Rate::fixed_rate));
+    s.schedule_every(20ms, [&] { delay.mark(); std::this_thread::sleep_for(8ms); });
+    rate.wait(10);
+    delay.wait(8);
+    s.stop();
+    auto r = rate.get(), slots = rate.slots(), d = delay.get();
+    ASSERT_GE(r.size(), 10u);
+    // Fixed rate: every run is due on the 20ms grid whatever the runs took,
+    // and a late start does not shift the ticks after it.
+    for (size_t i = 0; i < slots.size(); ++i) {
+        EXPECT_GE(r[i], slots[i]) << i;
+        EXPECT_EQ((slots[i] - slots[0]) % 20ms, 0ms) << i;
+        if (i) {
+            EXPECT_GT(slots[i], slots[i - 1]) << i;
+        }
+    }
+    // Fixed delay: every period also carries the 8ms run.
+    EXPECT_GE(d[7] - t0, 8 * 20ms + 7 * 8ms);
+}
+
+// The first run overruns at least two ticks of a 20ms grid; the policy
+// decides which of the missed ticks still run. Returns how many runs were
+// due before the overrun ended, and sets `missed` to the ticks it covered.
+// Both come from the slots the scheduler ran at, not from start times, so a
+// slow host cannot shift a run into the wrong bucket.
+static size_t runs_after_overrun(tf::Misfire misfire, uint32_t catch_up, size_t& missed) {
+    Runs runs;
+    std::atomic<tf::TimePoint> overrun_end{tf::TimePoint::max()};
+    std::atomic<bool> first{true};
+    tf::Scheduler s(2);
+    s.start();
+    const auto t0 = tf::Clock::now();
+    s.schedule_every(20ms, [&] {
+        runs.mark();
+        if (first.exchange(false)) {
+            // Ends at 65ms however late it started: ticks 40 and 60 missed.
+            std::this_thread::sleep_until(t0 + 65ms);
+            overrun_end = tf::Clock::now();
+        }
+    }, {}, recurring(tf::Rate::fixed_rate, misfire, catch_up));
+    runs.wait(5);
+    s.stop();
+    auto slots = runs.slots();
+    const auto end = overrun_end.load();
+    missed = static_cast<size_t>((end - slots[0]) / 20ms);
+    return static_cast<size_t>(std::count_if(slots.begin() + 1, slots.end(),
+                                             [&](tf::TimePoint t) { return t <= end; }));
+}
+
+TEST(RecurrenceTest, MisfirePolicies) {
+    size_t missed = 0;
+    EXPECT_EQ(runs_after_overrun(tf::Misfire::skip, 1, missed), 0u);
+    EXPECT_EQ(runs_after_overrun(tf::Misfire::coalesce, 1, missed), 1u);
+    const size_t caught_up = runs_after_overrun(tf::Misfire::catch_up, 5, missed);
+    EXPECT_GE(missed, 2u);
+    EXPECT_EQ(caught_up, missed);   // all of them
+    EXPECT_EQ(runs_after_overrun(tf::Misfire::catch_up, 1, missed), 1u);
+}
+
+TEST(RecurrenceTest, OverlappingRunsAreCapped) {
+    std::atomic<int> in_flight{0}, peak{0}, started{0};
+    tf::Scheduler s(4);   // more workers than the cap
+    s.start();
+    s.schedule_every(10ms, [&] {
+        int now = ++in_flight;
+        int top = peak.load();
+        while (now > top && !peak.compare_exchange_weak(top, now)) {}
+        ++started;
+        std::this_thread::sleep_for(50ms);
+        --in_flight;
+    }, {}, recurring(tf::Rate::fixed_rate, tf::Misfire::skip, 1, 3));
+    for (int i = 0; i < 2000 && started < 8; ++i) std::this_thread::sleep_for(1ms);
+    s.stop();
+    EXPECT_GE(started, 8);
+    EXPECT_EQ(peak, 3);
+}
+
+TEST(RecurrenceTest, OverlapOwedRunsStartAsSlotsFree) {
+    std::atomic<int> started{0};
+    std::atomic<bool> release{false};
+    tf::Scheduler s(4);
+    s.start();
+    // Two slots, held by runs that wait: every tick meanwhile is owed, and
+    // catch_up keeps at most two of them.
+    s.schedule_every(5ms, [&] {
+        ++started;
+        while (!release) std::this_thread::sleep_for(1ms);
+    }, {}, recurring(tf::Rate::fixed_rate, tf::Misfire::catch_up, 2, 2));
+    for (int i = 0; i < 2000 && started < 2; ++i) std::this_thread::sleep_for(1ms);
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(started, 2);   // both slots taken, nothing else started
+    release = true;
+    for (int i = 0; i < 2000 && started < 4; ++i) std::this_thread::sleep_for(1ms);
+    s.stop();
+    EXPECT_GE(started, 4);   // the two owed runs
+}
+
+TEST(RecurrenceTest, CanceledOverlapStartsNoOwedRuns) {
+    std::atomic<int> started{0};
+    std::atomic<bool> release{false};
+    tf::Scheduler s(4);
+    s.start();
+    // As above, but the task is canceled while two runs are still owed.
+    auto h = s.schedule_every(5ms, [&] {
+        ++started;
+        while (!release) std::this_thread::sleep_for(1ms);
+    }, {}, recurring(tf::Rate::fixed_rate, tf::Misfire::catch_up, 5, 2));
+    for (int i = 0; i < 2000 && started < 2; ++i) std::this_thread::sleep_for(1ms);
+    std::this_thread::sleep_for(30ms);   // ticks pile up behind the two runs
+    EXPECT_TRUE(s.cancel(h));
+    release = true;
+    std::this_thread::sleep_for(50ms);
+    s.stop();
+    EXPECT_EQ(started, 2);
+}
+
+TEST(RecurrenceTest, TimersFireOnTime) {
+    // Sub-millisecond timing needs the dispatcher to sleep on a precise
+    // timer, not to poll.
+    std::vector<tf::Duration> late;
+    std::mutex mtx;
+    std::vector<tf::TaskHandle> hs;
+    tf::Scheduler s(2);
+    s.start();
+    for (int i = 1; i <= 20; ++i) {
+        auto due = tf::Clock::now() + i * 3ms;
+        hs.push_back(s.schedule_once(due, [&, due] {
+            std::lock_guard<std::mutex> lk(mtx);
+            late.push_back(tf::Clock::now() - due);
+        }));
+    }
+    for (auto h : hs) s.wait_for(h);
+    s.stop();
+    std::sort(late.begin(), late.end());
+    EXPECT_GE(late.front(), tf::Duration::zero());
+    EXPECT_LT(late[late.size() / 2], 2ms);   // median, leaving room for a loaded machine
+}
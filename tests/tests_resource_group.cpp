@@ -0,0 +1,152 @@
+#include <taskflow/scheduler.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+// Tracks how many callers are inside at once.
+struct InFlight {
+    std::atomic<int> now{0}, peak{0};
+    void enter() {
+        int n = ++now;
+        int p = peak.load();
+        while (n > p && !peak.compare_exchange_weak(p, n)) {}
+    }
+    void leave() { --now; }
+};
+
+tf::TaskOptions in(std::shared_ptr<tf::ResourceGroup> group) {
+    tf::TaskOptions o;
+    o.group = std::move(group);
+    return o;
+}
+}  // namespace
+
+TEST(ResourceGroupTest, ConcurrencyLimitHolds) {
+    tf::Scheduler s(4);
+    s.start();
+    auto disk = std::make_shared<tf::ResourceGroup>(2);
+    InFlight f;
+    std::vector<tf::TaskHandle> hs;
+    for (int i = 0; i < 20; ++i)
+        hs.push_back(s.schedule_once(tf::Clock::now(), [&] {
+            f.enter();
+            std::this_thread::sleep_for(1ms);
+            f.leave();
+        }, {}, in(disk)));
+    for (auto h : hs) s.wait_for(h);
+    EXPECT_EQ(f.peak.load(), 2);
+    while (s.task_count() != 0) std::this_thread::sleep_for(1ms);   // slots are returned after completion
+    EXPECT_EQ(disk->in_flight(), 0u);
+    EXPECT_EQ(disk->waiting(), 0u);
+    s.stop();
+}
+
+TEST(ResourceGroupTest, WaitingTasksLeaveWorkersFree) {
+    tf::Scheduler s(2);
+    s.start();
+    auto db = std::make_shared<tf::ResourceGroup>(1);
+    std::atomic<int> slow_done{0};
+    std::vector<tf::TaskHandle> slow;
+    for (int i = 0; i < 10; ++i)
+        slow.push_back(s.schedule_once(tf::Clock::now(), [&] {
+            std::this_thread::sleep_for(10ms);
+            slow_done++;
+        }, {}, in(db)));
+    std::this_thread::sleep_for(5ms);
+    EXPECT_GE(db->waiting(), 8u);
+
+    // Nine queued database tasks, yet the second worker is free for others.
+    auto t0 = tf::Clock::now();
+    auto quick = s.schedule_once(tf::Clock::now(), [] { return 42; });
+    EXPECT_EQ(quick.get(), 42);
+    EXPECT_LT(tf::Clock::now() - t0, 40ms);   // not behind the ~90ms queue
+    EXPECT_LT(slow_done.load(), 10);
+    for (auto h : slow) s.wait_for(h);
+    EXPECT_EQ(slow_done.load(), 10);
+    s.stop();
+}
+
+TEST(ResourceGroupTest, CanceledTaskLeavesTheQueue) {
+    tf::Scheduler s(2);
+    s.start();
+    auto db = std::make_shared<tf::ResourceGroup>(1);
+    tf::TaskOptions opts;
+    opts.group = db;
+    std::atomic<bool> open{false}, ran{false};
+    auto busy = s.schedule_once(tf::Clock::now(), [&] { while (!open) std::this_thread::sleep_for(1ms); }, {}, opts);
+    while (db->in_flight() == 0) std::this_thread::sleep_for(1ms);
+    auto queued = s.schedule_once(tf::Clock::now(), [&] { ran = true; return 1; }, {}, opts);
+    while (db->waiting() == 0) std::this_thread::sleep_for(1ms);
+
+    // Settled at once, not when the slot comes free, and never takes it.
+    EXPECT_TRUE(s.cancel(queued));
+    EXPECT_THROW(queued.get(), tf::TaskCanceled);
+    EXPECT_EQ(db->waiting(), 0u);
+    open = true;
+    s.wait_for(busy);
+    while (s.task_count() > 1) std::this_thread::sleep_for(1ms);
+    EXPECT_EQ(db->in_flight(), 0u);
+    EXPECT_FALSE(ran.load());
+    s.stop();
+}
+
+TEST(ResourceGroupTest, RateLimitPacesStarts) {
+    tf::Scheduler s(4);
+    s.start();
+    auto api = std::make_shared<tf::ResourceGroup>(0, 200.0, 2);   // 200/s, bursts of 2
+    std::mutex mtx;
+    std::vector<tf::TimePoint> starts;
+    std::vector<tf::TaskHandle> hs;
+    auto t0 = tf::Clock::now();
+    for (int i = 0; i < 12; ++i)
+        hs.push_back(s.schedule_once(tf::Clock::now(), [&] {
+            std::lock_guard<std::mutex> lk(mtx);
+            starts.push_back(tf::Clock::now());
+        }, {}, in(api)));
+    for (auto h : hs) s.wait_for(h);
+    ASSERT_EQ(starts.size(), 12u);
+    std::sort(starts.begin(), starts.end());
+    // Two from the burst, then one every 5ms; no three ever within 5ms.
+    EXPECT_GE(starts.back() - t0, 45ms);
+    for (size_t i = 2; i < starts.size(); ++i) EXPECT_GE(starts[i] - starts[i - 2], 4900us) << i;
+    s.stop();
+}
+
+TEST(ResourceGroupTest, GroupedDependentsAndContinuations) {
+    tf::Scheduler s(4);
+    s.start();
+    auto gpu = std::make_shared<tf::ResourceGroup>(1, 1000.0);
+    InFlight f;
+    auto body = [&] {
+        f.enter();
+        std::this_thread::sleep_for(200us);
+        f.leave();
+    };
+    // Fan-out then fan-in, all in the group: releases run through
+    // completed() rather than the dispatcher.
+    auto root = s.schedule_once(tf::Clock::now(), body, {}, in(gpu));
+    std::vector<tf::TaskHandle> mid;
+    for (int i = 0; i < 8; ++i) mid.push_back(s.schedule_once(tf::Clock::now(), body, {root}, in(gpu)));
+    auto sink = s.schedule_once(tf::Clock::now(), [&] { body(); return f.peak.load(); }, mid, in(gpu));
+    EXPECT_EQ(sink.get(), 1);
+
+    // A coroutine keeps its slot across suspensions.
+    auto co = [&]() -> tf::Co<int> {
+        f.enter();
+        co_await s.sleep(1ms);
+        f.leave();
+        co_return 7;
+    };
+    auto a = s.spawn(co(), {}, in(gpu));
+    auto b = s.spawn(co(), {}, in(gpu));
+    EXPECT_EQ(a.get() + b.get(), 14);
+    EXPECT_EQ(f.peak.load(), 1);
+    s.stop();
+}
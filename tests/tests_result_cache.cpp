@@ -0,0 +1,208 @@
+#include <taskflow/scheduler.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+// Scratch directory, removed on destruction.
+struct TempDir {
+    TempDir() {
+        char path[] = "/tmp/taskflow_cache_XXXXXX";
+        name = ::mkdtemp(path);
+    }
+    ~TempDir() { std::filesystem::remove_all(name); }
+    std::filesystem::path name;
+};
+
+// src0..src{n-1} -> obj_i (one per source) -> link. Counts the nodes that run.
+struct Build {
+    std::vector<std::string> sources;
+    std::atomic<int> runs{0};
+    std::string linked;
+
+    tf::TaskGraph graph() {
+        tf::TaskGraph g;
+        auto link = g.add_cached("link", {}, [this](tf::CacheInputs in) {
+            ++runs;
+            std::string out;
+            for (auto& b : in) out += b.bytes();
+            linked = out;
+            return out;
+        });
+        for (size_t i = 0; i < sources.size(); ++i) {
+            auto obj = g.add_cached("obj" + std::to_string(i), tf::content_hash(sources[i]),
+                                    [this, i](tf::CacheInputs in) {
+                                        ++runs;
+                                        EXPECT_TRUE(in.empty());
+                                        return "[" + sources[i] + "]";
+                                    });
+            g.precede(obj, link);
+        }
+        return g;
+    }
+};
+}  // namespace
+
+class ResultCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override { scheduler.start(); }
+    void TearDown() override { scheduler.stop(); }
+
+    tf::CachedRun run(Build& b, tf::ResultCache& cache) {
+        auto r = scheduler.submit(b.graph(), cache);
+        for (auto h : r.handles) scheduler.wait_for(h);
+        return r;
+    }
+
+    tf::Scheduler scheduler{2};
+};
+
+TEST_F(ResultCacheTest, RerunExecutesOnlyTheChangedCone) {
+    tf::ResultCache cache;
+    Build b;
+    b.sources = {"a", "b", "c"};
+
+    auto first = run(b, cache);
+    EXPECT_EQ(first.executed(), 4u);
+    EXPECT_EQ(b.runs, 4);
+    EXPECT_EQ(b.linked, "[a][b][c]");
+
+    b.runs = 0;
+    b.linked.clear();
+    auto again = run(b, cache);
+    EXPECT_EQ(again.executed(), 0u);
+    EXPECT_EQ(b.runs, 0);
+    EXPECT_EQ(again.keys, first.keys);
+
+    b.sources[1] = "B";
+    auto third = run(b, cache);
+    EXPECT_EQ(third.executed(), 2u);   // obj1 and link
+    EXPECT_EQ(b.runs, 2);
+    EXPECT_EQ(b.linked, "[a][B][c]");   // obj0 and obj2 came from the cache
+    EXPECT_TRUE(third.hits[1]);
+    EXPECT_FALSE(third.hits[2]);
+    EXPECT_NE(third.keys[0], first.keys[0]);
+}
+
+TEST_F(ResultCacheTest, DirectoryOutlivesTheCache) {
+    TempDir dir;
+    Build b;
+    b.sources = {"x", "y"};
+    {
+        tf::ResultCache cache(1 << 20, dir.name);
+        EXPECT_EQ(run(b, cache).executed(), 3u);
+    }
+    tf::ResultCache cache(1 << 20, dir.name);
+    b.runs = 0;
+    b.sources[0] = "X";
+    auto r = run(b, cache);
+    EXPECT_EQ(r.executed(), 2u);
+    EXPECT_EQ(b.linked, "[X][y]");   // obj1 mapped back from disk
+    EXPECT_EQ(cache.stats().disk_hits, 1u);
+
+    auto blob = cache.get(r.keys[0]);
+    ASSERT_TRUE(blob);
+    EXPECT_EQ(blob->bytes(), "[X][y]");
+}
+
+TEST_F(ResultCacheTest, PlainSubmitRunsCachedNodes) {
+    Build b;
+    b.sources = {"p", "q"};
+    auto handles = scheduler.submit(b.graph());
+    for (auto h : handles) scheduler.wait_for(h);
+    EXPECT_EQ(b.runs, 3);
+    EXPECT_EQ(b.linked, "[p][q]");
+}
+
+TEST_F(ResultCacheTest, FailuresAreNotCached) {
+    tf::ResultCache cache;
+    std::atomic<int> downstream{0};
+    auto graph = [&](bool fail) {
+        tf::TaskGraph g;
+        auto up = g.add_cached("up", tf::content_hash("in"), [fail](tf::CacheInputs) -> std::string {
+            if (fail) throw std::runtime_error("boom");
+            return "ok";
+        });
+        auto down = g.add_cached("down", {}, [&](tf::CacheInputs in) {
+            ++downstream;
+            return std::string(in[0].bytes());
+        });
+        g.precede(up, down);
+        return g;
+    };
+    auto r = scheduler.submit(graph(true), cache);
+    for (auto h : r.handles) scheduler.wait_for(h);
+    EXPECT_EQ(downstream, 0);
+    EXPECT_FALSE(cache.contains(r.keys[0]));
+    EXPECT_FALSE(cache.contains(r.keys[1]));
+
+    r = scheduler.submit(graph(false), cache);
+    for (auto h : r.handles) scheduler.wait_for(h);
+    EXPECT_EQ(r.executed(), 2u);
+    EXPECT_EQ(downstream, 1);
+}
+
+TEST_F(ResultCacheTest, UncachedNodesOnlyOrder) {
+    tf::ResultCache cache;
+    std::atomic<int> plain{0};
+    auto graph = [&] {
+        tf::TaskGraph g;
+        auto a = g.add("plain", [&] { ++plain; });
+        auto b = g.add_cached("b", {}, [](tf::CacheInputs in) {
+            EXPECT_TRUE(in.empty());
+            return std::string("b");
+        });
+        g.precede(a, b);
+        return g;
+    };
+    auto r = scheduler.submit(graph(), cache);
+    for (auto h : r.handles) scheduler.wait_for(h);
+    EXPECT_FALSE(r.keys[0]);
+    r = scheduler.submit(graph(), cache);
+    for (auto h : r.handles) scheduler.wait_for(h);
+    EXPECT_EQ(plain, 2);   // plain tasks always run
+    EXPECT_TRUE(r.hits[1]);
+}
+
+TEST(ResultCache, LruEvictsOldest) {
+    tf::ResultCache cache(10);
+    auto k = [](int i) { return tf::content_hash(std::to_string(i)); };
+    cache.put(k(1), "1234");
+    cache.put(k(2), "5678");
+    ASSERT_TRUE(cache.get(k(1)));   // now the most recent
+    cache.put(k(3), "abcd");
+    EXPECT_TRUE(cache.contains(k(1)));
+    EXPECT_FALSE(cache.contains(k(2)));
+    EXPECT_TRUE(cache.contains(k(3)));
+    auto s = cache.stats();
+    EXPECT_EQ(s.evictions, 1u);
+    EXPECT_EQ(s.memory_bytes, 8u);
+    EXPECT_FALSE(cache.get(k(2)));
+    EXPECT_EQ(cache.stats().misses, 1u);
+
+    cache.put(k(4), std::string(64, 'x'));   // kept though over budget on its own
+    EXPECT_EQ(cache.get(k(4))->size(), 64u);
+}
+
+TEST(ResultCache, Hashes) {
+    EXPECT_EQ(tf::content_hash("abc"), tf::content_hash("abc"));
+    EXPECT_NE(tf::content_hash("abc"), tf::content_hash("abd"));
+    EXPECT_NE(tf::content_hash(""), tf::content_hash(std::string_view("\0", 1)));
+    // Fed in pieces or at once, the same bytes hash the same.
+    std::string s(100, 'q');
+    for (size_t i = 0; i < s.size(); ++i) s[i] = static_cast<char>(i * 37);
+    tf::KeyHasher h;
+    h.update(s.substr(0, 3)).update(s.substr(3, 50)).update(s.substr(53));
+    EXPECT_EQ(h.finish(), tf::content_hash(s));
+    EXPECT_EQ(tf::content_hash("abc").hex().size(), 32u);
+
+    TempDir dir;
+    auto path = dir.name / "f";
+    std::ofstream(path) << s;
+    EXPECT_EQ(tf::file_hash(path), tf::content_hash(s));
+    EXPECT_THROW(tf::file_hash(dir.name / "missing"), std::system_error);
+}
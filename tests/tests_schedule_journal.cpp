@@ -0,0 +1,274 @@
+#include <taskflow/scheduler.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+// Scratch directory, removed on destruction.
+struct TempDir {
+    TempDir() {
+        char path[] = "/tmp/taskflow_journal_XXXXXX";
+        name = ::mkdtemp(path);
+    }
+    ~TempDir() { std::filesystem::remove_all(name); }
+    std::filesystem::path name;
+};
+
+auto wall() { return std::chrono::system_clock::now(); }
+
+void wait_until(const std::atomic<int>& n, int at_least) {
+    for (int i = 0; i < 2000 && n.load() < at_least; ++i) std::this_thread::sleep_for(1ms);
+}
+}  // namespace
+
+class ScheduleJournalTest : public ::testing::Test {
+protected:
+    std::filesystem::path file() const { return dir.name / "jobs.journal"; }
+
+    TempDir dir;
+};
+
+TEST_F(ScheduleJournalTest, JobsSurviveARestart) {
+    tf::ScheduleJournal::JobId tick_id;
+    {
+        tf::Scheduler s(1);
+        tf::ScheduleJournal j(s, file());
+        j.bind("tick", [] {});
+        j.bind("report", [] {});
+        tick_id = j.schedule_every("tick", 20ms);
+        j.schedule_recurring("report", "0 0 1 1 *");
+        j.schedule_once("report", wall() + 1h);
+        EXPECT_EQ(j.size(), 3u);
+    }
+    tf::Scheduler s(1);
+    s.start();
+    tf::ScheduleJournal j(s, file());
+    std::atomic<int> ticks{0};
+    j.bind("tick", [&] { ++ticks; });
+    j.bind("report", [] {});
+    auto stats = j.recover();
+    EXPECT_EQ(stats.jobs, 3u);
+    EXPECT_EQ(stats.scheduled, 3u);
+    EXPECT_EQ(stats.unbound, 0u);
+    EXPECT_EQ(stats.torn_bytes, 0u);
+    EXPECT_TRUE(j.handle(tick_id).is_valid());
+    wait_until(ticks, 3);
+    EXPECT_GE(ticks, 3);
+    s.stop();
+}
+
+TEST_F(ScheduleJournalTest, OverdueOneShotRunsOrIsDropped) {
+    {
+        tf::Scheduler s(1);   // never started: the run is missed
+        tf::ScheduleJournal j(s, file());
+        j.bind("once", [] {});
+        j.schedule_once("once", wall() + 10ms);
+        j.schedule_once("once", wall() + 10ms);
+    }
+    std::this_thread::sleep_for(20ms);
+    {
+        tf::Scheduler s(1);
+        tf::ScheduleJournal j(s, file(), {tf::Catchup::skip});
+        j.bind("once", [] { FAIL() << "skipped run ran"; });
+        auto stats = j.recover();
+        EXPECT_EQ(stats.missed, 2u);
+        EXPECT_EQ(stats.scheduled, 0u);
+        EXPECT_EQ(j.size(), 0u);
+        j.schedule_once("once", wall() + 10ms);
+    }
+    std::this_thread::sleep_for(20ms);
+    tf::Scheduler s(1);
+    s.start();
+    std::atomic<int> runs{0};
+    {
+        tf::ScheduleJournal j(s, file());
+        j.bind("once", [&] { ++runs; });
+        EXPECT_EQ(j.recover().missed, 1u);
+        wait_until(runs, 1);
+        EXPECT_EQ(j.size(), 0u);   // done, so journaled as finished
+    }
+    s.stop();
+    EXPECT_EQ(runs, 1);
+    tf::Scheduler s2(1);
+    tf::ScheduleJournal j(s2, file());
+    j.bind("once", [] {});
+    EXPECT_EQ(j.recover().jobs, 0u);
+}
+
+TEST_F(ScheduleJournalTest, CatchupAllIsCapped) {
+    {
+        tf::Scheduler s(1);
+        tf::ScheduleJournal j(s, file());
+        j.bind("tick", [] {});
+        j.schedule_every("tick", 300ms);
+    }
+    std::this_thread::sleep_for(1000ms);   // due at 300, 600 and 900 ms
+    tf::Scheduler s(1);
+    s.start();
+    std::atomic<int> runs{0};
+    tf::ScheduleJournal j(s, file(), {tf::Catchup::all, 2});
+    j.bind("tick", [&] { ++runs; });
+    EXPECT_EQ(j.recover().missed, 1u);
+    std::this_thread::sleep_for(100ms);    // next regular run at 1200 ms
+    EXPECT_EQ(runs, 2);
+    s.stop();
+}
+
+TEST_F(ScheduleJournalTest, CancelAndUnboundJobs) {
+    tf::ScheduleJournal::JobId keep;
+    {
+        tf::Scheduler s(1);
+        tf::ScheduleJournal j(s, file());
+        j.bind("a", [] {});
+        j.bind("b", [] {});
+        auto gone = j.schedule_every("a", 1h);
+        keep = j.schedule_every("b", 1h);
+        EXPECT_TRUE(j.cancel(gone));
+        EXPECT_FALSE(j.cancel(gone));
+        EXPECT_THROW(j.schedule_every("c", 1h), std::invalid_argument);
+        EXPECT_THROW(j.schedule_recurring("a", "not cron"), std::invalid_argument);
+    }
+    {
+        tf::Scheduler s(1);
+        tf::ScheduleJournal j(s, file());
+        auto stats = j.recover();   // nothing bound yet
+        EXPECT_EQ(stats.jobs, 1u);
+        EXPECT_EQ(stats.unbound, 1u);
+        EXPECT_FALSE(j.handle(keep).is_valid());
+        j.compact();                // unbound jobs are kept
+        j.bind("b", [] {});
+        EXPECT_EQ(j.recover().scheduled, 1u);
+        EXPECT_TRUE(j.handle(keep).is_valid());
+    }
+}
+
+TEST_F(ScheduleJournalTest, CancelStopsTheScheduledTask) {
+    tf::Scheduler s(1);
+    s.start();
+    tf::ScheduleJournal j(s, file());
+    std::atomic<int> ticks{0};
+    j.bind("tick", [&] { ++ticks; });
+    auto id = j.schedule_every("tick", 2ms);
+    wait_until(ticks, 1);
+    EXPECT_TRUE(j.cancel(id));
+    for (int i = 0; i < 2000 && s.task_count() != 0; ++i) std::this_thread::sleep_for(1ms);
+    EXPECT_EQ(s.task_count(), 0u);   // gone from the scheduler, not just idle
+    s.stop();
+}
+
+TEST_F(ScheduleJournalTest, RecurrenceSurvivesARestart) {
+    {
+        tf::Scheduler s(1);
+        tf::ScheduleJournal j(s, file());
+        j.bind("poll", [] {});
+        tf::TaskOptions opts;
+        opts.recurrence.rate = tf::Rate::fixed_rate;
+        opts.recurrence.max_concurrency = 2;
+        j.schedule_every("poll", 5ms, opts);
+    }
+    tf::Scheduler s(4);
+    s.start();
+    tf::JournalOptions jo;
+    jo.catchup = tf::Catchup::skip;
+    tf::ScheduleJournal j(s, file(), jo);
+    std::atomic<int> now{0}, peak{0};
+    std::atomic<bool> open{false};
+    j.bind("poll", [&] {
+        int n = ++now;
+        for (int p = peak.load(); n > p && !peak.compare_exchange_weak(p, n);) {}
+        for (int i = 0; i < 2000 && !open; ++i) std::this_thread::sleep_for(1ms);
+        --now;
+    });
+    EXPECT_EQ(j.recover().scheduled, 1u);
+    wait_until(peak, 2);
+    open = true;
+    EXPECT_EQ(peak.load(), 2);   // a second run started beside the stuck one
+    s.stop();
+}
+
+TEST_F(ScheduleJournalTest, TornTailIsDiscarded) {
+    {
+        tf::Scheduler s(1);
+        tf::ScheduleJournal j(s, file());
+        j.bind("a", [] {});
+        j.schedule_every("a", 1h);
+        j.schedule_every("a", 1h);
+    }
+    {
+        // A record cut short: plausible length, body never written.
+        std::ofstream out(file(), std::ios::binary | std::ios::app);
+        const uint32_t size = 96;
+        out.write(reinterpret_cast<const char*>(&size), sizeof size);
+        out.write("\x01\x02\x03\x04", 4);
+    }
+    {
+        tf::Scheduler s(1);
+        tf::ScheduleJournal j(s, file());
+        j.bind("a", [] {});
+        auto stats = j.recover();
+        EXPECT_GT(stats.torn_bytes, 0u);
+        EXPECT_EQ(stats.jobs, 2u);
+        j.schedule_every("a", 1h);
+    }
+    tf::Scheduler s(1);
+    tf::ScheduleJournal j(s, file());
+    j.bind("a", [] {});
+    auto stats = j.recover();
+    EXPECT_EQ(stats.torn_bytes, 0u);
+    EXPECT_EQ(stats.jobs, 3u);
+}
+
+TEST_F(ScheduleJournalTest, CompactionKeepsLiveJobs) {
+    {
+        tf::Scheduler s(1);
+        tf::ScheduleJournal j(s, file());
+        j.bind("a", [] {});
+        std::vector<tf::ScheduleJournal::JobId> ids;
+        for (int i = 0; i < 1000; ++i) ids.push_back(j.schedule_once("a", wall() + 1h));
+        for (int i = 0; i < 900; ++i) j.cancel(ids[i]);
+        const size_t before = j.bytes();
+        j.compact();
+        EXPECT_LT(j.bytes(), before / 5);
+        EXPECT_EQ(j.size(), 100u);
+        j.schedule_once("a", wall() + 1h);   // appends after the compacted records
+    }
+    tf::Scheduler s(1);
+    tf::ScheduleJournal j(s, file());
+    j.bind("a", [] {});
+    EXPECT_EQ(j.recover().jobs, 101u);
+}
+
+TEST_F(ScheduleJournalTest, CompactsOnItsOwn) {
+    tf::Scheduler s(1);
+    s.start();
+    std::atomic<int> runs{0};
+    {
+        tf::ScheduleJournal j(s, file(), {tf::Catchup::once, 64, 4096});
+        j.bind("a", [&] { ++runs; });
+        j.schedule_every("a", 1ms);   // each run appends a record
+        wait_until(runs, 400);
+        EXPECT_LT(j.bytes(), 8192u);
+    }
+    s.stop();
+}
+
+TEST_F(ScheduleJournalTest, RejectsOtherFiles) {
+    const std::string text = "definitely not a schedule journal\n";
+    std::ofstream(file()) << text;
+    tf::Scheduler s(1);
+    EXPECT_THROW(tf::ScheduleJournal(s, file()), std::runtime_error);
+    // The file is left exactly as it was.
+    std::ifstream in(file());
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(in), {}), text);
+
+    std::ofstream(file()) << "TFJ";   // shorter than a header
+    EXPECT_THROW(tf::ScheduleJournal(s, file()), std::runtime_error);
+    EXPECT_EQ(std::filesystem::file_size(file()), 3u);
+}
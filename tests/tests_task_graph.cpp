@@ -0,0 +1,189 @@
+#include <taskflow/scheduler.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+class TaskGraphTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        scheduler = std::make_unique<tf::Scheduler>();
+        scheduler->start();
+    }
+    void TearDown() override { scheduler->stop(); }
+
+    std::unique_ptr<tf::Scheduler> scheduler;
+};
+
+TEST_F(TaskGraphTest, DiamondByName) {
+    std::vector<std::string> order;
+    std::mutex mtx;
+    auto log = [&](std::string s) { return [&, s]{ std::lock_guard<std::mutex> lk(mtx); order.push_back(s); }; };
+
+    tf::TaskGraph g;
+    g.add("extract", log("extract"));
+    g.add("clean", log("clean"));
+    g.add("stats", log("stats"));
+    auto load = g.add("load", log("load"));
+    g.precede("extract", "clean");
+    g.precede("extract", "stats");
+    g.precede("clean", "load");
+    g.precede("stats", "load");
+    EXPECT_FALSE(g.has_cycle());
+
+    auto handles = scheduler->submit(std::move(g));
+    ASSERT_EQ(handles.size(), 4u);
+    scheduler->wait_for(handles[load]);
+
+    ASSERT_EQ(order.size(), 4u);
+    EXPECT_EQ(order.front(), "extract");
+    EXPECT_EQ(order.back(), "load");
+}
+
+TEST_F(TaskGraphTest, CycleIsRejectedBeforeInsertion) {
+    tf::TaskGraph g;
+    g.add("a", []{});
+    g.add("b", []{});
+    g.add("c", []{});
+    g.add("tail", []{});
+    g.precede("a", "b");
+    g.precede("b", "c");
+    g.precede("c", "a");
+    g.precede("c", "tail");
+    EXPECT_TRUE(g.has_cycle());
+
+    try {
+        scheduler->submit(std::move(g));
+        FAIL() << "expected a cycle error";
+    } catch (const std::invalid_argument& e) {
+        std::string msg = e.what();
+        EXPECT_EQ(msg.find("tail"), std::string::npos); // names a node on the cycle
+    }
+    EXPECT_EQ(scheduler->task_count(), 0u);
+}
+
+TEST_F(TaskGraphTest, UnknownNamesAndDuplicates) {
+    tf::TaskGraph g;
+    g.add("a", []{});
+    EXPECT_THROW(g.add("a", []{}), std::invalid_argument);
+    EXPECT_THROW(g.precede("a", "missing"), std::out_of_range);
+}
+
+TEST_F(TaskGraphTest, ExternalDependencyAndDelayedStart) {
+    std::atomic<int> step{0};
+    auto ext = scheduler->schedule_once(tf::Clock::now() + 20ms, [&]{ step = 1; });
+
+    tf::TaskGraph g;
+    auto a = g.add([&]{ EXPECT_EQ(step.load(), 1); step = 2; });
+    auto b = g.add([&]{ EXPECT_EQ(step.load(), 2); step = 3; });
+    g.precede(a, b);
+    g.depend_on(a, ext);
+
+    auto start = tf::Clock::now() + 10ms;
+    auto handles = scheduler->submit(std::move(g), start);
+    scheduler->wait_for(handles[b]);
+    EXPECT_EQ(step.load(), 3);
+}
+
+TEST_F(TaskGraphTest, LargeLayeredGraph) {
+    constexpr size_t kLayers = 100, kWidth = 100;
+    std::atomic<size_t> ran{0};
+
+    tf::TaskGraph g;
+    std::vector<tf::TaskGraph::NodeId> prev, cur;
+    for (size_t l = 0; l < kLayers; ++l) {
+        cur.clear();
+        for (size_t w = 0; w < kWidth; ++w) {
+            auto id = g.add([&]{ ran++; });
+            if (!prev.empty()) {
+                g.precede(prev[w], id);
+                g.precede(prev[(w + 1) % kWidth], id);
+            }
+            cur.push_back(id);
+        }
+        prev.swap(cur);
+    }
+    auto sink = g.add([]{});
+    for (auto id : prev) g.precede(id, sink);
+
+    auto handles = scheduler->submit(std::move(g));
+    scheduler->wait_for(handles[sink]);
+    EXPECT_EQ(ran.load(), kLayers * kWidth);
+}
+
+TEST_F(TaskGraphTest, CompiledGraphRunsRepeatedly) {
+    std::atomic<int> a{0}, b{0}, c{0};
+    std::atomic<bool> ordered{true};
+
+    tf::TaskGraph g;
+    g.add("a", [&]{ a++; });
+    g.add("b", [&]{ if (b.load() >= a.load()) ordered = false; b++; });
+    g.add("c", [&]{ if (c.load() >= b.load()) ordered = false; c++; });
+    g.precede("a", "b");
+    g.precede("b", "c");
+
+    tf::CompiledGraph cg(std::move(g));
+    EXPECT_EQ(cg.size(), 3u);
+    EXPECT_EQ(cg.edge_count(), 2u);
+
+    scheduler->run_n(cg, 100);
+    EXPECT_EQ(a.load(), 100);
+    EXPECT_EQ(b.load(), 100);
+    EXPECT_EQ(c.load(), 100);
+    EXPECT_TRUE(ordered.load());
+}
+
+TEST_F(TaskGraphTest, CompiledGraphPropagatesExceptions) {
+    std::atomic<int> after{0};
+    tf::TaskGraph g;
+    auto bad = g.add([]{ throw std::runtime_error("boom"); });
+    auto next = g.add([&]{ after++; });
+    g.precede(bad, next);
+
+    tf::CompiledGraph cg(std::move(g));
+    EXPECT_THROW(scheduler->run(cg), std::runtime_error);
+    EXPECT_THROW(scheduler->run(cg), std::runtime_error); // reusable after a failure
+    EXPECT_EQ(after.load(), 2);
+}
+
+TEST_F(TaskGraphTest, CompiledGraphRejectsCyclesAndExternalDeps) {
+    tf::TaskGraph cyclic;
+    auto x = cyclic.add([]{});
+    auto y = cyclic.add([]{});
+    cyclic.precede(x, y);
+    cyclic.precede(y, x);
+    EXPECT_THROW(tf::CompiledGraph{std::move(cyclic)}, std::invalid_argument);
+
+    auto ext = scheduler->schedule_once(tf::TimePoint::max(), []{});
+    tf::TaskGraph external;
+    external.depend_on(external.add([]{}), ext);
+    EXPECT_THROW(tf::CompiledGraph{std::move(external)}, std::invalid_argument);
+}
+
+TEST_F(TaskGraphTest, CompiledGraphOnAShutDownPool) {
+    std::atomic<int> leaves{0};
+    tf::TaskGraph g;
+    auto root = g.add([]{});
+    for (int i = 0; i < 8; ++i) g.precede(root, g.add([&]{ leaves++; }));
+    tf::CompiledGraph cg(std::move(g));
+
+    tf::ThreadPool pool(2);
+    pool.shutdown();
+    cg.run(pool);   // refused work runs here rather than hanging
+    EXPECT_EQ(leaves.load(), 8);
+}
+
+TEST_F(TaskGraphTest, CompiledGraphFromInsideATask) {
+    std::atomic<int> leaves{0};
+    tf::TaskGraph g;
+    auto root = g.add([]{});
+    for (int i = 0; i < 32; ++i) g.precede(root, g.add([&]{ leaves++; }));
+    tf::CompiledGraph cg(std::move(g));
+
+    // A periodic job re-running the graph from a pool worker must not deadlock.
+    auto h = scheduler->schedule_once(tf::Clock::now(), [&]{ scheduler->run_n(cg, 10); });
+    scheduler->wait_for(h);
+    EXPECT_EQ(leaves.load(), 320);
+}
@@ -0,0 +1,169 @@
+#include <taskflow/thread_pool.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+// Occupies the pool's only worker until open() so a test can queue work in a
+// known state.
+struct Gate {
+    std::atomic<bool> started{false}, open{false};
+    void block(tf::ThreadPool& pool) {
+        pool.enqueue([this] {
+            started = true;
+            while (!open) std::this_thread::yield();
+        });
+        while (!started) std::this_thread::yield();
+    }
+};
+}  // namespace
+
+TEST(ThreadPoolTest, ExternalFanOut) {
+    std::atomic<int> counter{0};
+    {
+        tf::ThreadPool pool(4);
+        for (int i = 0; i < 10000; ++i) pool.enqueue([&]{ counter++; });
+    } // destructor drains everything that was queued
+    EXPECT_EQ(counter.load(), 10000);
+}
+
+TEST(ThreadPoolTest, NestedSubmissionUsesLocalDeque) {
+    std::atomic<int> counter{0};
+    std::atomic<int> outside{0};
+    {
+        tf::ThreadPool pool(4);
+        EXPECT_EQ(pool.current_worker(), -1);
+        for (int i = 0; i < 64; ++i) {
+            pool.enqueue([&]{
+                if (pool.current_worker() < 0) outside++;
+                for (int j = 0; j < 100; ++j) pool.enqueue([&]{ counter++; });
+            });
+        }
+    }
+    EXPECT_EQ(outside.load(), 0);
+    EXPECT_EQ(counter.load(), 6400);
+}
+
+TEST(ThreadPoolTest, ManyProducers) {
+    std::atomic<int> counter{0};
+    {
+        tf::ThreadPool pool(4);
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 4; ++p)
+            producers.emplace_back([&]{
+                for (int i = 0; i < 2500; ++i) pool.enqueue([&]{ counter++; });
+            });
+        for (auto& t : producers) t.join();
+    }
+    EXPECT_EQ(counter.load(), 10000);
+}
+
+TEST(ThreadPoolTest, PriorityClassesThenDeadlines) {
+    tf::ThreadPool pool(1);
+    Gate gate;
+    gate.block(pool);
+    std::mutex mtx;
+    std::vector<std::string> order;
+    auto rec = [&](std::string s) {
+        return [&, s] { std::lock_guard<std::mutex> lk(mtx); order.push_back(s); };
+    };
+    auto now = std::chrono::steady_clock::now();
+    pool.enqueue(rec("low"), tf::Priority::low);
+    pool.enqueue(rec("n1"));
+    pool.enqueue(rec("n2"));
+    pool.enqueue(rec("h-late"), tf::Priority::high, now + 2s);
+    pool.enqueue(rec("n-deadline"), tf::Priority::normal, now + 1s);
+    pool.enqueue(rec("h-early"), tf::Priority::high, now + 1s);
+    gate.open = true;
+    pool.shutdown();
+    EXPECT_EQ(order, (std::vector<std::string>{"h-early", "h-late", "n-deadline", "n1", "n2", "low"}));
+}
+
+TEST(ThreadPoolTest, AgingPromotesWaitingWork) {
+    tf::ThreadPool pool(1);
+    pool.set_aging(2ms);
+    Gate gate;
+    gate.block(pool);
+    std::mutex mtx;
+    std::vector<std::string> order;
+    auto rec = [&](std::string s) {
+        return [&, s] { std::lock_guard<std::mutex> lk(mtx); order.push_back(s); };
+    };
+    pool.enqueue(rec("low"), tf::Priority::low);
+    std::this_thread::sleep_for(10ms);   // two steps: low now ranks as high
+    pool.enqueue(rec("normal"));
+    pool.enqueue(rec("high"), tf::Priority::high);
+    gate.open = true;
+    pool.shutdown();
+    EXPECT_EQ(order, (std::vector<std::string>{"high", "low", "normal"}));
+}
+
+TEST(ThreadPoolTest, ParkWithoutSpinning) {
+    std::atomic<int> counter{0};
+    {
+        tf::PoolOptions opts;
+        opts.threads = 4;
+        opts.spin_rounds = 0;
+        opts.yield_rounds = 0;
+        tf::ThreadPool pool(opts);
+        for (int round = 0; round < 50; ++round) {
+            for (int i = 0; i < 100; ++i) pool.enqueue([&]{ counter++; });
+            std::this_thread::sleep_for(100us);   // let the workers park between bursts
+        }
+    }
+    EXPECT_EQ(counter.load(), 5000);
+}
+
+TEST(ThreadPoolTest, ElasticPoolGrowsWhileBlockedThenShrinks) {
+    tf::PoolOptions opts;
+    opts.threads = 1;
+    opts.max_threads = 2;
+    opts.idle_timeout = 20ms;
+    tf::ThreadPool pool(opts);
+    EXPECT_EQ(pool.size(), 2u);
+    EXPECT_EQ(pool.threads(), 1u);
+    std::atomic<bool> released{false}, done{false};
+    pool.enqueue([&] {
+        tf::ThreadPool::Blocking blocking;
+        auto until = std::chrono::steady_clock::now() + 5s;
+        while (!released && std::chrono::steady_clock::now() < until) std::this_thread::sleep_for(1ms);
+        done = true;
+    });
+    pool.enqueue([&] { released = true; });   // only a spare can run this
+    auto until = std::chrono::steady_clock::now() + 5s;
+    while (!done && std::chrono::steady_clock::now() < until) std::this_thread::sleep_for(1ms);
+    EXPECT_TRUE(released.load());
+    until = std::chrono::steady_clock::now() + 5s;
+    while (pool.threads() > 1 && std::chrono::steady_clock::now() < until) std::this_thread::sleep_for(5ms);
+    EXPECT_EQ(pool.threads(), 1u);
+}
+
+TEST(WorkStealingDequeTest, OwnerAndThieves) {
+    tf::WorkStealingDeque<int*> dq(4); // small to exercise growth
+    std::vector<int> items(100000);
+    std::atomic<int> taken{0};
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; ++t)
+        thieves.emplace_back([&]{
+            while (!done || !dq.empty())
+                if (auto v = dq.steal()) { ++**v; taken++; }
+        });
+    for (auto& i : items) {
+        dq.push(&i);
+        if ((&i - items.data()) % 3 == 0)
+            if (auto v = dq.pop()) { ++**v; taken++; }
+    }
+    while (auto v = dq.pop()) { ++**v; taken++; }
+    done = true;
+    for (auto& t : thieves) t.join();
+
+    EXPECT_EQ(taken.load(), 100000);
+    for (int i : items) EXPECT_EQ(i, 1);
+}
@@ -0,0 +1,201 @@
+#include <taskflow/scheduler.hpp>
+#include <taskflow/thread_pool.hpp>
+#include <taskflow/topology.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sched.h>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+// Scratch directory, removed on destruction.
+struct TempDir {
+    TempDir() {
+        char path[] = "/tmp/taskflow_topology_XXXXXX";
+        name = ::mkdtemp(path);
+    }
+    ~TempDir() { std::filesystem::remove_all(name); }
+    std::filesystem::path name;
+};
+
+// Two nodes sharing one CPU this process may use: pinning succeeds on any
+// machine, and the pool still schedules by node.
+tf::Topology two_nodes() {
+    const int cpu = tf::Topology::detect().nodes[0].cpus[0];
+    return {{{0, {cpu}}, {1, {cpu}}}};
+}
+
+tf::PoolOptions pinned(size_t threads, tf::Pinning pinning, tf::Topology topology) {
+    tf::PoolOptions o;
+    o.threads = threads;
+    o.pinning = pinning;
+    o.topology = std::move(topology);
+    return o;
+}
+
+tf::TaskOptions on_node(int node) {
+    tf::TaskOptions o;
+    o.node = node;
+    return o;
+}
+
+std::vector<int> my_cpus() {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::vector<int> out;
+    if (::sched_getaffinity(0, sizeof set, &set) != 0) return out;
+    for (int c = 0; c < CPU_SETSIZE; ++c)
+        if (CPU_ISSET(c, &set)) out.push_back(c);
+    return out;
+}
+}  // namespace
+
+TEST(TopologyTest, ParsesCpuLists) {
+    EXPECT_EQ(tf::Topology::parse_cpulist("0-3,8,10-11"), (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(tf::Topology::parse_cpulist("5,1-2,2"), (std::vector<int>{1, 2, 5}));
+    EXPECT_EQ(tf::Topology::parse_cpulist("x,4-2,7"), (std::vector<int>{7}));
+    EXPECT_TRUE(tf::Topology::parse_cpulist("").empty());
+}
+
+TEST(TopologyTest, ReadsSysfsNodes) {
+    TempDir dir;
+    auto node = [&](const char* name, const char* cpus) {
+        std::filesystem::create_directory(dir.name / name);
+        std::ofstream(dir.name / name / "cpulist") << cpus << "\n";
+    };
+    node("node1", "8-15");
+    node("node0", "0-7");
+    node("node2", "");            // memory-only node
+    node("nodeX", "16");          // not a node
+    std::ofstream(dir.name / "possible") << "0-2\n";
+    auto t = tf::Topology::read(dir.name);
+    ASSERT_EQ(t.nodes.size(), 2u);
+    EXPECT_EQ(t.nodes[0].id, 0);
+    EXPECT_EQ(t.nodes[1].id, 1);
+    EXPECT_EQ(t.cpus(), 16u);
+    EXPECT_EQ(t.node_of(9), 1);
+    EXPECT_EQ(t.node_of(16), -1);
+    EXPECT_TRUE(tf::Topology::read(dir.name / "missing").nodes.empty());
+}
+
+TEST(TopologyTest, DetectsAllowedCpus) {
+    auto t = tf::Topology::detect();
+    ASSERT_FALSE(t.nodes.empty());
+    EXPECT_EQ(t.cpus(), my_cpus().size());
+    for (int cpu : my_cpus()) EXPECT_GE(t.node_of(cpu), 0);
+}
+
+TEST(TopologyTest, UnpinnedPoolIsOneNode) {
+    tf::ThreadPool pool(3);
+    EXPECT_EQ(pool.nodes(), 1u);
+    EXPECT_TRUE(pool.topology().nodes.empty());
+    EXPECT_EQ(pool.node_of(2), 0);
+    EXPECT_EQ(pool.current_node(), -1);
+}
+
+TEST(TopologyTest, WorkersArePinned) {
+    const auto t = tf::Topology::detect();
+    const int cpu = t.nodes.back().cpus.back();
+    tf::ThreadPool pool(pinned(1, tf::Pinning::core, {{{0, {cpu}}}}));
+    std::atomic<bool> done{false};
+    std::vector<int> seen;
+    pool.enqueue([&] {
+        seen = my_cpus();
+        done = true;
+    });
+    while (!done) std::this_thread::sleep_for(1ms);
+    EXPECT_EQ(seen, std::vector<int>{cpu});
+}
+
+TEST(TopologyTest, NodesTakeTurns) {
+    tf::ThreadPool pool(pinned(5, tf::Pinning::node, two_nodes()));
+    ASSERT_EQ(pool.nodes(), 2u);
+    for (size_t i = 0; i < 5; ++i) EXPECT_EQ(pool.node_of(i), static_cast<int>(i % 2));
+}
+
+TEST(TopologyTest, NodeHintedWorkRunsOnItsNode) {
+    tf::ThreadPool pool(pinned(4, tf::Pinning::core, two_nodes()));
+    struct Probe : tf::ThreadPool::Work {
+        tf::ThreadPool* pool;
+        std::atomic<int>* wrong;
+        std::atomic<int>* done;
+    };
+    std::atomic<int> wrong{0}, done{0};
+    std::vector<Probe> probes(2000);
+    for (size_t i = 0; i < probes.size(); ++i) {
+        auto& p = probes[i];
+        p.node = static_cast<int16_t>(i % 2);
+        p.pool = &pool;
+        p.wrong = &wrong;
+        p.done = &done;
+        p.execute = [](tf::ThreadPool::Work* w) {
+            auto* p = static_cast<Probe*>(w);
+            if (p->pool->current_node() != p->node) ++*p->wrong;
+            ++*p->done;
+        };
+        pool.submit(&p);
+    }
+    while (done < static_cast<int>(probes.size())) std::this_thread::sleep_for(1ms);
+    // Idle workers may take another node's work, but only after looking at
+    // their own for a while.
+    EXPECT_LT(wrong, static_cast<int>(probes.size() / 10));
+}
+
+TEST(TopologyTest, DependentsFollowTheirProducer) {
+    tf::Scheduler s(pinned(4, tf::Pinning::core, two_nodes()));
+    s.start();
+    std::atomic<int> producer_node{-1}, consumer_node{-1}, hinted_node{-1};
+    std::atomic<bool> go{false};
+    auto here = [] { return tf::ThreadPool::current()->current_node(); };
+    // The producer waits for its dependents: one submitted after it is
+    // already gone has nothing to follow.
+    auto a = s.schedule_once(tf::Clock::now(), [&] {
+        while (!go) std::this_thread::sleep_for(1ms);
+        producer_node = here();
+    }, {}, on_node(1));
+    auto b = s.schedule_once(tf::Clock::now(), [&] { consumer_node = here(); }, {a});
+    auto c = s.schedule_once(tf::Clock::now(), [&] { hinted_node = here(); }, {a}, on_node(0));
+    go = true;
+    s.wait_for(b);
+    s.wait_for(c);
+    s.stop();
+    EXPECT_EQ(producer_node, 1);
+    EXPECT_EQ(consumer_node, 1);
+    EXPECT_EQ(hinted_node, 0);
+}
+
+TEST(TopologyTest, AllWorkRunsWhenANodeIsBusy) {
+    // Node 1's only worker is stuck; work queued for node 1 still runs.
+    tf::ThreadPool pool(pinned(2, tf::Pinning::core, two_nodes()));
+    std::atomic<bool> stuck{false}, release{false};
+    struct Hinted : tf::ThreadPool::Work {
+        std::function<void()> fn;
+    };
+    auto hinted = [](int node, std::function<void()> fn) {
+        auto* w = new Hinted;
+        w->node = static_cast<int16_t>(node);
+        w->fn = std::move(fn);
+        w->execute = [](tf::ThreadPool::Work* w) {
+            std::unique_ptr<Hinted> self(static_cast<Hinted*>(w));
+            self->fn();
+        };
+        return w;
+    };
+    pool.submit(hinted(1, [&] {
+        stuck = true;
+        while (!release) std::this_thread::sleep_for(1ms);
+    }));
+    while (!stuck) std::this_thread::sleep_for(1ms);
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 100; ++i) pool.submit(hinted(1, [&] { ++ran; }));
+    for (int i = 0; i < 2000 && ran < 100; ++i) std::this_thread::sleep_for(1ms);
+    EXPECT_EQ(ran, 100);
+    release = true;
+}
@@ -0,0 +1,54 @@
+#include <taskflow/scheduler.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <memory>
+
+using namespace std::chrono_literals;
+
+TEST(UniqueFunctionTest, SmallCapturesStayInline) {
+    int x = 0;
+    auto small = [&x, a = 1, b = 2]{ x += a + b; };
+    auto large = [&x, big = std::array<char, 256>{}]{ x += big[0] + 1; };
+    EXPECT_TRUE(tf::UniqueTask::stores_inline<decltype(small)>());
+    EXPECT_FALSE(tf::UniqueTask::stores_inline<decltype(large)>());
+
+    tf::UniqueTask f = small;
+    tf::UniqueTask g = large;
+    f(); g();
+    EXPECT_EQ(x, 4);
+}
+
+TEST(UniqueFunctionTest, MoveOnlyCaptureAndMoveSemantics) {
+    auto p = std::make_unique<int>(41);
+    tf::UniqueFunction<int()> f = [p = std::move(p)]{ return ++*p; };
+    EXPECT_TRUE(static_cast<bool>(f));
+
+    tf::UniqueFunction<int()> g = std::move(f);
+    EXPECT_FALSE(static_cast<bool>(f));
+    EXPECT_EQ(g(), 42);
+
+    f = std::move(g);
+    EXPECT_EQ(f(), 43);
+    EXPECT_THROW(g(), std::bad_function_call);
+}
+
+TEST(UniqueFunctionTest, DestroysCaptures) {
+    auto token = std::make_shared<int>(0);
+    {
+        tf::UniqueTask inline_fn = [token]{};
+        tf::UniqueTask heap_fn = [token, pad = std::array<char, 256>{}]{ (void)pad; };
+        EXPECT_EQ(token.use_count(), 3);
+    }
+    EXPECT_EQ(token.use_count(), 1);
+}
+
+TEST(UniqueFunctionTest, SchedulerAcceptsMoveOnlyTasks) {
+    tf::Scheduler s(2);
+    s.start();
+    std::atomic<int> seen{0};
+    auto p = std::make_unique<int>(7);
+    auto h = s.schedule_once(tf::Clock::now(), [&seen, p = std::move(p)]{ seen = *p; });
+    s.wait_for(h);
+    EXPECT_EQ(seen.load(), 7);
+    s.stop();
+}